@@ -0,0 +1,44 @@
+/**
+ * @file BenchmarkPPMWriter.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+
+extern "C"
+{
+#include "utility/PPMWriter.h"
+#include "utility/Randomizer.h"
+}
+
+/* Writes a random 3840 x 2160 (4K) image. */
+static void BenchmarkWriteBinaryPPMImage(benchmark::State &state)
+{
+    const std::string path = "/tmp/cphoton_benchmark.ppm";
+
+    PPMImage *image = makePPMImage(3840, 2160);
+
+    for (int i = 0; i < NUM_PIXELS(image); ++i)
+    {
+        image->pixels[i] = color3(randomDouble(), randomDouble(), randomDouble());
+    }
+
+    for (auto _ : state)
+    {
+        if (state.range(0) == 8)
+            benchmark::DoNotOptimize(writeBinaryPPMImage(image, path.c_str()));
+        else
+            benchmark::DoNotOptimize(writeBinary16BitPPMImage(image, path.c_str()));
+    }
+
+    freePPMImage(image);
+    remove(path.c_str());
+}
+
+BENCHMARK(BenchmarkWriteBinaryPPMImage)->Arg(8)->Arg(16)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,229 @@
+/**
+ * @file BenchmarkPrimitives.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/AABB.hpp"
+#include "engine/SceneArena.hpp"
+#include "engine/primitives/CSGNode.hpp"
+#include "engine/primitives/Cone.hpp"
+#include "engine/primitives/Cube.hpp"
+#include "engine/primitives/Cylinder.hpp"
+#include "engine/primitives/Disc.hpp"
+#include "engine/primitives/Plane.hpp"
+#include "engine/primitives/Sphere.hpp"
+#include "engine/primitives/Triangle.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "utility/Randomizer.h"
+}
+
+/**
+ * Fires fixed (seeded) sets of rays at a single primitive of unit size at the origin to time its intersection kernel
+ * in isolation. Each primitive is run with three ray sets:
+ *
+ *   HitHeavy:  rays from a sphere of radius 4 aimed within radius 0.5 of the origin.
+ *   MissHeavy: rays from a sphere of radius 4 which pass at least 1.4 from the origin (only the plane is hit).
+ *   Grazing:   rays which pass within 0.02 of a point on the surface at a shallow angle, many of them just missing.
+ *
+ * Solids are also run through the span (CSG) query. The counters are the time per ray and the hit rate.
+ */
+
+enum RaySet
+{
+    HitHeavy,
+    MissHeavy,
+    Grazing
+};
+
+static const char *kRaySetNames[] = {"HitHeavy", "MissHeavy", "Grazing"};
+
+static const int kNumRays = 1024;
+static const unsigned int kSeed = 2026;
+
+typedef bool (*PrimitiveQuery)(Primitive &primitive, Ray &ray);
+
+static std::vector<Ray> makeRays(RaySet raySet, Primitive &surface);
+static bool closestHit(Primitive &primitive, Ray &ray);
+static bool spanHit(Primitive &primitive, Ray &ray);
+static void setCounters(benchmark::State &state, int64_t numHits);
+static int registerBenchmarks();
+
+
+static SceneArena theArena;
+
+static Sphere theSphere(point3(0, 0, 0), 1.0, 0);
+static Cube theCube(point3(0, 0, 0), theArena.makeRotation(vector3(0.3, 0.5, 0.1)), 1.2, 0);
+static Triangle theTriangle(point3(-1, -0.8, 0), point3(1, -0.8, 0.2), point3(0, 1, -0.2), 0);
+static Disc theDisc(point3(0, 0, 0), unitVector(vector3(0.3, 1, 0.2)), 1.0, 0);
+static Plane thePlane(point3(0, 0, 0), vector3(0, 1, 0), 0);
+static Cylinder theCylinder(point3(0, 0, 0), theArena.makeRotation(vector3(0.4, 0, 0.3)), 0.8, 1.6, 0);
+static Cone theCone(point3(0, -0.6, 0), theArena.makeRotation(vector3(0.4, 0, 0.3)), 1.2, 0);
+
+// Cube with rounded corners.
+static Cube theCSGCube(point3(0, 0, 0), nullptr, 1.4, 0);
+static Sphere theCSGSphere(point3(0, 0, 0), 0.9, 0);
+static CSGNode theCSG(&theCSGCube, &theCSGSphere, CSGNode::CSGIntersection);
+
+// The box is the same as an axis-aligned cube which is used to make the grazing rays.
+static Cube theBoxCube(point3(0, 0, 0), nullptr, 1.4, 0);
+static AABB theBox(point3(-0.7, -0.7, -0.7), point3(0.7, 0.7, 0.7));
+
+static int theRegistered = registerBenchmarks();
+
+
+static void BenchmarkPrimitive(benchmark::State &state, Primitive &primitive, PrimitiveQuery query, RaySet raySet)
+{
+    std::vector<Ray> rays = makeRays(raySet, primitive);
+    int64_t numHits = 0;
+
+    for (auto _ : state)
+    {
+        for (auto &ray : rays)
+        {
+            numHits += query(primitive, ray);
+        }
+    }
+
+    setCounters(state, numHits);
+}
+
+
+static void BenchmarkAABB(benchmark::State &state, RaySet raySet)
+{
+    std::vector<Ray> rays = makeRays(raySet, theBoxCube);
+    int64_t numHits = 0;
+
+    for (auto _ : state)
+    {
+        for (auto &ray : rays)
+        {
+            numHits += theBox.hit(ray, 0.0, INFINITY);
+        }
+    }
+
+    setCounters(state, numHits);
+}
+
+
+static int registerBenchmarks()
+{
+    struct PrimitiveCase
+    {
+        const char *name;
+        Primitive *primitive;
+        bool isSolid; /* Has a span query */
+    };
+
+    const PrimitiveCase cases[] = {{"Sphere", &theSphere, true},      {"Cube", &theCube, true},
+                                   {"Triangle", &theTriangle, false}, {"Disc", &theDisc, false},
+                                   {"Plane", &thePlane, false},       {"Cylinder", &theCylinder, true},
+                                   {"Cone", &theCone, true},          {"CSGNode", &theCSG, true}};
+
+    for (const PrimitiveCase &primitiveCase : cases)
+    {
+        for (RaySet raySet : {HitHeavy, MissHeavy, Grazing})
+        {
+            const std::string name = std::string(primitiveCase.name) + "/" + kRaySetNames[raySet];
+
+            benchmark::RegisterBenchmark(("BenchmarkPrimitive/" + name + "/ClosestHit").c_str(), BenchmarkPrimitive,
+                                         std::ref(*primitiveCase.primitive), closestHit, raySet);
+
+            if (primitiveCase.isSolid)
+            {
+                benchmark::RegisterBenchmark(("BenchmarkPrimitive/" + name + "/Span").c_str(), BenchmarkPrimitive,
+                                             std::ref(*primitiveCase.primitive), spanHit, raySet);
+            }
+        }
+    }
+
+    for (RaySet raySet : {HitHeavy, MissHeavy, Grazing})
+    {
+        benchmark::RegisterBenchmark((std::string("BenchmarkPrimitive/AABB/") + kRaySetNames[raySet]).c_str(),
+                                     BenchmarkAABB, raySet);
+    }
+
+    return 0;
+}
+
+
+static std::vector<Ray> makeRays(RaySet raySet, Primitive &surface)
+{
+    srand(kSeed);
+
+    std::vector<Ray> rays;
+
+    while (rays.size() < kNumRays)
+    {
+        const Point3 origin = scaleVector(randomUnitVector(), 4.0);
+
+        if (raySet == HitHeavy)
+        {
+            const Point3 target = scaleVector(randomUnitVector(), randomDoubleRange(0.0, 0.5));
+
+            rays.push_back(Ray(origin, unitVector(subtractVectors(target, origin))));
+        }
+        else if (raySet == MissHeavy)
+        {
+            // Aim at a point on the plane through the origin perpendicular to the origin's direction.
+            const Vector3 offset = unitVector(cross(origin, randomUnitVector()));
+            const Point3 target = scaleVector(offset, randomDoubleRange(1.5, 3.0));
+
+            rays.push_back(Ray(origin, unitVector(subtractVectors(target, origin))));
+        }
+        else
+        {
+            // Find a point on the surface and pass just above or below it at a shallow angle to its tangent plane.
+            const Point3 target = scaleVector(randomUnitVector(), randomDoubleRange(0.0, 1.0));
+            Ray ray(origin, unitVector(subtractVectors(target, origin)));
+
+            Hit hit;
+            if (!surface.hit(ray, 0.0, INFINITY, hit)) continue;
+
+            const Vector3 tangent = unitVector(cross(hit.normal, randomUnitVector()));
+            const Vector3 direction = unitVector(subtractVectors(tangent, scaleVector(hit.normal, 0.02)));
+            const Point3 passPoint = addVectors(hit.hitPt, scaleVector(hit.normal, randomDoubleRange(-0.02, 0.02)));
+
+            rays.push_back(Ray(subtractVectors(passPoint, scaleVector(direction, 4.0)), direction));
+        }
+    }
+
+    return rays;
+}
+
+
+static bool closestHit(Primitive &primitive, Ray &ray)
+{
+    Hit hit;
+    return primitive.hit(ray, 0.0, INFINITY, hit);
+}
+
+
+static bool spanHit(Primitive &primitive, Ray &ray)
+{
+    // NB: reused so that the allocation of the list is not measured.
+    static Span::SpanList spans;
+    spans.clear();
+
+    return primitive.hit(ray, 0.0, INFINITY, spans);
+}
+
+
+static void setCounters(benchmark::State &state, int64_t numHits)
+{
+    const double numRays = (double)state.iterations() * kNumRays;
+
+    state.SetItemsProcessed((int64_t)numRays);
+
+    // NB: the inverted rate is the time per ray in seconds (printed as ns).
+    state.counters["time/ray"] = benchmark::Counter(numRays, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["hit_rate"] = (double)numHits / numRays;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file BenchmarkRender.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/PhotonEngine.hpp"
+#include "engine/Scene.hpp"
+#include "models/ExampleScenes.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdlib>
+
+/**
+ * Renders the example scenes at a small resolution. The random number generator is seeded before each scene is built
+ * so that randomly placed objects are the same in every run. The counters (Mrays/s, BVH build time and samples per
+ * pixel) are written with the timings by --benchmark_out=<path> --benchmark_out_format=json for tracking regressions
+ * across commits.
+ *
+ * NB: the render itself is not repeatable. The workers share the global rand() so the paths traced (and the number of
+ * rays and samples) vary slightly between runs.
+ */
+
+static const unsigned int kPixelsWide = 96;
+static const unsigned int kPixelsHigh = 64;
+static const unsigned int kMaxSamples = 256;
+static const unsigned int kSeed = 2026;
+
+typedef Camera (*MakeScene)(Scene &scene, Real aspectRatio);
+
+
+static Camera makeMengerCubeScene3(Scene &scene, Real aspectRatio)
+{
+    return makeMengerCubeScene(scene, aspectRatio, 3);
+}
+
+
+static Camera makeMengerCubeScene4(Scene &scene, Real aspectRatio)
+{
+    return makeMengerCubeScene(scene, aspectRatio, 4);
+}
+
+
+static void BenchmarkRenderScene(benchmark::State &state, MakeScene makeScene)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const Real aspectRatio = (Real)kPixelsWide / (Real)kPixelsHigh;
+
+    double buildSeconds = 0.0, renderSeconds = 0.0;
+    uint64_t numRays = 0, numSamples = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+
+        srand(kSeed);
+
+        Scene scene;
+        Camera camera = makeScene(scene, aspectRatio);
+
+        // Time the BVH build separately.
+        const Clock::time_point buildStart = Clock::now();
+        benchmark::DoNotOptimize(scene.compiledScene());
+        buildSeconds += std::chrono::duration<double>(Clock::now() - buildStart).count();
+
+        PhotonEngine engine(kPixelsWide, kPixelsHigh);
+        engine.setMaxSamples(kMaxSamples);
+
+        state.ResumeTiming();
+
+        if (!engine.render(scene, camera, "/dev/null"))
+        {
+            state.SkipWithError("render failed");
+            break;
+        }
+
+        renderSeconds += engine.stats().renderSeconds;
+        numRays += engine.stats().numRays;
+        numSamples += engine.stats().numSamples;
+    }
+
+    const double numIterations = (double)state.iterations();
+
+    state.counters["Mrays/s"] = (renderSeconds > 0.0) ? 1e-6 * (double)numRays / renderSeconds : 0.0;
+    state.counters["build_ms"] = 1e3 * buildSeconds / numIterations;
+    state.counters["samples/pixel"] = (double)numSamples / (numIterations * kPixelsWide * kPixelsHigh);
+    state.counters["rays/sample"] = numSamples ? (double)numRays / (double)numSamples : 0.0;
+}
+
+
+BENCHMARK_CAPTURE(BenchmarkRenderScene, BatCave, makeBatCaveScene)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BenchmarkRenderScene, MengerCube3, makeMengerCubeScene3)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BenchmarkRenderScene, MengerCube4, makeMengerCubeScene4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BenchmarkRenderScene, CubeUnion, makeCubeUnionScene)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BenchmarkRenderScene, CubeDifference, makeCubeDifferenceScene)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BenchmarkRenderScene, CubeIntersection, makeCubeIntersectionScene)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BenchmarkRenderScene, CubeSphereDifference, makeCubeSphereDifferenceScene)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,36 @@
+/**
+ * @file BenchmarkScene.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/Scene.hpp"
+#include "engine/materials/MaterialTable.hpp"
+#include "models/MengerCube.hpp"
+#include <benchmark/benchmark.h>
+
+/* Destroys a compiled Menger sponge scene (20^n cubes). */
+static void BenchmarkMengerTeardown(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+
+        Scene *scene = new Scene;
+        SceneArena &arena = scene->arena();
+        MaterialTable &materials = scene->materials();
+
+        MaterialId material = materials.addMatte(color3(0.5, 0.5, 0.5));
+        scene->addObject(makeMengerSponge(arena, (int8_t)state.range(0), point3(0, 0, 0), 1.0, material));
+        (void)scene->compiledScene();
+
+        state.ResumeTiming();
+
+        delete scene;
+    }
+}
+
+BENCHMARK(BenchmarkMengerTeardown)->Arg(3)->Arg(4)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,92 @@
+/**
+ * @file BenchmarkSpheres.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/CompiledScene.hpp"
+#include "engine/Scene.hpp"
+#include "engine/materials/MaterialTable.hpp"
+#include "engine/primitives/Sphere.hpp"
+#include <benchmark/benchmark.h>
+
+extern "C"
+{
+#include "utility/Randomizer.h"
+}
+
+/* Particle-style scene: small spheres scattered through a unit cube, viewed from outside. */
+static void BenchmarkParticleSpheres(benchmark::State &state)
+{
+    Scene scene;
+    MaterialTable &materials = scene.materials();
+    MaterialId material = materials.addMatte(color3(0.5, 0.5, 0.5));
+
+    for (int i = 0; i < state.range(0); ++i)
+    {
+        Point3 center = point3(randomDoubleRange(-1, 1), randomDoubleRange(-1, 1), randomDoubleRange(-1, 1));
+        scene.addObject(scene.arena().make<Sphere>(center, 0.01, material));
+    }
+
+    CompiledScene *compiled = scene.compiledScene();
+
+    const int kNumRays = 1024;
+    std::vector<Ray> rays;
+
+    for (int i = 0; i < kNumRays; ++i)
+    {
+        Point3 origin = scaleVector(randomUnitVector(), 4.0);
+        Point3 target = point3(randomDoubleRange(-1, 1), randomDoubleRange(-1, 1), randomDoubleRange(-1, 1));
+
+        rays.push_back(Ray(origin, unitVector(subtractVectors(target, origin))));
+    }
+
+    for (auto _ : state)
+    {
+        int numHits = 0;
+
+        for (auto &ray : rays)
+        {
+            Hit hit;
+            numHits += compiled->hit(ray, 0.0, INFINITY, hit);
+        }
+
+        benchmark::DoNotOptimize(numHits);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kNumRays);
+}
+
+
+
+/* Packed kernel in isolation: one ray against a run of spheres (as in a BVH leaf). */
+static void BenchmarkPackedSphereKernel(benchmark::State &state)
+{
+    const int count = state.range(0);
+    std::vector<Real> centerX(count), centerY(count), centerZ(count), radius(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        centerX[i] = randomDoubleRange(-1, 1);
+        centerY[i] = randomDoubleRange(-1, 1);
+        centerZ[i] = randomDoubleRange(-1, 1);
+        radius[i] = 0.1;
+    }
+
+    Ray ray(point3(0, 0, -4), unitVector(vector3(0.01, 0.02, 1)));
+
+    for (auto _ : state)
+    {
+        Real hitTime;
+        benchmark::DoNotOptimize(Sphere::intersectPacked(centerX.data(), centerY.data(), centerZ.data(), radius.data(),
+                                                         count, ray, 0.0, INFINITY, &hitTime));
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BenchmarkParticleSpheres)->Arg(1000)->Arg(50000);
+BENCHMARK(BenchmarkPackedSphereKernel)->Arg(4)->Arg(8)->Arg(64);
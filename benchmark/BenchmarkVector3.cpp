@@ -8,12 +8,27 @@
  */
 
 #include <benchmark/benchmark.h>
+#include <vector>
 
 extern "C"
 {
+#include "utility/Randomizer.h"
 #include "utility/Vector3.h"
 }
 
+static std::vector<Vector3> makeRandomVectors(size_t count)
+{
+    std::vector<Vector3> vectors(count);
+
+    for (auto &v : vectors)
+    {
+        v = vector3(randomDouble(), randomDouble(), randomDouble());
+    }
+
+    return vectors;
+}
+
+
 static void BenchmarkRandomUnitVector(benchmark::State &state)
 {
     for (auto _ : state)
@@ -22,6 +37,93 @@ static void BenchmarkRandomUnitVector(benchmark::State &state)
     }
 }
 
+
+static void BenchmarkAddVectors(benchmark::State &state)
+{
+    auto u = makeRandomVectors(state.range(0));
+    auto v = makeRandomVectors(state.range(0));
+    std::vector<Vector3> w(u.size());
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < u.size(); ++i)
+        {
+            w[i] = addVectors(u[i], v[i]);
+        }
+
+        benchmark::DoNotOptimize(w.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+
+static void BenchmarkDot(benchmark::State &state)
+{
+    auto u = makeRandomVectors(state.range(0));
+    auto v = makeRandomVectors(state.range(0));
+
+    for (auto _ : state)
+    {
+        Real sum = 0.0;
+
+        for (size_t i = 0; i < u.size(); ++i)
+        {
+            sum += dot(u[i], v[i]);
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+
+static void BenchmarkCross(benchmark::State &state)
+{
+    auto u = makeRandomVectors(state.range(0));
+    auto v = makeRandomVectors(state.range(0));
+    std::vector<Vector3> w(u.size());
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < u.size(); ++i)
+        {
+            w[i] = cross(u[i], v[i]);
+        }
+
+        benchmark::DoNotOptimize(w.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+
+static void BenchmarkUnitVector(benchmark::State &state)
+{
+    auto u = makeRandomVectors(state.range(0));
+    std::vector<Vector3> w(u.size());
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < u.size(); ++i)
+        {
+            w[i] = unitVector(u[i]);
+        }
+
+        benchmark::DoNotOptimize(w.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
 // TODO: - add benchmarks using data YAML files that we will store somewhere.
 
 BENCHMARK(BenchmarkRandomUnitVector);
+BENCHMARK(BenchmarkAddVectors)->Arg(1024);
+BENCHMARK(BenchmarkDot)->Arg(1024);
+BENCHMARK(BenchmarkCross)->Arg(1024);
+BENCHMARK(BenchmarkUnitVector)->Arg(1024);
@@ -8,41 +8,18 @@
  */
 
 #include "engine/CLIOptions.hpp"
-#include "engine/PhotonEngine.hpp"
+#include "engine/RenderCommand.hpp"
 #include "engine/RenderSettings.hpp"
 #include "engine/Scene.hpp"
-#include "engine/materials/Materials.hpp"
-#include "engine/primitives/Primitives.hpp"
-#include "engine/textures/Textures.hpp"
+#include "models/ExampleScenes.hpp"
 
 int main(int argc, const char *argv[])
 {
     RenderSettings::instance().setDefaultWidthHeight(500, 500);
     parseCLIOptions(argc, argv);
 
-    Camera camera(45.0, RenderSettings::instance().aspectRatio(), 1, 0, point3(6, 3, 4), point3(0, 1, 0));
-
-    Primitive *cube1 =
-        new Cube(point3(0, 0.5, 0), vector3(0, 0, 0), 1, std::make_shared<MatteMaterial>(color3(0, 1, 0)));
-    // Primitive *sphere = new Sphere(point3(0.5, 1, -0.5), 0.5, std::make_shared<MetalMaterial>(color3(1, 0, 0)));
-    Primitive *cube2 =
-        new Cube(point3(0.5, 1, -0.5), vector3(0, 0, 0), 1.0, std::make_shared<MatteMaterial>(color3(1, 0, 0)));
-
-    Primitive *plane =
-        new Plane(point3(0, 0, 0), point3(0, 1, 0), std::make_shared<MatteMaterial>(color3(0.1, 0.1, 0.1)));
-
-    // Cube minus sphere
-    Primitive *CSG = new CSGNode(cube1, cube2, CSGNode::CSGDifference);
-
     Scene scene;
-    scene.addObject(CSG);
-    scene.addObject(plane);
-
-    PhotonEngine engine(RenderSettings::instance().pixelsWide, RenderSettings::instance().pixelsHigh);
-
-    PPMImage *outputImage = engine.render(scene, camera);
-    writeBinary16BitPPMImage(outputImage, RenderSettings::instance().outputPath);
-    freePPMImage(outputImage);
+    Camera camera = makeCubeSphereDifferenceScene(scene, RenderSettings::instance().aspectRatio());
 
-    return 0;
-}
\ No newline at end of file
+    return renderWithSettings(scene, camera);
+}
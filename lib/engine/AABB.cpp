@@ -11,7 +11,7 @@
 
 #define swap(val1, val2)                                                                                               \
     ({                                                                                                                 \
-        double temp = (val1);                                                                                          \
+        Real temp = (val1);                                                                                            \
         (val1) = (val2);                                                                                               \
         (val2) = temp;                                                                                                 \
     })
@@ -59,20 +59,20 @@ AABB AABB::addBoundingBoxes(const AABB &box0, const AABB &box1)
 }
 
 
-AABB AABB::operator+(const AABB &other)
+AABB AABB::operator+(const AABB &other) const
 {
     return addBoundingBoxes(*this, other);
 }
 
 
-bool AABB::hit(Ray &ray, double tmin, double tmax)
+bool AABB::hit(Ray &ray, Real tmin, Real tmax) const
 {
     Point3 origin = ray.origin;
 
     // Now test against x-direction.
-    double invD = 1.0 / ray.direction.x;
-    double t0 = (min.x - origin.x) * invD;
-    double t1 = (max.x - origin.x) * invD;
+    Real invD = 1.0 / ray.direction.x;
+    Real t0 = (min.x - origin.x) * invD;
+    Real t1 = (max.x - origin.x) * invD;
 
     if (invD < 0.0) swap(t0, t1);
 
@@ -107,3 +107,13 @@ bool AABB::hit(Ray &ray, double tmin, double tmax)
 
     return true;
 }
+
+
+Real AABB::surfaceArea() const
+{
+    const Vector3 extent = subtractVectors(max, min);
+
+    if (extent.x < 0.0 || extent.y < 0.0 || extent.z < 0.0) return 0.0;
+
+    return 2.0 * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
@@ -31,7 +31,7 @@ public:
     void addPoint(Point3 pt);
 
     /* Add bounding boxes */
-    AABB operator+(const AABB &other);
+    AABB operator+(const AABB &other) const;
 
     constexpr Point3 &minPt()
     {
@@ -54,7 +54,10 @@ public:
     }
 
     /** Returns true if box is hit by ray in range [tmin, tmax]. */
-    bool hit(Ray &ray, double tmin, double tmax);
+    bool hit(Ray &ray, Real tmin, Real tmax) const;
+
+    /** Returns the surface area (0 for an empty box). */
+    Real surfaceArea() const;
 
 protected:
     /** Adds two bounding boxes and returns the result. */
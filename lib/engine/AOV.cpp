@@ -0,0 +1,184 @@
+/**
+ * @file AOV.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/AOV.hpp"
+#include <cstring>
+
+namespace
+{
+struct AOVInfo
+{
+    const char *name;
+    int numChannels;
+    const char *channelNames[3];
+};
+
+const AOVInfo kAOVInfo[(int)AOV::NumAOVs] = {{"depth", 1, {"Z"}},
+                                             {"normal", 3, {"N.X", "N.Y", "N.Z"}},
+                                             {"albedo", 3, {"albedo.R", "albedo.G", "albedo.B"}},
+                                             {"material", 1, {"materialId"}},
+                                             {"samples", 1, {"samples"}},
+                                             {"variance", 1, {"variance"}},
+                                             {"cost", 1, {"cost"}},
+                                             {"time", 1, {"time"}},
+                                             {"rays", 1, {"rays"}}};
+} // namespace
+
+
+int numAOVChannels(AOVMask aovs)
+{
+    int numChannels = 0;
+
+    for (int i = 0; i < (int)AOV::NumAOVs; ++i)
+    {
+        if (aovs & aovBit((AOV)i)) numChannels += kAOVInfo[i].numChannels;
+    }
+
+    return numChannels;
+}
+
+
+int aovChannelNames(AOVMask aovs, const char **names)
+{
+    int numChannels = 0;
+
+    for (int i = 0; i < (int)AOV::NumAOVs; ++i)
+    {
+        if (!(aovs & aovBit((AOV)i))) continue;
+
+        for (int j = 0; j < kAOVInfo[i].numChannels; ++j)
+        {
+            names[numChannels++] = kAOVInfo[i].channelNames[j];
+        }
+    }
+
+    return numChannels;
+}
+
+
+int aovChannelOffset(AOVMask aovs, AOV aov)
+{
+    if (!(aovs & aovBit(aov))) return -1;
+
+    return numAOVChannels(aovs & (aovBit(aov) - 1));
+}
+
+
+void copyAOVChannels(AOVMask srcAOVs, const float *src, AOVMask dstAOVs, float *dst, size_t numPixels)
+{
+    const int srcChannels = numAOVChannels(srcAOVs);
+    const int dstChannels = numAOVChannels(dstAOVs);
+
+    for (int i = 0; i < (int)AOV::NumAOVs; ++i)
+    {
+        if (!(dstAOVs & aovBit((AOV)i))) continue;
+
+        const float *srcValues = src + aovChannelOffset(srcAOVs, (AOV)i);
+        float *dstValues = dst + aovChannelOffset(dstAOVs, (AOV)i);
+
+        for (size_t iPixel = 0; iPixel < numPixels; ++iPixel)
+        {
+            memcpy(dstValues + iPixel * dstChannels, srcValues + iPixel * srcChannels,
+                   kAOVInfo[i].numChannels * sizeof(float));
+        }
+    }
+}
+
+
+bool parseAOVs(const char *list, AOVMask &aovs)
+{
+    aovs = 0;
+
+    for (const char *name = list; name && *name;)
+    {
+        const char *end = strchr(name, ',');
+        const size_t length = end ? (size_t)(end - name) : strlen(name);
+
+        if (length == 3 && strncmp(name, "all", 3) == 0)
+        {
+            aovs = kAllAOVs;
+        }
+        else
+        {
+            int i = 0;
+
+            for (; i < (int)AOV::NumAOVs; ++i)
+            {
+                if (strlen(kAOVInfo[i].name) == length && strncmp(name, kAOVInfo[i].name, length) == 0) break;
+            }
+
+            if (i == (int)AOV::NumAOVs) return false;
+
+            aovs |= aovBit((AOV)i);
+        }
+
+        name = end ? (end + 1) : nullptr;
+    }
+
+    return (aovs != 0);
+}
+
+
+const char *aovName(AOV aov)
+{
+    return kAOVInfo[(int)aov].name;
+}
+
+
+void PixelAOVs::store(AOVMask aovs, float *values) const
+{
+    if (aovs & aovBit(AOV::Depth))
+    {
+        *values++ = (float)depth;
+    }
+
+    if (aovs & aovBit(AOV::Normal))
+    {
+        *values++ = (float)normal.x;
+        *values++ = (float)normal.y;
+        *values++ = (float)normal.z;
+    }
+
+    if (aovs & aovBit(AOV::Albedo))
+    {
+        *values++ = (float)albedo.r;
+        *values++ = (float)albedo.g;
+        *values++ = (float)albedo.b;
+    }
+
+    if (aovs & aovBit(AOV::MaterialId))
+    {
+        *values++ = (float)material;
+    }
+
+    if (aovs & aovBit(AOV::SampleCount))
+    {
+        *values++ = (float)numSamples;
+    }
+
+    if (aovs & aovBit(AOV::Variance))
+    {
+        *values++ = (float)variance;
+    }
+
+    if (aovs & aovBit(AOV::Cost))
+    {
+        *values++ = (float)cost;
+    }
+
+    if (aovs & aovBit(AOV::Time))
+    {
+        *values++ = (float)time;
+    }
+
+    if (aovs & aovBit(AOV::RayCount))
+    {
+        *values++ = (float)numRays;
+    }
+}
@@ -0,0 +1,86 @@
+/**
+ * @file AOV.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+extern "C"
+{
+#include "utility/Vector3.h"
+}
+
+/**
+ * Arbitrary output variables: per-pixel values (for denoising and compositing) which are computed from the same camera
+ * rays as the pixel's color.
+ *
+ * NB: EXR channels are half floats so the material id and the sample and ray counts are only exact up to 2048 (and are
+ * infinite above 65504).
+ */
+enum class AOV : uint32_t
+{
+    Depth,       /* Mean distance to the first hit (infinity if every sample missed) */
+    Normal,      /* Mean normal at the first hit (zero if every sample missed) */
+    Albedo,      /* Mean surface color at the first hit (background color for misses) */
+    MaterialId,  /* Material of the first sample's first hit (-1 for a miss) */
+    SampleCount, /* Number of samples taken */
+    Variance,    /* Variance of the pixel's mean luminance */
+    Cost,        /* Mean BVH nodes visited plus primitives tested per ray (see TraversalCounters) */
+    Time,        /* Wall time to sample the pixel in milliseconds */
+    RayCount,    /* Number of rays traced (camera rays and bounces) */
+    NumAOVs
+};
+
+/** Set of AOVs (bit i is set for AOV i). */
+using AOVMask = uint32_t;
+
+constexpr AOVMask aovBit(AOV aov)
+{
+    return (1u << (uint32_t)aov);
+}
+
+static constexpr AOVMask kAllAOVs = (1u << (uint32_t)AOV::NumAOVs) - 1;
+
+/** Returns the number of channels for a set of AOVs. */
+int numAOVChannels(AOVMask aovs);
+
+/** Sets the (EXR) channel names for a set of AOVs in order. Returns the number of channels. */
+int aovChannelNames(AOVMask aovs, const char **names);
+
+/** Returns the offset of an AOV's first channel in a set of AOVs (-1 if it is not in the set). */
+int aovChannelOffset(AOVMask aovs, AOV aov);
+
+/** Copies the channels of a subset of AOVs for each pixel. The channels are packed for both sets. */
+void copyAOVChannels(AOVMask srcAOVs, const float *src, AOVMask dstAOVs, float *dst, size_t numPixels);
+
+/**
+ * Parses a comma-separated list of AOV names (depth, normal, albedo, material, samples, variance, cost, time, rays or
+ * all).
+ */
+bool parseAOVs(const char *list, AOVMask &aovs);
+
+/** Returns the name of an AOV (as parsed by parseAOVs). */
+const char *aovName(AOV aov);
+
+/** AOV values for a pixel. */
+struct PixelAOVs
+{
+    Real depth;
+    Vector3 normal;
+    Color3 albedo;
+    int material;
+    int numSamples;
+    Real variance;
+    Real cost;
+    Real time;
+    int numRays;
+
+    /** Stores the values of a set of AOVs in channel order. */
+    void store(AOVMask aovs, float *values) const;
+};
@@ -7,11 +7,17 @@
  *
  */
 
+#include "engine/AOV.hpp"
 #include "engine/RenderSettings.hpp"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+extern "C"
+{
+#include "threadpool/ThreadUtils.h"
+}
+
 void printCLIOptions(const char *programName);
 
 
@@ -51,6 +57,21 @@ void parseCLIOptions(int argc, const char *argv[])
                 printCLIOptions(argv[0]);
                 exit(EXIT_SUCCESS);
             }
+            else if (strcmp(argBuffer, "--denoise") == 0)
+            {
+                RenderSettings::instance().denoise = true;
+                continue;
+            }
+            else if (strcmp(argBuffer, "--stats") == 0)
+            {
+                RenderSettings::instance().stats = true;
+                continue;
+            }
+            else if (strcmp(argBuffer, "--pin-threads") == 0)
+            {
+                RenderSettings::instance().pinThreads = true;
+                continue;
+            }
             else
             {
                 printCLIOptions(argv[0]);
@@ -63,6 +84,43 @@ void parseCLIOptions(int argc, const char *argv[])
             RenderSettings::instance().outputPath = strdup((char *)value);
             hasRequiredArg = true;
         }
+        else if (strcmp(name, "--scene") == 0)
+        {
+            RenderSettings::instance().scenePath = strdup((char *)value);
+        }
+        else if (strcmp(name, "--cache") == 0)
+        {
+            RenderSettings::instance().cachePath = strdup((char *)value);
+        }
+        else if (strcmp(name, "--telemetry") == 0)
+        {
+            RenderSettings::instance().telemetryPath = strdup((char *)value);
+        }
+        else if (strcmp(name, "--aovs") == 0)
+        {
+            AOVMask aovs;
+
+            if (!parseAOVs(value, aovs))
+            {
+                fprintf(stderr, "error: invalid value: %s for argument: %s\n", value, name);
+                exit(EXIT_FAILURE);
+            }
+
+            RenderSettings::instance().aovs = aovs;
+        }
+        else if (strcmp(name, "--heatmap") == 0)
+        {
+            AOVMask heatmaps;
+
+            // NB: only single-channel AOVs can be heatmaps.
+            if (!parseAOVs(value, heatmaps) || (heatmaps & (aovBit(AOV::Normal) | aovBit(AOV::Albedo))))
+            {
+                fprintf(stderr, "error: invalid value: %s for argument: %s\n", value, name);
+                exit(EXIT_FAILURE);
+            }
+
+            RenderSettings::instance().heatmaps = heatmaps;
+        }
         else
         {
             int outputValue = atoi(value);
@@ -79,6 +137,10 @@ void parseCLIOptions(int argc, const char *argv[])
                 RenderSettings::instance().pixelsWide = unsignedValue;
             else if (strcmp(name, "--height") == 0)
                 RenderSettings::instance().pixelsHigh = unsignedValue;
+            else if (strcmp(name, "--samples") == 0)
+                RenderSettings::instance().maxSamples = unsignedValue;
+            else if (strcmp(name, "--threads") == 0)
+                RenderSettings::instance().numThreads = unsignedValue;
         }
     }
 
@@ -96,9 +158,22 @@ void printCLIOptions(const char *programName)
             "Usage: %s [option(s)] --path=[render path]\n"
             " Render the scene\n"
             " The options are:\n"
-            "  --path              path for output render\n"
+            "  --path              path for output render (.ppm, .pfm or .exr)\n"
+            "  --scene             path of scene file to render (see SceneLoader.hpp)\n"
+            "  --cache             path of compiled scene cache (created if missing or stale)\n"
+            "  --aovs              comma-separated AOVs to output (depth, normal, albedo, material, samples,\n"
+            "                      variance, cost, time, rays or all) as EXR channels or to <path>.aov.exr\n"
+            "  --heatmap           comma-separated single-channel AOVs (e.g. time,samples,rays) to write as\n"
+            "                      false-color images to <path>.<aov>.heatmap.ppm\n"
+            "  --denoise           denoise the render guided by its albedo and normal\n"
+            "  --stats             print BVH and traversal statistics after the render\n"
+            "  --pin-threads       pin each worker thread to its own core (Linux only)\n"
+            "  --telemetry         path (or fd:<n> for a file descriptor) for a stream of JSON progress lines\n"
             "  --help              print this message and exit\n"
             "  --width             image output width in pixels (default: %u)\n"
-            "  --height            image output height in pixels (default: %u)\n",
-            programName, RenderSettings::instance().pixelsWide, RenderSettings::instance().pixelsHigh);
+            "  --height            image output height in pixels (default: %u)\n"
+            "  --samples           maximum samples per pixel (default: %u)\n"
+            "  --threads           worker threads (default: CPHOTON_THREADS or the number of cores: %u)\n",
+            programName, RenderSettings::instance().pixelsWide, RenderSettings::instance().pixelsHigh,
+            RenderSettings::instance().maxSamples, computeNumWorkers());
 }
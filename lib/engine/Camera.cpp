@@ -13,13 +13,12 @@ extern "C"
 }
 
 
-Camera::Camera(double verticalFOV_, double aspectRatio_, double focalLength_, double aperture_, Point3 origin_,
-               Point3 target_)
+Camera::Camera(Real verticalFOV_, Real aspectRatio_, Real focalLength_, Real aperture_, Point3 origin_, Point3 target_)
     : origin(origin_)
 {
     // The viewport coordinates are in the range:
-    const double viewportHeight = 2.0 * tand(verticalFOV_ / 2.0);
-    const double viewportWidth = aspectRatio_ * viewportHeight;
+    const Real viewportHeight = 2.0 * tand(verticalFOV_ / 2.0);
+    const Real viewportWidth = aspectRatio_ * viewportHeight;
 
     // w vector is in opporite direction to camera's direction!
     Vector3 vectorUp = vector3(0, 1, 0);
@@ -42,7 +41,7 @@ Camera::Camera(double verticalFOV_, double aspectRatio_, double focalLength_, do
 }
 
 
-Ray Camera::fireRay(double s, double t)
+Ray Camera::fireRay(Real s, Real t)
 {
     // Calculate offset due to non-zero aperature (defocus blur):
     Vector3 randomInDisk = scaleVector(randomInUnitDisk(), lensRadius);
@@ -17,13 +17,12 @@ class Camera
 {
 public:
     Camera() = delete;
-    Camera(double verticalFOV_, double aspectRatio_, double focalLength_, double aperture_, Point3 origin_,
-           Point3 target_);
+    Camera(Real verticalFOV_, Real aspectRatio_, Real focalLength_, Real aperture_, Point3 origin_, Point3 target_);
 
     /*
      * @brief Get a camera ray for a particular pixel. s, t are in range [0, 1).
      */
-    Ray fireRay(double s, double t);
+    Ray fireRay(Real s, Real t);
 
 protected:
     Point3 origin;
@@ -31,5 +30,5 @@ protected:
     Vector3 horizontal;
     Vector3 vertical;
     Vector3 lowerLeftCorner;
-    double lensRadius;
+    Real lensRadius;
 };
@@ -0,0 +1,311 @@
+/**
+ * @file CompiledScene.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/CompiledScene.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+static inline bool isBounded(const AABB &box);
+static inline Real axisValue(const Point3 &pt, int axis);
+
+/* Counters for the calling thread's traversals (see setThreadCounters). */
+static thread_local TraversalCounters *threadTraversalCounters = nullptr;
+
+
+CompiledScene::CompiledScene(const PrimitiveArrays &input, const MaterialTable &materials) : materialTable(&materials)
+{
+    std::vector<uint32_t> positions;
+    std::vector<Point3> centroids(input.size());
+
+    primitives.reserve(input);
+
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        const AABB &box = input.boxes[i];
+
+        if (isBounded(box))
+        {
+            centroids[i] = scaleVector(addVectors(box.minPt(), box.maxPt()), 0.5);
+            positions.push_back((uint32_t)i);
+        }
+        else
+        {
+            unboundedRefs.push_back(primitives.append(input, i));
+        }
+    }
+
+    if (!positions.empty())
+    {
+        nodes.reserve(2 * positions.size());
+        leafRefs.reserve(positions.size());
+
+        (void)build(input, positions, centroids, 0, positions.size(), 0);
+    }
+
+    // The boxes are now stored in the nodes.
+    primitives.boxes = std::vector<AABB>();
+}
+
+
+uint32_t CompiledScene::build(const PrimitiveArrays &input, std::vector<uint32_t> &positions,
+                              std::vector<Point3> &centroids, size_t start, size_t end, int depth)
+{
+    if (depth >= kMaxDepth)
+    {
+        throw std::runtime_error("exceeded maximum BVH depth");
+    }
+
+    const uint32_t iNode = (uint32_t)nodes.size();
+    nodes.push_back(Node{});
+
+    AABB box, centroidBox;
+
+    for (size_t i = start; i < end; ++i)
+    {
+        box = box + input.boxes[positions[i]];
+        centroidBox.addPoint(centroids[positions[i]]);
+    }
+
+    nodes[iNode].box = box;
+
+    const size_t count = (end - start);
+
+    if (isLeaf(input, positions, start, end))
+    {
+        // Group the leaf by type so that runs of the same type can be tested together.
+        std::stable_sort(positions.begin() + start, positions.begin() + end, [&input](uint32_t a, uint32_t b)
+                         { return (input.refs[a].type < input.refs[b].type); });
+
+        nodes[iNode].offset = (uint32_t)leafRefs.size();
+        nodes[iNode].count = (uint16_t)count;
+
+        for (size_t i = start; i < end; ++i)
+        {
+            leafRefs.push_back(primitives.append(input, positions[i]));
+        }
+
+        return iNode;
+    }
+
+    // Split about the median centroid on the largest axis.
+    Vector3 extent = subtractVectors(centroidBox.maxPt(), centroidBox.minPt());
+
+    const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+    const size_t mid = start + count / 2;
+
+    std::nth_element(positions.begin() + start, positions.begin() + mid, positions.begin() + end,
+                     [&centroids, axis](uint32_t a, uint32_t b)
+                     { return (axisValue(centroids[a], axis) < axisValue(centroids[b], axis)); });
+
+    (void)build(input, positions, centroids, start, mid, depth + 1); // Left child is always the next node.
+    const uint32_t iRight = build(input, positions, centroids, mid, end, depth + 1);
+
+    nodes[iNode].offset = iRight;
+    nodes[iNode].count = 0;
+    nodes[iNode].axis = (uint8_t)axis;
+
+    return iNode;
+}
+
+
+bool CompiledScene::isLeaf(const PrimitiveArrays &input, const std::vector<uint32_t> &positions, size_t start,
+                           size_t end) const
+{
+    const size_t count = (end - start);
+
+    if (count <= kMaxLeafSize) return true;
+    if (count > kMaxSphereLeafSize) return false;
+
+    for (size_t i = start; i < end; ++i)
+    {
+        if (input.refs[positions[i]].type != PrimitiveType::Sphere) return false;
+    }
+
+    return true;
+}
+
+
+bool CompiledScene::hit(Ray &ray, Real tmin, Real tmax, Hit &hit) const
+{
+    HitRecord record;
+
+    if (!intersect(ray, tmin, tmax, record)) return false;
+
+    primitives.surfaceInteraction(record, ray, tmin, hit);
+    return true;
+}
+
+
+bool CompiledScene::intersect(Ray &ray, Real tmin, Real tmax, HitRecord &record) const
+{
+    TraversalCounters *counters = threadTraversalCounters;
+
+    // NB: the traversal is specialized so that there is no cost when the thread is not counting.
+    if (counters) return intersect<true>(ray, tmin, tmax, record, counters);
+
+    return intersect<false>(ray, tmin, tmax, record, nullptr);
+}
+
+
+template <bool kCount>
+bool CompiledScene::intersect(Ray &ray, Real tmin, Real tmax, HitRecord &record, TraversalCounters *counters) const
+{
+    bool hitAnything = false;
+
+    if constexpr (kCount)
+    {
+        ++counters->numTraversals;
+        counters->numPrimitivesTested += unboundedRefs.size();
+    }
+
+    // Planes are unbounded so are tested before the BVH.
+    if (!unboundedRefs.empty() &&
+        primitives.intersect(unboundedRefs.data(), unboundedRefs.size(), ray, tmin, tmax, record))
+    {
+        hitAnything = true;
+        tmax = record.t;
+    }
+
+    if (nodes.empty()) return hitAnything;
+
+    const bool dirIsNegative[3] = {ray.direction.x < 0.0, ray.direction.y < 0.0, ray.direction.z < 0.0};
+
+    uint32_t stack[kMaxDepth];
+    int stackSize = 0;
+    uint32_t iNode = 0;
+
+    while (true)
+    {
+        const Node &node = nodes[iNode];
+
+        if constexpr (kCount) ++counters->numNodesVisited;
+
+        if (node.box.hit(ray, tmin, tmax))
+        {
+            if (node.count > 0)
+            {
+                if constexpr (kCount) counters->numPrimitivesTested += node.count;
+
+                if (primitives.intersect(&leafRefs[node.offset], node.count, ray, tmin, tmax, record))
+                {
+                    hitAnything = true;
+                    tmax = record.t;
+                }
+            }
+            else
+            {
+                // Visit the nearer child first so that tmax shrinks sooner.
+                if (dirIsNegative[node.axis])
+                {
+                    stack[stackSize++] = iNode + 1;
+                    iNode = node.offset;
+                }
+                else
+                {
+                    stack[stackSize++] = node.offset;
+                    iNode = iNode + 1;
+                }
+
+                continue;
+            }
+        }
+
+        if (stackSize == 0) break;
+
+        iNode = stack[--stackSize];
+    }
+
+    return hitAnything;
+}
+
+
+BVHStats CompiledScene::bvhStats() const
+{
+    BVHStats stats;
+
+    stats.numNodes = nodes.size();
+    stats.numUnbounded = unboundedRefs.size();
+
+    if (nodes.empty()) return stats;
+
+    const double rootArea = nodes[0].box.surfaceArea();
+
+    // Walk the tree depth first (the left child is the next node).
+    struct Entry
+    {
+        uint32_t iNode;
+        int depth;
+    };
+
+    Entry stack[kMaxDepth + 1];
+    int stackSize = 0;
+
+    stack[stackSize++] = {0, 0};
+
+    while (stackSize > 0)
+    {
+        const Entry entry = stack[--stackSize];
+        const Node &node = nodes[entry.iNode];
+
+        // NB: a degenerate root (e.g. a single triangle in a plane) has zero area.
+        const double areaRatio = (rootArea > 0.0) ? (node.box.surfaceArea() / rootArea) : 1.0;
+
+        if (node.count > 0)
+        {
+            ++stats.numLeaves;
+            stats.numPrimitives += node.count;
+            stats.maxDepth = std::max(stats.maxDepth, entry.depth);
+
+            if (stats.leavesAtDepth.size() <= (size_t)entry.depth) stats.leavesAtDepth.resize(entry.depth + 1);
+            if (stats.leavesWithCount.size() <= node.count) stats.leavesWithCount.resize(node.count + 1);
+
+            ++stats.leavesAtDepth[entry.depth];
+            ++stats.leavesWithCount[node.count];
+
+            stats.sahCost += areaRatio * node.count * kPrimitiveCost;
+        }
+        else
+        {
+            stats.sahCost += areaRatio * kNodeCost;
+
+            stack[stackSize++] = {node.offset, entry.depth + 1};
+            stack[stackSize++] = {entry.iNode + 1, entry.depth + 1};
+        }
+    }
+
+    return stats;
+}
+
+
+void CompiledScene::setThreadCounters(TraversalCounters *counters)
+{
+    threadTraversalCounters = counters;
+}
+
+
+TraversalCounters *CompiledScene::threadCounters()
+{
+    return threadTraversalCounters;
+}
+
+
+static inline bool isBounded(const AABB &box)
+{
+    const Point3 &min = box.minPt();
+    const Point3 &max = box.maxPt();
+
+    return (isfinite(min.x) && isfinite(min.y) && isfinite(min.z) && isfinite(max.x) && isfinite(max.y) &&
+            isfinite(max.z));
+}
+
+
+static inline Real axisValue(const Point3 &pt, int axis)
+{
+    return (axis == 0) ? pt.x : ((axis == 1) ? pt.y : pt.z);
+}
@@ -0,0 +1,153 @@
+/**
+ * @file CompiledScene.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "engine/AABB.hpp"
+#include "engine/Hit.hpp"
+#include "engine/Ray.hpp"
+#include "engine/materials/MaterialTable.hpp"
+#include "engine/primitives/PrimitiveArrays.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/** Work done by BVH traversals (see CompiledScene::setThreadCounters). */
+struct TraversalCounters
+{
+    uint64_t numTraversals{0};       /* Calls to intersect (one per ray) */
+    uint64_t numNodesVisited{0};     /* Nodes whose box was tested */
+    uint64_t numPrimitivesTested{0}; /* Primitives tested in leaves (and unbounded primitives) */
+};
+
+/** Shape of a BVH (see CompiledScene::bvhStats). */
+struct BVHStats
+{
+    size_t numNodes{0};
+    size_t numLeaves{0};
+    size_t numPrimitives{0}; /* Bounded primitives (in leaves) */
+    size_t numUnbounded{0};  /* Unbounded primitives (tested before the BVH) */
+    int maxDepth{0};         /* Depth of the deepest leaf (the root is at depth 0) */
+
+    std::vector<size_t> leavesAtDepth;   /* Number of leaves at each depth */
+    std::vector<size_t> leavesWithCount; /* Number of leaves with each primitive count */
+
+    /* Surface area heuristic: expected cost of a ray which hits the root's box relative to one primitive test */
+    double sahCost{0.0};
+};
+
+/**
+ * Render-time representation of a scene. Primitives are stored in type-tagged arrays (see PrimitiveArrays) and
+ * traversed with a flattened (linear) BVH so that the inner loop makes no virtual calls for the built-in primitive
+ * types. The primitives are reordered so that each leaf is a contiguous run, sorted by type.
+ */
+class CompiledScene
+{
+public:
+    CompiledScene() = delete;
+
+    /** NB: the material table is not copied and must outlive the compiled scene. */
+    CompiledScene(const PrimitiveArrays &primitives, const MaterialTable &materials);
+
+    /** Returns the closest hit in range (tmin, tmax) */
+    bool hit(Ray &ray, Real tmin, Real tmax, Hit &hit) const;
+
+    /** Returns the closest hit in range (tmin, tmax) without computing the surface interaction. */
+    bool intersect(Ray &ray, Real tmin, Real tmax, HitRecord &record) const;
+
+    /** Returns the materials referenced by the primitives. */
+    const MaterialTable &materials() const
+    {
+        return *materialTable;
+    }
+
+    /** Returns the number of BVH nodes. */
+    size_t numNodes() const
+    {
+        return nodes.size();
+    }
+
+    /** Returns the number of primitives. */
+    size_t numPrimitives() const
+    {
+        return primitives.size();
+    }
+
+    /** Returns the shape of the BVH and its SAH cost. */
+    BVHStats bvhStats() const;
+
+    /**
+     * Sets the counters which the calling thread's traversals are added to (nullptr to stop counting). Counting is off
+     * by default. NB: the counters are not shared between threads so they are not atomic.
+     */
+    static void setThreadCounters(TraversalCounters *counters);
+
+    /** Returns the calling thread's counters (nullptr if it is not counting). */
+    static TraversalCounters *threadCounters();
+
+    /* SAH costs of testing a node's box and a primitive */
+    static constexpr double kNodeCost = 1.0;
+    static constexpr double kPrimitiveCost = 1.0;
+
+    static constexpr int kMaxLeafSize = 4;
+
+#ifdef __AVX__
+    /* Leaves containing only spheres can be larger since the packed kernel tests several spheres at once */
+    static constexpr int kMaxSphereLeafSize = 16;
+#else
+    static constexpr int kMaxSphereLeafSize = kMaxLeafSize;
+#endif
+
+protected:
+    friend class SceneCache;
+
+    /** Constructs an empty compiled scene (see SceneCache::load). */
+    explicit CompiledScene(const MaterialTable &materials) : materialTable(&materials)
+    {
+    }
+
+    struct Node
+    {
+        AABB box;
+
+        /* Leaf: index of the first primitive in leafRefs. Interior: index of the right child (left is next node) */
+        uint32_t offset;
+
+        /* Number of primitives (0 for interior nodes) */
+        uint16_t count;
+
+        /* Split axis for interior nodes */
+        uint8_t axis;
+    };
+
+    /** Returns true if the node for bounded primitives [start, end) should be a leaf. */
+    bool isLeaf(const PrimitiveArrays &input, const std::vector<uint32_t> &positions, size_t start, size_t end) const;
+
+    /** Returns the closest hit in range (tmin, tmax) adding the work done to the counters if kCount is true. */
+    template <bool kCount>
+    bool intersect(Ray &ray, Real tmin, Real tmax, HitRecord &record, TraversalCounters *counters) const;
+
+    /** Recursively builds the node for bounded primitives [start, end). Returns the node's index. */
+    uint32_t build(const PrimitiveArrays &input, std::vector<uint32_t> &positions, std::vector<Point3> &centroids,
+                   size_t start, size_t end, int depth);
+
+    std::vector<Node> nodes;
+
+    /** Primitive references in leaf order. */
+    std::vector<PrimitiveRef> leafRefs;
+
+    /** Primitives with unbounded boxes (i.e. planes) which are tested against every ray. */
+    std::vector<PrimitiveRef> unboundedRefs;
+
+    PrimitiveArrays primitives;
+
+    const MaterialTable *materialTable;
+
+    /* NB: the tree depth is bounded by the median split */
+    static constexpr int kMaxDepth = 64;
+};
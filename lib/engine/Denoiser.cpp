@@ -0,0 +1,193 @@
+/**
+ * @file Denoiser.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/Denoiser.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+extern "C"
+{
+#include "threadpool/ThreadPool.h"
+}
+
+namespace
+{
+/** Rows per thread pool task. */
+constexpr int kRowsPerTask = 16;
+
+/** Smallest albedo channel used for demodulation (avoids dividing by zero for black surfaces). */
+constexpr float kMinAlbedo = 1e-3f;
+
+/** Struct passed to filterRows function */
+typedef struct
+{
+    int row;
+    int rows;
+    int width;
+    int height;
+    int radius;
+    const float *spatialWeights; /* (2 * radius + 1)^2 weights */
+    const float *illumination;   /* Demodulated color */
+    const float *albedo;
+    const float *normal;
+    float *output; /* Filtered illumination */
+    float colorScale;
+    float albedoScale;
+    float normalScale;
+} FilterRowsArgs;
+
+
+inline float squaredDistance(const float *a, const float *b)
+{
+    const float dx = a[0] - b[0];
+    const float dy = a[1] - b[1];
+    const float dz = a[2] - b[2];
+
+    return (dx * dx + dy * dy + dz * dz);
+}
+
+
+void filterRows(void *args)
+{
+    const FilterRowsArgs *pArgs = (const FilterRowsArgs *)args;
+
+    const int radius = pArgs->radius;
+    const int diameter = 2 * radius + 1;
+
+    for (int iRow = pArgs->row; iRow < pArgs->row + pArgs->rows; ++iRow)
+    {
+        const int rowStart = std::max(0, iRow - radius);
+        const int rowEnd = std::min(pArgs->height - 1, iRow + radius);
+
+        for (int iCol = 0; iCol < pArgs->width; ++iCol)
+        {
+            const size_t iPixel = (size_t)iRow * pArgs->width + iCol;
+
+            const float *color = pArgs->illumination + iPixel * 3;
+            const float *albedo = pArgs->albedo + iPixel * 3;
+            const float *normal = pArgs->normal + iPixel * 3;
+
+            // Color differences are relative to the pixel's brightness.
+            const float brightness = color[0] * color[0] + color[1] * color[1] + color[2] * color[2];
+            const float colorScale = pArgs->colorScale / (brightness + 1e-2f);
+
+            const int colStart = std::max(0, iCol - radius);
+            const int colEnd = std::min(pArgs->width - 1, iCol + radius);
+
+            float sum[3] = {0.0f, 0.0f, 0.0f};
+            float sumWeights = 0.0f;
+
+            for (int jRow = rowStart; jRow <= rowEnd; ++jRow)
+            {
+                const float *spatialWeights = pArgs->spatialWeights + (jRow - iRow + radius) * diameter + radius;
+
+                for (int jCol = colStart; jCol <= colEnd; ++jCol)
+                {
+                    const size_t jPixel = (size_t)jRow * pArgs->width + jCol;
+
+                    const float *otherColor = pArgs->illumination + jPixel * 3;
+
+                    const float exponent = squaredDistance(color, otherColor) * colorScale +
+                                           squaredDistance(albedo, pArgs->albedo + jPixel * 3) * pArgs->albedoScale +
+                                           squaredDistance(normal, pArgs->normal + jPixel * 3) * pArgs->normalScale;
+
+                    const float weight = spatialWeights[jCol - iCol] * expf(-exponent);
+
+                    sum[0] += weight * otherColor[0];
+                    sum[1] += weight * otherColor[1];
+                    sum[2] += weight * otherColor[2];
+                    sumWeights += weight;
+                }
+            }
+
+            // NB: the pixel's own weight is 1 so sumWeights > 0.
+            float *output = pArgs->output + iPixel * 3;
+
+            output[0] = sum[0] / sumWeights;
+            output[1] = sum[1] / sumWeights;
+            output[2] = sum[2] / sumWeights;
+        }
+    }
+}
+} // namespace
+
+
+Denoiser::Denoiser(const Settings &settings_) : settings(settings_)
+{
+}
+
+
+void Denoiser::denoise(float *rgb, const float *albedo, const float *normal, int width, int height,
+                       unsigned int numThreads) const
+{
+    if (width <= 0 || height <= 0 || settings.radius <= 0) return;
+
+    const size_t numValues = (size_t)width * height * 3;
+
+    // Demodulate the albedo.
+    std::vector<float> illumination(numValues);
+
+    for (size_t i = 0; i < numValues; ++i)
+    {
+        illumination[i] = rgb[i] / std::max(albedo[i], kMinAlbedo);
+    }
+
+    // Gaussian weights for each offset in the filter window.
+    const int radius = settings.radius;
+    const int diameter = 2 * radius + 1;
+
+    std::vector<float> spatialWeights((size_t)diameter * diameter);
+
+    for (int dy = -radius; dy <= radius; ++dy)
+    {
+        for (int dx = -radius; dx <= radius; ++dx)
+        {
+            const float distanceSquared = (float)(dx * dx + dy * dy);
+
+            spatialWeights[(dy + radius) * diameter + (dx + radius)] =
+                expf(-distanceSquared / (2.0f * settings.sigmaSpatial * settings.sigmaSpatial));
+        }
+    }
+
+    std::vector<float> output(numValues);
+
+    FilterRowsArgs args = {.row = 0,
+                           .rows = 0,
+                           .width = width,
+                           .height = height,
+                           .radius = radius,
+                           .spatialWeights = spatialWeights.data(),
+                           .illumination = illumination.data(),
+                           .albedo = albedo,
+                           .normal = normal,
+                           .output = output.data(),
+                           .colorScale = 1.0f / (2.0f * settings.sigmaColor * settings.sigmaColor),
+                           .albedoScale = 1.0f / (2.0f * settings.sigmaAlbedo * settings.sigmaAlbedo),
+                           .normalScale = 1.0f / (2.0f * settings.sigmaNormal * settings.sigmaNormal)};
+
+    ThreadPool *threadPool = allocThreadPool(std::max(1u, numThreads));
+
+    for (int iRow = 0; iRow < height; iRow += kRowsPerTask)
+    {
+        args.row = iRow;
+        args.rows = std::min(kRowsPerTask, height - iRow);
+        addTask(threadPool, filterRows, &args, sizeof(FilterRowsArgs));
+    }
+
+    executeTasks(threadPool);
+    deallocThreadPool(threadPool);
+
+    // Remodulate.
+    for (size_t i = 0; i < numValues; ++i)
+    {
+        rgb[i] = output[i] * std::max(albedo[i], kMinAlbedo);
+    }
+}
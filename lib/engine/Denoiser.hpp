@@ -0,0 +1,43 @@
+/**
+ * @file Denoiser.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+/**
+ * Joint bilateral filter which removes Monte Carlo noise from a render guided by its albedo and normal AOVs.
+ *
+ * The color is divided by the albedo before filtering so that texture detail is not blurred. Neighbouring pixels are
+ * then weighted by their distance and by how much their albedo, normal and (demodulated) color differ so that edges
+ * in the guide buffers are preserved.
+ */
+class Denoiser
+{
+public:
+    struct Settings
+    {
+        int radius{5};            /* Filter half-width in pixels */
+        float sigmaSpatial{2.0f}; /* Standard deviation of the distance (pixels) */
+        float sigmaColor{0.5f};   /* Standard deviation of the relative color difference */
+        float sigmaAlbedo{0.3f};  /* Standard deviation of the albedo difference */
+        float sigmaNormal{0.25f}; /* Standard deviation of the normal difference (zero normals are misses) */
+    };
+
+    Denoiser() = default;
+    explicit Denoiser(const Settings &settings_);
+
+    /**
+     * @brief Denoises rows of packed float RGB in place. The albedo and normal are packed float triples for the same
+     * pixels. The rows are filtered in parallel by numThreads.
+     */
+    void denoise(float *rgb, const float *albedo, const float *normal, int width, int height,
+                 unsigned int numThreads) const;
+
+private:
+    Settings settings;
+};
@@ -0,0 +1,91 @@
+/**
+ * @file Heatmap.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/Heatmap.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+extern "C"
+{
+#include "utility/PPMWriter.h"
+}
+
+/* Display (gamma encoded) colors at even intervals of the scale */
+static const int kNumStops = 5;
+static const float kStops[kNumStops][3] = {
+    {0.00f, 0.00f, 0.00f}, {0.34f, 0.06f, 0.43f}, {0.87f, 0.32f, 0.23f}, {0.99f, 0.80f, 0.17f}, {1.00f, 1.00f, 1.00f}};
+
+
+float Heatmap::scale(const float *values, size_t numValues)
+{
+    std::vector<float> finite;
+    finite.reserve(numValues);
+
+    for (size_t i = 0; i < numValues; ++i)
+    {
+        if (std::isfinite(values[i])) finite.push_back(values[i]);
+    }
+
+    if (finite.empty()) return 0.0f;
+
+    const size_t iTop = (size_t)(kTopPercentile * (double)(finite.size() - 1));
+    std::nth_element(finite.begin(), finite.begin() + iTop, finite.end());
+
+    // NB: if most of the values are zero, fall back to the maximum.
+    if (finite[iTop] > 0.0f) return finite[iTop];
+
+    return *std::max_element(finite.begin(), finite.end());
+}
+
+
+void Heatmap::color(float value, float *rgb)
+{
+    const float position = std::clamp(std::isnan(value) ? 0.0f : value, 0.0f, 1.0f) * (kNumStops - 1);
+
+    const int iStop = std::min((int)position, kNumStops - 2);
+    const float fraction = position - (float)iStop;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const float display = kStops[iStop][i] + fraction * (kStops[iStop + 1][i] - kStops[iStop][i]);
+
+        // NB: the PPM writer gamma-encodes linear values.
+        rgb[i] = powf(display, 2.2f);
+    }
+}
+
+
+bool Heatmap::write(const char *path, const float *values, int width, int height)
+{
+    const size_t numPixels = (size_t)width * height;
+    const float topValue = scale(values, numPixels);
+    const float invTopValue = (topValue > 0.0f) ? (1.0f / topValue) : 0.0f;
+
+    PPMStream *stream = openPPMStream(path, width, height, 8);
+    if (!stream) return false;
+
+    std::vector<float> row((size_t)width * 3);
+
+    for (int iRow = 0; iRow < height; ++iRow)
+    {
+        const float *rowValues = values + (size_t)iRow * width;
+
+        for (int iCol = 0; iCol < width; ++iCol)
+        {
+            const float value = std::isinf(rowValues[iCol]) ? 1.0f : rowValues[iCol] * invTopValue;
+
+            color(value, &row[(size_t)iCol * 3]);
+        }
+
+        (void)writePPMStreamRows(stream, row.data(), 1);
+    }
+
+    return closePPMStream(stream);
+}
@@ -0,0 +1,35 @@
+/**
+ * @file Heatmap.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstddef>
+
+/**
+ * False-color images of per-pixel values such as the render cost (time, samples or rays) of each pixel. The values are
+ * scaled from zero (black) through purple, red and yellow to the 99th percentile (white) so that a few expensive pixels
+ * do not hide the rest. Larger values (including infinity) are clamped and NaNs are black.
+ */
+class Heatmap
+{
+public:
+    /** Returns the value which maps to the top of the scale (the 99th percentile of the finite values). */
+    static float scale(const float *values, size_t numValues);
+
+    /** Sets the (linear) RGB color for a value in [0, 1]. */
+    static void color(float value, float *rgb);
+
+    /**
+     * Writes a width x height image of values (top row first) to an 8-bit PPM. Returns false if the file could not be
+     * written.
+     */
+    static bool write(const char *path, const float *values, int width, int height);
+
+    /** Percentile of the finite values at the top of the scale. */
+    static constexpr double kTopPercentile = 0.99;
+};
@@ -14,3 +14,15 @@ bool Hit::isValid(Time min, Time max) const
 {
     return isValid(t, min, max);
 }
+
+
+Ray Hit::spawnRay(Vector3 direction) const
+{
+    // The rounding error in hitPt grows with its magnitude so the offset must too.
+    const Real magnitude = fmax(fabs(hitPt.x), fmax(fabs(hitPt.y), fabs(hitPt.z)));
+    const Real offset = kRayOffsetEpsilon * (1.0 + magnitude);
+
+    Vector3 offsetDirection = (dot(direction, normal) >= 0.0) ? normal : flipVector(normal);
+
+    return Ray(addVectors(hitPt, scaleVector(offsetDirection, offset)), direction);
+}
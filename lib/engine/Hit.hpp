@@ -19,7 +19,7 @@ extern "C"
 class Hit
 {
 public:
-    using Time = double;
+    using Time = Real;
 
     /* Returns true if hit lies within range (min, max) */
     bool isValid(Time min, Time max) const;
@@ -32,6 +32,12 @@ public:
     /* Default constructor */
     Hit() = default;
 
+    /*
+     * Returns a ray leaving the surface in a new direction. The origin is offset from hitPt along the normal (on the
+     * side the ray leaves from) so that the ray cannot re-intersect the surface that it starts on.
+     */
+    Ray spawnRay(Vector3 direction) const;
+
     /* Hit time */
     Time t;
 
@@ -45,8 +51,8 @@ public:
     bool frontFace;
 
     /* Texture coordinates [0, 1] */
-    double u, v;
+    Real u, v;
 
     /* Surface material */
-    Material *material{nullptr};
+    MaterialId material{kNoMaterial};
 };
\ No newline at end of file
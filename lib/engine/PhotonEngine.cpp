@@ -8,25 +8,228 @@
  */
 
 #include "engine/PhotonEngine.hpp"
+#include "engine/Denoiser.hpp"
+#include "engine/Heatmap.hpp"
 #include "engine/PhotonEngineImpl.hpp"
-#include "engine/primitives/BVHNode.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <memory>
 #include <stdint.h>
+#include <string.h>
+#include <string>
+#include <strings.h>
+#include <vector>
 
 extern "C"
 {
 #include "threadpool/ThreadPool.h"
 #include "threadpool/ThreadUtils.h"
+#include "utility/HDRWriter.h"
 }
 
+namespace
+{
+/** Returns the path without its extension (if any). */
+std::string pathWithoutExtension(const char *path)
+{
+    const char *extension = strrchr(path, '.');
+    if (extension && strchr(extension, '/')) extension = nullptr;
+
+    return std::string(path, extension ? (size_t)(extension - path) : strlen(path));
+}
+
+
+/**
+ * Writes rows of packed float RGB (and AOV channels) to a PPM or HDR stream. The AOVs are extra channels of an EXR
+ * or are written to "<path without extension>.aov.exr" for other formats.
+ */
+class ImageOutput
+{
+public:
+    ImageOutput(const char *path, int width_, int height, int bitDepth, AOVMask aovs)
+        : width(width_), numAOVChannels(::numAOVChannels(aovs))
+    {
+        const char *channelNames[3 + kMaxAOVChannels] = {"R", "G", "B"};
+        aovChannelNames(aovs, channelNames + 3);
+
+        const char *extension = path ? strrchr(path, '.') : nullptr;
+        if (extension && strchr(extension, '/')) extension = nullptr;
+
+        if (extension && strcasecmp(extension, ".exr") == 0)
+        {
+            hdrStream = openHDRStream(path, HDRFormatEXR, width, height, channelNames, 3 + numAOVChannels);
+            interleaveAOVs = (numAOVChannels > 0);
+            return;
+        }
+
+        if (extension && strcasecmp(extension, ".pfm") == 0)
+            hdrStream = openHDRStream(path, HDRFormatPFM, width, height, channelNames, 3);
+        else
+            ppmStream = openPPMStream(path, width, height, bitDepth);
+
+        if (numAOVChannels > 0 && isOpen())
+        {
+            const std::string aovPath = pathWithoutExtension(path) + ".aov.exr";
+
+            aovStream = openHDRStream(aovPath.c_str(), HDRFormatEXR, width, height, channelNames + 3, numAOVChannels);
+            if (!aovStream) close();
+        }
+    }
+
+    bool isOpen() const
+    {
+        return (ppmStream || hdrStream);
+    }
+
+    bool writeRows(const float *rgb, const float *aovValues, int numRows)
+    {
+        if (interleaveAOVs)
+        {
+            const size_t numPixels = (size_t)numRows * width;
+            const int numChannels = 3 + numAOVChannels;
+
+            interleaved.resize(numPixels * numChannels);
+
+            for (size_t i = 0; i < numPixels; ++i)
+            {
+                float *values = interleaved.data() + i * numChannels;
+
+                memcpy(values, rgb + i * 3, 3 * sizeof(float));
+                memcpy(values + 3, aovValues + i * numAOVChannels, numAOVChannels * sizeof(float));
+            }
+
+            return writeHDRStreamRows(hdrStream, interleaved.data(), numRows);
+        }
+
+        if (aovStream && !writeHDRStreamRows(aovStream, aovValues, numRows)) return false;
+
+        return ppmStream ? writePPMStreamRows(ppmStream, rgb, numRows) : writeHDRStreamRows(hdrStream, rgb, numRows);
+    }
+
+    bool close()
+    {
+        bool success = true;
+
+        if (aovStream) success = closeHDRStream(aovStream) && success;
+        if (ppmStream) success = closePPMStream(ppmStream) && success;
+        if (hdrStream) success = closeHDRStream(hdrStream) && success;
+
+        ppmStream = nullptr;
+        hdrStream = nullptr;
+        aovStream = nullptr;
+        return success;
+    }
+
+private:
+    static constexpr int kMaxAOVChannels = 16;
+
+    int width;
+    int numAOVChannels;
+    bool interleaveAOVs{false};
+    std::vector<float> interleaved;
+
+    PPMStream *ppmStream{nullptr};
+    HDRStream *hdrStream{nullptr};
+    HDRStream *aovStream{nullptr};
+};
+} // namespace
+
 PhotonEngine::PhotonEngine(unsigned int pixelsWide_, unsigned int pixelsHigh_)
     : pixelsWide(pixelsWide_), pixelsHigh(pixelsHigh_)
 {
 }
 
+
+void PhotonEngine::setAOVs(AOVMask aovs_)
+{
+    aovs = aovs_;
+}
+
+
+bool PhotonEngine::setHeatmaps(AOVMask heatmaps_)
+{
+    for (int i = 0; i < (int)AOV::NumAOVs; ++i)
+    {
+        if ((heatmaps_ & aovBit((AOV)i)) && numAOVChannels(aovBit((AOV)i)) != 1) return false;
+    }
+
+    heatmaps = heatmaps_;
+    return true;
+}
+
+
+void PhotonEngine::setMaxSamples(unsigned int maxSamples_)
+{
+    maxSamples = std::min(std::max(1u, maxSamples_), kMaxSamples);
+}
+
+
+void PhotonEngine::setDenoise(bool denoise_)
+{
+    denoise = denoise_;
+}
+
+
+void PhotonEngine::setBVHStats(bool enable)
+{
+    bvhStats = enable;
+}
+
+
+void PhotonEngine::setTelemetry(FILE *stream, double intervalSeconds)
+{
+    telemetryStream = stream;
+    telemetryInterval = intervalSeconds;
+}
+
+
+void PhotonEngine::printStats(FILE *stream) const
+{
+    fprintf(stream, "render: %.2f s, %llu rays, %llu samples", lastStats.renderSeconds,
+            (unsigned long long)lastStats.numRays, (unsigned long long)lastStats.numSamples);
+
+    if (lastStats.renderSeconds > 0.0)
+        fprintf(stream, " (%.2f Mrays/s)", 1e-6 * (double)lastStats.numRays / lastStats.renderSeconds);
+
+    fprintf(stream, "\n");
+
+    if (lastStats.denoiseSeconds > 0.0) fprintf(stream, "denoise: %.2f s\n", lastStats.denoiseSeconds);
+
+    if (!lastStats.hasTraversalStats) return;
+
+    const BVHStats &bvh = lastStats.bvh;
+
+    fprintf(stream, "bvh: %zu nodes, %zu leaves, %zu primitives (+ %zu unbounded), max depth %d, SAH cost %.2f\n",
+            bvh.numNodes, bvh.numLeaves, bvh.numPrimitives, bvh.numUnbounded, bvh.maxDepth, bvh.sahCost);
+
+    fprintf(stream, "bvh leaves by depth:");
+    for (size_t depth = 0; depth < bvh.leavesAtDepth.size(); ++depth)
+    {
+        if (bvh.leavesAtDepth[depth]) fprintf(stream, " %zu:%zu", depth, bvh.leavesAtDepth[depth]);
+    }
+
+    fprintf(stream, "\nbvh leaves by primitive count:");
+    for (size_t count = 0; count < bvh.leavesWithCount.size(); ++count)
+    {
+        if (bvh.leavesWithCount[count]) fprintf(stream, " %zu:%zu", count, bvh.leavesWithCount[count]);
+    }
+
+    fprintf(stream, "\n");
+
+    const TraversalCounters &traversals = lastStats.traversals;
+    const double invNumTraversals = traversals.numTraversals ? (1.0 / (double)traversals.numTraversals) : 0.0;
+
+    fprintf(stream, "traversal: %.2f nodes visited, %.2f primitives tested per ray\n",
+            (double)traversals.numNodesVisited * invNumTraversals,
+            (double)traversals.numPrimitivesTested * invNumTraversals);
+}
+
+
 PPMImage *PhotonEngine::render(Scene &scene, Camera &camera) const
 {
-    if (!scene.BVH())
+    CompiledScene *compiledScene = scene.compiledScene();
+    if (!compiledScene)
     {
         return nullptr;
     }
@@ -36,7 +239,7 @@ PPMImage *PhotonEngine::render(Scene &scene, Camera &camera) const
 
     ThreadPool *threadPool = allocThreadPool(computeNumWorkers());
 
-    RenderPixelArgs args = {.row = 0, .col = 0, .camera = &camera, .objects = scene.BVH(), .image = image};
+    RenderPixelArgs args = {.row = 0, .col = 0, .camera = &camera, .scene = compiledScene, .image = image};
 
     for (int iRow = 0; iRow < image->height; ++iRow)
     {
@@ -54,3 +257,176 @@ PPMImage *PhotonEngine::render(Scene &scene, Camera &camera) const
     deallocThreadPool(threadPool);
     return image;
 }
+
+
+bool PhotonEngine::render(Scene &scene, Camera &camera, const char *path, int bitDepth)
+{
+    using Clock = std::chrono::steady_clock;
+
+    lastStats = RenderStats();
+
+    CompiledScene *compiledScene = scene.compiledScene();
+    if (!compiledScene)
+    {
+        return false;
+    }
+
+    ImageOutput output(path, pixelsWide, pixelsHigh, bitDepth, aovs);
+    if (!output.isOpen()) return false;
+
+    // The denoiser is guided by the albedo and normal.
+    const AOVMask renderAOVs =
+        (denoise ? (aovs | aovBit(AOV::Albedo) | aovBit(AOV::Normal)) : aovs) | heatmaps;
+    const int numRenderAOVChannels = numAOVChannels(renderAOVs);
+
+    // Round the window down to whole tile rows. NB: the denoiser filters the whole image.
+    const unsigned int maxWindowRows = (unsigned int)(kMaxWindowPixels / pixelsWide);
+    const unsigned int windowRows =
+        denoise ? pixelsHigh : std::max(kTileSize, maxWindowRows - maxWindowRows % kTileSize);
+
+    const size_t maxWindowPixels = (size_t)std::min(windowRows, pixelsHigh) * pixelsWide;
+
+    // NB: not initialized since every pixel of a window is rendered before it is written.
+    std::unique_ptr<float[]> window(new float[maxWindowPixels * 3]);
+    std::unique_ptr<float[]> aovWindow(renderAOVs ? new float[maxWindowPixels * numRenderAOVChannels] : nullptr);
+    std::vector<float> outputAOVs((renderAOVs != aovs) ? maxWindowPixels * numAOVChannels(aovs) : 0);
+
+    // Heatmap values (one channel per heatmap) for the whole image.
+    const int numHeatmaps = numAOVChannels(heatmaps);
+    std::vector<float> heatmapValues((size_t)pixelsWide * pixelsHigh * numHeatmaps);
+
+    const unsigned int numWorkers = computeNumWorkers();
+
+    ThreadPool *threadPool = allocThreadPool(numWorkers);
+
+    RenderCounters counters;
+    counters.numRays = 0;
+    counters.numSamples = 0;
+    counters.numTraversals = 0;
+    counters.numNodesVisited = 0;
+    counters.numPrimitivesTested = 0;
+
+    RenderTileArgs args = {.row = 0,
+                           .col = 0,
+                           .rows = 0,
+                           .cols = 0,
+                           .pixelsWide = (uint16_t)pixelsWide,
+                           .pixelsHigh = (uint16_t)pixelsHigh,
+                           .camera = &camera,
+                           .scene = compiledScene,
+                           .window = window.get(),
+                           .windowTopRow = 0,
+                           .maxSamples = (uint16_t)maxSamples,
+                           .counters = &counters,
+                           .countTraversals = bvhStats,
+                           .telemetry = nullptr,
+                           .aovs = renderAOVs,
+                           .aovWindow = aovWindow.get()};
+
+    std::unique_ptr<Telemetry> telemetry;
+
+    if (telemetryStream)
+    {
+        telemetry = std::make_unique<Telemetry>(telemetryStream, (uint64_t)pixelsWide * pixelsHigh, telemetryInterval);
+        telemetry->start();
+
+        args.telemetry = telemetry.get();
+    }
+
+    // NB: the file's first row is the top row of the image.
+    for (unsigned int windowEnd = pixelsHigh; windowEnd > 0;)
+    {
+        const unsigned int windowStart = (windowEnd > windowRows) ? (windowEnd - windowRows) : 0;
+        const size_t windowPixels = (size_t)(windowEnd - windowStart) * pixelsWide;
+
+        args.windowTopRow = (uint16_t)(windowEnd - 1);
+
+        const Clock::time_point renderStart = Clock::now();
+
+        for (unsigned int iRow = windowStart; iRow < windowEnd; iRow += kTileSize)
+        {
+            args.row = (uint16_t)iRow;
+            args.rows = (uint16_t)std::min(kTileSize, windowEnd - iRow);
+
+            for (unsigned int iCol = 0; iCol < pixelsWide; iCol += kTileSize)
+            {
+                args.col = (uint16_t)iCol;
+                args.cols = (uint16_t)std::min(kTileSize, pixelsWide - iCol);
+                addTask(threadPool, renderTile, &args, sizeof(RenderTileArgs));
+            }
+        }
+
+        executeTasks(threadPool);
+
+        const Clock::time_point renderEnd = Clock::now();
+        lastStats.renderSeconds += std::chrono::duration<double>(renderEnd - renderStart).count();
+
+        if (denoise)
+        {
+            std::vector<float> albedo(windowPixels * 3), normal(windowPixels * 3);
+
+            copyAOVChannels(renderAOVs, aovWindow.get(), aovBit(AOV::Albedo), albedo.data(), windowPixels);
+            copyAOVChannels(renderAOVs, aovWindow.get(), aovBit(AOV::Normal), normal.data(), windowPixels);
+
+            Denoiser().denoise(window.get(), albedo.data(), normal.data(), pixelsWide, windowEnd - windowStart,
+                               numWorkers);
+
+            lastStats.denoiseSeconds += std::chrono::duration<double>(Clock::now() - renderEnd).count();
+        }
+
+        if (numHeatmaps > 0)
+        {
+            float *heatmapRows = heatmapValues.data() + (size_t)(pixelsHigh - windowEnd) * pixelsWide * numHeatmaps;
+            copyAOVChannels(renderAOVs, aovWindow.get(), heatmaps, heatmapRows, windowPixels);
+        }
+
+        // Drop any AOVs which were only rendered for the denoiser or heatmaps.
+        if (!outputAOVs.empty())
+            copyAOVChannels(renderAOVs, aovWindow.get(), aovs, outputAOVs.data(), windowPixels);
+
+        const float *windowAOVs = outputAOVs.empty() ? aovWindow.get() : outputAOVs.data();
+
+        if (!output.writeRows(window.get(), windowAOVs, windowEnd - windowStart)) break;
+
+        windowEnd = windowStart;
+    }
+
+    deallocThreadPool(threadPool);
+
+    if (telemetry) telemetry->stop();
+
+    bool success = output.close();
+
+    for (int i = 0; i < (int)AOV::NumAOVs && success; ++i)
+    {
+        if (!(heatmaps & aovBit((AOV)i))) continue;
+
+        // Gather the AOV's channel from the interleaved heatmaps.
+        const int offset = aovChannelOffset(heatmaps, (AOV)i);
+        const size_t numPixels = (size_t)pixelsWide * pixelsHigh;
+
+        std::vector<float> values(numPixels);
+
+        for (size_t iPixel = 0; iPixel < numPixels; ++iPixel)
+        {
+            values[iPixel] = heatmapValues[iPixel * numHeatmaps + offset];
+        }
+
+        const std::string heatmapPath = pathWithoutExtension(path) + "." + aovName((AOV)i) + ".heatmap.ppm";
+        success = Heatmap::write(heatmapPath.c_str(), values.data(), pixelsWide, pixelsHigh);
+    }
+
+    lastStats.numRays = counters.numRays;
+    lastStats.numSamples = counters.numSamples;
+
+    if (bvhStats)
+    {
+        lastStats.hasTraversalStats = true;
+        lastStats.traversals.numTraversals = counters.numTraversals;
+        lastStats.traversals.numNodesVisited = counters.numNodesVisited;
+        lastStats.traversals.numPrimitivesTested = counters.numPrimitivesTested;
+        lastStats.bvh = compiledScene->bvhStats();
+    }
+
+    return success;
+}
@@ -9,14 +9,31 @@
 
 #pragma once
 
+#include "engine/AOV.hpp"
 #include "engine/Camera.hpp"
 #include "engine/Scene.hpp"
+#include "engine/Telemetry.hpp"
+#include <cstdio>
 
 extern "C"
 {
 #include "utility/PPMWriter.h"
 }
 
+/** Timings and counts of the last render to a file. */
+struct RenderStats
+{
+    double renderSeconds{0.0};
+    double denoiseSeconds{0.0};
+    uint64_t numRays{0};    /* Rays traced (camera rays and bounces) */
+    uint64_t numSamples{0}; /* Camera rays */
+
+    /* Only set if statistics are enabled (see PhotonEngine::setBVHStats) */
+    bool hasTraversalStats{false};
+    TraversalCounters traversals;
+    BVHStats bvh;
+};
+
 class PhotonEngine
 {
 public:
@@ -28,7 +45,80 @@ public:
      */
     PPMImage *render(Scene &scene, Camera &camera) const;
 
+    /**
+     * @brief Renders a scene to a file. The image is rendered in windows of tile rows (from the top) which are written
+     * as they complete so memory is bounded by the window rather than the image. Returns false if the scene is empty or
+     * the file could not be written.
+     *
+     * The format is chosen by the path's extension: ".exr" (linear half float RGB), ".pfm" (linear float RGB) or
+     * otherwise binary PPM with 8 or 16 bits per channel.
+     *
+     * Any AOVs are rendered in the same pass. They are added as channels of an EXR or written to a separate EXR
+     * ("<path without extension>.aov.exr") for other formats.
+     *
+     * If denoising is enabled, the whole image is rendered as a single window (with albedo and normal AOVs) so that it
+     * can be filtered before it is written.
+     *
+     * Any heatmaps are written to "<path without extension>.<AOV name>.heatmap.ppm" after the render.
+     */
+    bool render(Scene &scene, Camera &camera, const char *path, int bitDepth = 16);
+
+    /** Sets the AOVs to output when rendering to a file (none by default). */
+    void setAOVs(AOVMask aovs);
+
+    /** Sets the maximum samples per pixel when rendering to a file. Pixels stop earlier if they converge. */
+    void setMaxSamples(unsigned int maxSamples);
+
+    /**
+     * Sets single-channel AOVs (e.g. time, samples, rays or cost) to write as false-color heatmaps (see Heatmap.hpp)
+     * alongside the render. Returns false if an AOV has several channels. NB: the heatmap values are held for the whole
+     * image.
+     */
+    bool setHeatmaps(AOVMask heatmaps);
+
+    /** Enables denoising (see Denoiser.hpp) when rendering to a file. Allows far fewer samples per pixel. */
+    void setDenoise(bool denoise);
+
+    /**
+     * Enables BVH statistics when rendering to a file: the shape of the BVH and the work done by its traversals (see
+     * RenderStats). Each thread counts for a tile and the counts are added once the tile is complete.
+     */
+    void setBVHStats(bool enable);
+
+    /**
+     * Enables a progress and telemetry stream when rendering to a file: JSON lines with the percentage complete, ray
+     * and sample rates, ETA and memory are written to the stream by a background thread each interval (see
+     * Telemetry.hpp). Disabled if the stream is NULL. NB: the stream is not closed.
+     */
+    void setTelemetry(FILE *stream, double intervalSeconds = Telemetry::kDefaultIntervalSeconds);
+
+    /** Prints a summary of the statistics of the last render to a file. */
+    void printStats(FILE *stream) const;
+
+    /** Returns the timings and counts of the last render to a file. */
+    const RenderStats &stats() const
+    {
+        return lastStats;
+    }
+
+    /** Default maximum samples per pixel. */
+    static constexpr unsigned int kMaxSamples = 10000;
+
+    /** Width and height of a tile in pixels. */
+    static constexpr unsigned int kTileSize = 32;
+
+    /** Maximum pixels in a window (float RGB: 12 bytes per pixel). Windows are at least one tile row. */
+    static constexpr size_t kMaxWindowPixels = 1 << 22;
+
 private:
     unsigned int pixelsWide;
     unsigned int pixelsHigh;
+    AOVMask aovs{0};
+    AOVMask heatmaps{0};
+    unsigned int maxSamples{kMaxSamples};
+    bool denoise{false};
+    bool bvhStats{false};
+    FILE *telemetryStream{nullptr};
+    double telemetryInterval{Telemetry::kDefaultIntervalSeconds};
+    RenderStats lastStats;
 };
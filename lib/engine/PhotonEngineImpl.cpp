@@ -9,31 +9,51 @@
 
 #include "engine/PhotonEngineImpl.hpp"
 #include "engine/Hit.hpp"
+#include "engine/PhotonEngine.hpp"
+#include <algorithm>
+#include <chrono>
 
 extern "C"
 {
 #include "utility/Randomizer.h"
 }
 
-static const double kMinHitTime = 0.002; // Positive tmin fixes shadow acne.
-static const double kMaxHitTime = INFINITY;
+static const Real kMinHitTime = 0.0; // NB: shadow acne is avoided by offsetting scattered rays (see Hit::spawnRay).
+static const Real kMaxHitTime = INFINITY;
 
+/* Rays traced and samples taken by the current thread. NB: added to the render's counters after each tile. */
+static thread_local uint64_t threadNumRays = 0;
+static thread_local uint64_t threadNumSamples = 0;
 
-Color3 rayColor(Ray &ray, Primitive *objectsBVH, int depth)
+
+Color3 rayColor(Ray &ray, CompiledScene *scene, int depth, FirstHit *firstHit)
 {
     Hit hit;
 
     if (depth <= 0) return color3(0, 0, 0); // Exceeded ray bounce limit.
 
-    if (objectsBVH->hit(ray, kMinHitTime, kMaxHitTime, hit))
+    ++threadNumRays;
+
+    if (scene->hit(ray, kMinHitTime, kMaxHitTime, hit))
     {
+        const MaterialTable &materials = scene->materials();
+
+        if (firstHit)
+        {
+            firstHit->isHit = true;
+            firstHit->depth = hit.t * vectorLength(ray.direction);
+            firstHit->normal = hit.normal;
+            firstHit->albedo = materials.albedo(hit.material, hit);
+            firstHit->material = hit.material;
+        }
+
         Ray scatteredRay;
         Color3 attenuation;
-        Color3 emitted = hit.material->emitted();
+        Color3 emitted = materials.emitted(hit.material);
 
-        if (hit.material->scatter(ray, hit, scatteredRay, attenuation))
+        if (materials.scatter(hit.material, ray, hit, scatteredRay, attenuation))
         {
-            Color3 outputColor = rayColor(scatteredRay, objectsBVH, depth - 1);
+            Color3 outputColor = rayColor(scatteredRay, scene, depth - 1);
 
             // Light source color + (ray output * attenuation)
             return addVectors(emitted, multiplyColors(outputColor, attenuation));
@@ -47,17 +67,95 @@ Color3 rayColor(Ray &ray, Primitive *objectsBVH, int depth)
     else
     {
         // Didn't hit anything. Return the background color for the sky:
-        const double t = 0.5 * (unitVector(ray.direction).y + 1.0);
+        const Real t = 0.5 * (unitVector(ray.direction).y + 1.0);
 
         Color3 whiteComponent = scaleVector(color3(1, 1, 1), 1 - t);
         Color3 blueComponent = scaleVector(color3(0.5, 0.7, 1.0), t);
 
-        return addVectors(whiteComponent, blueComponent);
+        Color3 background = addVectors(whiteComponent, blueComponent);
+
+        if (firstHit)
+        {
+            firstHit->isHit = false;
+            firstHit->albedo = background;
+        }
+
+        return background;
     }
 }
 
 
 void renderPixel(void *args)
+{
+    RenderPixelArgs *pArgs = (RenderPixelArgs *)args;
+
+    pArgs->image->pixelValue[pArgs->row][pArgs->col] =
+        samplePixel(pArgs->row, pArgs->col, pArgs->image->width, pArgs->image->height, pArgs->camera, pArgs->scene,
+                    PhotonEngine::kMaxSamples);
+}
+
+
+void renderTile(void *args)
+{
+    RenderTileArgs *pArgs = (RenderTileArgs *)args;
+
+    threadNumRays = 0;
+    threadNumSamples = 0;
+
+    // NB: the tile's traversals are counted on the stack and added to the render's counters at the end.
+    TraversalCounters traversals;
+
+    const bool countTraversals = pArgs->countTraversals || (pArgs->aovs & aovBit(AOV::Cost));
+    if (countTraversals) CompiledScene::setThreadCounters(&traversals);
+
+    for (int iRow = pArgs->row; iRow < pArgs->row + pArgs->rows; ++iRow)
+    {
+        float *pixel = pArgs->window + ((size_t)(pArgs->windowTopRow - iRow) * pArgs->pixelsWide + pArgs->col) * 3;
+
+        for (int iCol = pArgs->col; iCol < pArgs->col + pArgs->cols; ++iCol, pixel += 3)
+        {
+            const uint64_t startNumRays = threadNumRays, startNumSamples = threadNumSamples;
+
+            PixelAOVs aovs;
+
+            const Color3 color = samplePixel(iRow, iCol, pArgs->pixelsWide, pArgs->pixelsHigh, pArgs->camera,
+                                             pArgs->scene, pArgs->maxSamples, pArgs->aovWindow ? &aovs : nullptr);
+
+            pixel[0] = (float)color.r;
+            pixel[1] = (float)color.g;
+            pixel[2] = (float)color.b;
+
+            if (pArgs->aovWindow)
+            {
+                const size_t iPixel = (size_t)(pArgs->windowTopRow - iRow) * pArgs->pixelsWide + iCol;
+
+                aovs.store(pArgs->aovs, pArgs->aovWindow + iPixel * numAOVChannels(pArgs->aovs));
+            }
+
+            if (pArgs->telemetry)
+                pArgs->telemetry->addPixel(threadNumSamples - startNumSamples, threadNumRays - startNumRays);
+        }
+    }
+
+    if (countTraversals) CompiledScene::setThreadCounters(nullptr);
+
+    if (pArgs->counters)
+    {
+        pArgs->counters->numRays += threadNumRays;
+        pArgs->counters->numSamples += threadNumSamples;
+
+        if (pArgs->countTraversals)
+        {
+            pArgs->counters->numTraversals += traversals.numTraversals;
+            pArgs->counters->numNodesVisited += traversals.numNodesVisited;
+            pArgs->counters->numPrimitivesTested += traversals.numPrimitivesTested;
+        }
+    }
+}
+
+
+Color3 samplePixel(int row, int col, int pixelsWide, int pixelsHigh, Camera *camera, CompiledScene *scene,
+                   int maxSamples, PixelAOVs *aovs)
 {
     /**
      * References:
@@ -84,28 +182,67 @@ void renderPixel(void *args)
 
     static const int kMaxDepth = 50;
     static const int kMinSample = 200; // Need sufficient number to approximate Normal distribution.
-    static const int kMaxSample = 10000;
     static const int kSampleBatch = 10;
 
-    RenderPixelArgs *pArgs = (RenderPixelArgs *)args;
+    const int sampleLimit = std::max(1, maxSamples);
 
-    Color3 pixelColor = color3(0, 0, 0);
+    // NB: accumulated in double precision (Real may be float) over up to maxSamples samples.
+    double sumR = 0.0, sumG = 0.0, sumB = 0.0;
 
     double s1 = 0.0; // Sum of values.
     double s2 = 0.0; // Sum of squares of values.
 
     int numSamples = 1;
 
+    // AOVs:
+    FirstHit firstHit;
+    FirstHit *pFirstHit = aovs ? &firstHit : nullptr;
+
+    // Time and ray count AOVs.
+    const std::chrono::steady_clock::time_point startTime =
+        aovs ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    const uint64_t startNumRays = threadNumRays;
+
+    // Cost AOV: the work done by this pixel's traversals (if the thread is counting).
+    const TraversalCounters *traversals = aovs ? CompiledScene::threadCounters() : nullptr;
+    const uint64_t startCost = traversals ? (traversals->numNodesVisited + traversals->numPrimitivesTested) : 0;
+    const uint64_t startTraversals = traversals ? traversals->numTraversals : 0;
+
+    if (aovs)
+    {
+        aovs->depth = 0.0;
+        aovs->normal = vector3(0, 0, 0);
+        aovs->albedo = color3(0, 0, 0);
+        aovs->material = -1;
+        aovs->cost = 0.0;
+    }
+
+    int numHits = 0;
+
     // Sampling:
-    for (; numSamples <= kMaxSample; ++numSamples)
+    for (; numSamples <= sampleLimit; ++numSamples)
     {
-        const double u = (pArgs->col + randomDouble()) / (double)(pArgs->image->width - 1);
-        const double v = (pArgs->row + randomDouble()) / (double)(pArgs->image->height - 1);
+        const Real u = (col + randomDouble()) / (double)(pixelsWide - 1);
+        const Real v = (row + randomDouble()) / (double)(pixelsHigh - 1);
 
         // Generate a new camera ray:
-        Ray ray = pArgs->camera->fireRay(u, v);
+        Ray ray = camera->fireRay(u, v);
 
-        Color3 color = rayColor(ray, pArgs->objects, kMaxDepth);
+        Color3 color = rayColor(ray, scene, kMaxDepth, pFirstHit);
+
+        if (aovs)
+        {
+            if (firstHit.isHit)
+            {
+                aovs->depth += firstHit.depth;
+                aovs->normal = addVectors(aovs->normal, firstHit.normal);
+                ++numHits;
+
+                if (numSamples == 1) aovs->material = firstHit.material;
+            }
+
+            aovs->albedo = addVectors(aovs->albedo, firstHit.albedo);
+        }
 
         // Compute the luminance:
         // https://stackoverflow.com/questions/596216/formula-to-determine-perceived-brightness-of-rgb-color
@@ -116,7 +253,9 @@ void renderPixel(void *args)
             s2 += (luminance * luminance);
         }
 
-        pixelColor = addVectors(pixelColor, color);
+        sumR += color.r;
+        sumG += color.g;
+        sumB += color.b;
 
         // Recalculate the metric periodically to see if we need additional samples.
         // NB: ensure we have sufficient samples first to have a good figure.
@@ -136,6 +275,35 @@ void renderPixel(void *args)
         }
     }
 
-    // Set the image's pixel to the average value:
-    pArgs->image->pixelValue[pArgs->row][pArgs->col] = scaleVector(pixelColor, 1.0 / (double)numSamples);
+    numSamples = std::min(numSamples, sampleLimit); // NB: the loop may exit with numSamples = sampleLimit + 1.
+
+    threadNumSamples += numSamples;
+
+    if (aovs)
+    {
+        aovs->depth = numHits ? (aovs->depth / numHits) : INFINITY;
+        aovs->normal = numHits ? unitVector(aovs->normal) : aovs->normal;
+        aovs->albedo = scaleVector(aovs->albedo, 1.0 / (double)numSamples);
+        aovs->numSamples = numSamples;
+
+        // Variance of the mean luminance = sigma^2 / N.
+        const double invNumSamples = 1.0 / (double)numSamples;
+        aovs->variance = std::max(0.0, invNumSamples * (s2 - (s1 * s1) * invNumSamples)) * invNumSamples;
+
+        if (traversals)
+        {
+            const uint64_t cost = traversals->numNodesVisited + traversals->numPrimitivesTested - startCost;
+            const uint64_t numTraversals = traversals->numTraversals - startTraversals;
+
+            aovs->cost = numTraversals ? ((double)cost / (double)numTraversals) : 0.0;
+        }
+
+        aovs->numRays = (int)(threadNumRays - startNumRays);
+        aovs->time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    // Average value:
+    const double invNumSamples = 1.0 / (double)numSamples;
+
+    return color3((Real)(sumR * invNumSamples), (Real)(sumG * invNumSamples), (Real)(sumB * invNumSamples));
 }
\ No newline at end of file
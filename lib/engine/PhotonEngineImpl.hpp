@@ -8,9 +8,11 @@
  */
 
 #pragma once
+#include "engine/AOV.hpp"
 #include "engine/Camera.hpp"
+#include "engine/CompiledScene.hpp"
 #include "engine/Ray.hpp"
-#include "engine/primitives/Primitive.hpp"
+#include "engine/Telemetry.hpp"
 
 extern "C"
 {
@@ -18,6 +20,7 @@ extern "C"
 #include "utility/Vector3.h"
 }
 
+#include <atomic>
 #include <stdint.h>
 
 /** Struct passed to renderPixel function */
@@ -26,10 +29,65 @@ typedef struct
     uint16_t row;
     uint16_t col;
     Camera *camera;
-    Primitive *objects;
+    CompiledScene *scene;
     PPMImage *image;
 } RenderPixelArgs;
 
+/** Totals for a render which are updated after each tile */
+typedef struct
+{
+    std::atomic<uint64_t> numRays;
+    std::atomic<uint64_t> numSamples;
+
+    /* Only counted if enabled for the tiles (see RenderTileArgs) */
+    std::atomic<uint64_t> numTraversals;
+    std::atomic<uint64_t> numNodesVisited;
+    std::atomic<uint64_t> numPrimitivesTested;
+} RenderCounters;
+
+/** Struct passed to renderTile function */
+typedef struct
+{
+    uint16_t row; /* Bottom row of the tile */
+    uint16_t col; /* Left column of the tile */
+    uint16_t rows;
+    uint16_t cols;
+    uint16_t pixelsWide;
+    uint16_t pixelsHigh;
+    Camera *camera;
+    CompiledScene *scene;
+
+    /* Packed RGB rows of the window being rendered in file order (i.e. top row first) */
+    float *window;
+    uint16_t windowTopRow;
+
+    /* Maximum samples per pixel */
+    uint16_t maxSamples;
+
+    /* Rays and samples are added to the counters (if not NULL) */
+    RenderCounters *counters;
+
+    /* BVH traversals are counted and added to the counters. NB: they are always counted for the cost AOV */
+    bool countTraversals;
+
+    /* Completed pixels are added to the telemetry (if not NULL) */
+    Telemetry *telemetry;
+
+    /* AOVs to render and rows of their channels for the window (NULL if no AOVs) */
+    AOVMask aovs;
+    float *aovWindow;
+} RenderTileArgs;
+
+/** Values at the first hit of a camera ray (for AOVs) */
+typedef struct
+{
+    bool isHit;
+    Real depth;
+    Vector3 normal;
+    Color3 albedo;
+    MaterialId material;
+} FirstHit;
+
 /**
  * @brief Renders a single pixel by repeatedly firing rays for a pixel and sampling the colors. Function is called by a
  * worker in a thread pool.
@@ -37,11 +95,25 @@ typedef struct
  */
 void renderPixel(void *args);
 
+/**
+ * @brief Renders a tile of pixels into a window of rows. Function is called by a worker in a thread pool.
+ * @param args is a pointer to the RenderTileArgs struct cast to (void *)
+ */
+void renderTile(void *args);
+
+/**
+ * @brief Returns the average color of the samples for a pixel. More samples are taken until the mean luminance has
+ * converged or maxSamples have been taken. If aovs is not NULL, the pixel's AOVs are computed from the same samples.
+ */
+Color3 samplePixel(int row, int col, int pixelsWide, int pixelsHigh, Camera *camera, CompiledScene *scene,
+                   int maxSamples, PixelAOVs *aovs = nullptr);
+
 /**
  * @brief Computes the ray color for a single pixel and sample.
  * @param ray is the ray being fired
- * @param objectsBVH is the object containing all primitives in the scene
+ * @param scene is the compiled scene containing all primitives
  * @param depth is the maximum number of "bounces"
+ * @param firstHit is set to the values at the ray's first hit if it is not NULL
  * @return Color3 is the color of the returned ray
  */
-Color3 rayColor(Ray &ray, Primitive *objectsBVH, int depth);
+Color3 rayColor(Ray &ray, CompiledScene *scene, int depth, FirstHit *firstHit = nullptr);
@@ -15,7 +15,7 @@ Ray::Ray(Point3 origin_, Vector3 direction_) : origin(std::move(origin_)), direc
 }
 
 
-Point3 Ray::pointAtTime(double t)
+Point3 Ray::pointAtTime(Real t)
 {
     return addVectors(origin, scaleVector(direction, t));
 }
@@ -21,7 +21,7 @@ struct Ray
     Ray(Point3 origin, Vector3 direction);
 
     /* Returns the ray at a time t */
-    Point3 pointAtTime(double t);
+    Point3 pointAtTime(Real t);
 
     Point3 origin;
     Vector3 direction;
@@ -0,0 +1,114 @@
+/**
+ * @file RenderCommand.cpp
+ * @author Edward Palmer
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/RenderCommand.hpp"
+#include "engine/PhotonEngine.hpp"
+#include "engine/RenderSettings.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <unistd.h>
+
+extern "C"
+{
+#include "threadpool/ThreadUtils.h"
+}
+
+static FILE *openTelemetry(const char *path);
+
+
+int renderWithSettings(Scene &scene, Camera &camera)
+{
+    const RenderSettings &settings = RenderSettings::instance();
+
+    setNumWorkers(settings.numThreads);
+    setPinWorkers(settings.pinThreads);
+
+    try
+    {
+        if (!scene.compiledScene())
+        {
+            fprintf(stderr, "error: scene is empty\n");
+            return EXIT_FAILURE;
+        }
+
+        PhotonEngine engine(settings.pixelsWide, settings.pixelsHigh);
+        engine.setAOVs(settings.aovs);
+        (void)engine.setHeatmaps(settings.heatmaps);
+        engine.setMaxSamples(settings.maxSamples);
+        engine.setDenoise(settings.denoise);
+        engine.setBVHStats(settings.stats);
+
+        FILE *telemetryStream = nullptr;
+
+        if (settings.telemetryPath)
+        {
+            if (!(telemetryStream = openTelemetry(settings.telemetryPath)))
+            {
+                fprintf(stderr, "error: failed to open telemetry stream %s\n", settings.telemetryPath);
+                return EXIT_FAILURE;
+            }
+
+            engine.setTelemetry(telemetryStream);
+        }
+
+        const bool success = engine.render(scene, camera, settings.outputPath);
+
+        if (telemetryStream) fclose(telemetryStream);
+
+        if (!success)
+        {
+            fprintf(stderr, "error: failed to write %s\n", settings.outputPath);
+            return EXIT_FAILURE;
+        }
+
+        if (settings.stats)
+        {
+            engine.printStats(stdout);
+        }
+        else if (settings.denoise)
+        {
+            fprintf(stdout, "render: %.2f s, denoise: %.2f s\n", engine.stats().renderSeconds,
+                    engine.stats().denoiseSeconds);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "error: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/* Opens the telemetry stream: a file path or "fd:<n>" for an open file descriptor (e.g. "fd:2" for stderr). */
+static FILE *openTelemetry(const char *path)
+{
+    if (strncmp(path, "fd:", 3) == 0)
+    {
+        char *end = nullptr;
+        const long fd = strtol(path + 3, &end, 10);
+
+        if (end == path + 3 || *end != '\0' || fd < 0) return nullptr;
+
+        // NB: duplicated so that closing the stream does not close the descriptor.
+        const int duplicate = dup((int)fd);
+        if (duplicate < 0) return nullptr;
+
+        FILE *stream = fdopen(duplicate, "w");
+        if (!stream) close(duplicate);
+
+        return stream;
+    }
+
+    return fopen(path, "w");
+}
@@ -0,0 +1,19 @@
+/**
+ * @file RenderCommand.hpp
+ * @author Edward Palmer
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "engine/Camera.hpp"
+#include "engine/Scene.hpp"
+
+/**
+ * Renders a scene to the output path with the RenderSettings (see parseCLIOptions). This applies the worker threads
+ * and pinning, samples, AOVs, heatmaps, denoising, telemetry and stats so that the tools and examples all support the
+ * same options. Errors are printed to stderr. Returns EXIT_SUCCESS or EXIT_FAILURE (the exit status for main).
+ */
+int renderWithSettings(Scene &scene, Camera &camera);
@@ -30,6 +30,16 @@ public:
     uint16_t pixelsWide{0};
     uint16_t pixelsHigh{0};
     char *outputPath{nullptr};
+    char *scenePath{nullptr};
+    char *cachePath{nullptr};
+    char *telemetryPath{nullptr}; /* Path or "fd:<n>" for the telemetry stream */
+    uint32_t aovs{0};     /* AOVMask (see AOV.hpp) */
+    uint32_t heatmaps{0}; /* AOVMask of single-channel AOVs */
+    uint16_t maxSamples{10000};
+    uint16_t numThreads{0}; /* Zero for the default (see computeNumWorkers) */
+    bool pinThreads{false};
+    bool denoise{false};
+    bool stats{false};
 
 protected:
     /* Protect default constructor */
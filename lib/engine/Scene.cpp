@@ -13,7 +13,7 @@
 bool Scene::addObject(Primitive *object)
 {
     // Do not add objects if null or already constructed.
-    if (!object || bvh)
+    if (!object || bvh || compiled)
     {
         return false;
     }
@@ -39,29 +39,50 @@ BVHNode *Scene::BVH()
 
     // Construct.
     objects.shrink_to_fit();
-    bvh = new BVHNode(objects.data(), 0, objects.size());
+    bvh = sceneArena.make<BVHNode>(sceneArena, objects.data(), 0, objects.size());
 
-    // No longer require vector of pointers. The BVHNode when its destructor is called
-    // will cleanup all memory since it takes ownership of primitives.
-    objects.clear();
+    // No longer require vector of pointers.
+    objects = std::vector<Primitive *>();
 
     return bvh;
 }
 
 
-Scene::~Scene()
+CompiledScene *Scene::compiledScene()
 {
+    if (compiled)
+    {
+        return compiled;
+    }
+
+    PrimitiveArrays primitives;
+
+    // NB: the compiled scene builds its own BVH so the objects are compiled directly (unless the legacy BVH has
+    // already been built from them).
     if (bvh)
     {
-        // BVH will delete all objects in its destructor.
-        delete bvh;
+        bvh->compile(primitives);
     }
     else
     {
-        // Delete all objects in vector.
-        for (auto *object : objects)
+        if (objects.empty()) return nullptr;
+
+        for (Primitive *object : objects)
         {
-            delete object;
+            object->compile(primitives);
         }
     }
-}
\ No newline at end of file
+
+    compiled = new CompiledScene(primitives, materialTable);
+    return compiled;
+}
+
+
+Scene::~Scene()
+{
+    // The arena frees the objects and BVH.
+    if (compiled)
+    {
+        delete compiled;
+    }
+}
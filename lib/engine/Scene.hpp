@@ -8,6 +8,9 @@
  */
 
 #pragma once
+#include "engine/CompiledScene.hpp"
+#include "engine/SceneArena.hpp"
+#include "engine/materials/MaterialTable.hpp"
 #include "engine/primitives/BVHNode.hpp"
 #include "engine/primitives/Primitive.hpp"
 
@@ -16,18 +19,48 @@
 class Scene
 {
 public:
+    Scene() = default;
     ~Scene();
 
-    /** Adds object to the scene and takes ownership of memory. */
+    Scene(const Scene &) = delete;
+    Scene &operator=(const Scene &) = delete;
+
+    /** Returns the arena which owns the scene's primitives. */
+    SceneArena &arena()
+    {
+        return sceneArena;
+    }
+
+    /** Returns the table of materials referenced by the scene's primitives. */
+    MaterialTable &materials()
+    {
+        return materialTable;
+    }
+
+    /** Adds object to the scene. NB: the object must be allocated from arena() (or outlive the scene). */
     bool addObject(Primitive *object);
 
-    /** Constructs and returns BVH node. */
+    /** Constructs and returns BVH node. NB: only built on request (the compiled scene does not use it). */
     BVHNode *BVH();
 
+    /** Constructs and returns the compiled scene used for rendering. */
+    CompiledScene *compiledScene();
+
 protected:
+    friend class SceneCache;
+
+    /** Owns the objects and BVH nodes. NB: destroyed last. */
+    SceneArena sceneArena;
+
+    /** Materials and textures. */
+    MaterialTable materialTable;
+
     /** Stores pointers to each object required for BVH. */
     std::vector<Primitive *> objects;
 
     /** Constructed BVH node. */
     BVHNode *bvh{nullptr};
+
+    /** Compiled scene. NB: references the primitives owned by the arena. */
+    CompiledScene *compiled{nullptr};
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+/**
+ * @file SceneArena.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/SceneArena.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+
+SceneArena::~SceneArena()
+{
+    for (Finalizer *finalizer = finalizers; finalizer; finalizer = finalizer->next)
+    {
+        finalizer->destroy(finalizer->object);
+    }
+
+    while (head)
+    {
+        Block *next = head->next;
+        free(head);
+        head = next;
+    }
+}
+
+
+Rotate3 *SceneArena::makeRotation(Vector3 rotationAngles)
+{
+    if (isNearlyZero(rotationAngles)) return nullptr; // No rotation matrix required.
+
+    return initRotate3(allocate(sizeOfRotate3(), alignof(std::max_align_t)), rotationAngles);
+}
+
+
+void *SceneArena::allocate(size_t size, size_t alignment)
+{
+    uintptr_t address = ((uintptr_t)current + (alignment - 1)) & ~(uintptr_t)(alignment - 1);
+
+    if (!current || address + size > (uintptr_t)end)
+    {
+        // Start a new block. The remainder of the current block is unused.
+        const size_t capacity = std::max(nextBlockSize, size + alignment);
+
+        Block *block = (Block *)malloc(sizeof(Block) + capacity);
+        if (!block) throw std::bad_alloc();
+
+        block->next = head;
+        block->capacity = capacity;
+        head = block;
+
+        current = (char *)(block + 1);
+        end = current + capacity;
+        nextBlockSize = std::min(2 * nextBlockSize, kMaxBlockSize);
+
+        address = ((uintptr_t)current + (alignment - 1)) & ~(uintptr_t)(alignment - 1);
+    }
+
+    usedBytes += (address + size) - (uintptr_t)current;
+    current = (char *)(address + size);
+
+    return (void *)address;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file SceneArena.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+extern "C"
+{
+#include "utility/Matrix3.h"
+#include "utility/Vector3.h"
+}
+
+/**
+ * Bump allocator which owns the primitives, BVH nodes and rotation matrices of a scene. Objects are allocated
+ * contiguously in large blocks and are freed together when the arena is destroyed.
+ *
+ * Destructors are only recorded for types which are not trivially destructible (e.g. types holding a std::vector).
+ * Primitives are trivially destructible so tearing down a scene only frees the blocks.
+ */
+class SceneArena
+{
+public:
+    SceneArena() = default;
+    ~SceneArena();
+
+    SceneArena(const SceneArena &) = delete;
+    SceneArena &operator=(const SceneArena &) = delete;
+
+    /** Constructs an object in the arena. */
+    template <typename T, typename... Args>
+    T *make(Args &&...args)
+    {
+        if constexpr (std::is_trivially_destructible<T>::value)
+        {
+            return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            void *finalizer = allocate(sizeof(Finalizer), alignof(Finalizer));
+            T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+            // NB: only recorded once constructed.
+            finalizers = new (finalizer) Finalizer{object, [](void *ptr) { static_cast<T *>(ptr)->~T(); }, finalizers};
+            return object;
+        }
+    }
+
+    /** Returns a rotation matrix for the angles (degrees) or nullptr if there is no rotation. */
+    Rotate3 *makeRotation(Vector3 rotationAngles);
+
+    /** Returns uninitialized memory. Throws std::bad_alloc on failure. */
+    void *allocate(size_t size, size_t alignment);
+
+    /** Returns the number of bytes allocated (including alignment padding). */
+    size_t bytesUsed() const
+    {
+        return usedBytes;
+    }
+
+protected:
+    struct Block
+    {
+        Block *next;
+        size_t capacity;
+    };
+
+    struct Finalizer
+    {
+        void *object;
+        void (*destroy)(void *object);
+        Finalizer *next;
+    };
+
+    /* Newest block. Allocations are made from [current, end) */
+    Block *head{nullptr};
+    char *current{nullptr};
+    char *end{nullptr};
+
+    /* Destructors to run (newest first) */
+    Finalizer *finalizers{nullptr};
+
+    size_t usedBytes{0};
+    size_t nextBlockSize{kInitialBlockSize};
+
+    static constexpr size_t kInitialBlockSize = 64 * 1024;
+    static constexpr size_t kMaxBlockSize = 16 * 1024 * 1024;
+};
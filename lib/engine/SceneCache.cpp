@@ -0,0 +1,535 @@
+/**
+ * @file SceneCache.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/SceneCache.hpp"
+#include "engine/primitives/MengerSponge.hpp"
+#include "engine/primitives/SdfPrimitive.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+/* Sections in the order they are stored */
+enum Section : uint32_t
+{
+    Nodes,
+    LeafRefs,
+    UnboundedRefs,
+    PrimitiveRefs,
+    SphereCenterX,
+    SphereCenterY,
+    SphereCenterZ,
+    SphereRadius,
+    Cubes,
+    Triangles,
+    Discs,
+    Planes,
+    Cylinders,
+    Cones,
+    Mengers,
+    Sdfs,
+    Rotations,
+    MaterialEntries,
+    Mattes,
+    Metals,
+    Dielectrics,
+    Emitters,
+    TextureEntries,
+    SolidTextures,
+    CheckerTextures,
+    NumSections
+};
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t realSize;
+    uint64_t contentHash;
+    uint32_t maxLeafSize;
+    uint32_t maxSphereLeafSize;
+    uint32_t numSections;
+    uint32_t reserved;
+};
+
+struct SectionHeader
+{
+    uint64_t offset;
+    uint64_t count;
+    uint64_t elementSize;
+};
+
+/* A section to write */
+struct SectionData
+{
+    const void *data;
+    uint64_t count;
+    uint64_t elementSize;
+};
+
+const char kMagic[8] = {'C', 'P', 'H', 'O', 'T', 'O', 'N', 'S'};
+
+/* NB: sections start on cache line boundaries so that the mapped arrays are aligned */
+constexpr uint64_t kSectionAlignment = 64;
+
+template <typename T> SectionData section(const std::vector<T> &values)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "cached types must be trivially copyable");
+
+    return {values.data(), values.size(), sizeof(T)};
+}
+
+
+/** Read-only mapping of a file. Unmapped when destroyed. */
+class FileMapping
+{
+public:
+    explicit FileMapping(const char *path)
+    {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return;
+
+        struct stat info;
+
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            void *address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (address != MAP_FAILED)
+            {
+                data = (const uint8_t *)address;
+                size = (size_t)info.st_size;
+            }
+        }
+
+        close(fd); // NB: the mapping remains valid.
+    }
+
+    ~FileMapping()
+    {
+        if (data) munmap((void *)data, size);
+    }
+
+    FileMapping(const FileMapping &) = delete;
+    FileMapping &operator=(const FileMapping &) = delete;
+
+    const uint8_t *data{nullptr};
+    size_t size{0};
+};
+
+
+/** Copies a section into values. Returns false if the element size does not match. */
+template <typename T> bool readSection(const FileMapping &file, const SectionHeader &header, std::vector<T> &values)
+{
+    if (header.elementSize != sizeof(T)) return false;
+
+    const T *first = (const T *)(file.data + header.offset);
+    values.assign(first, first + header.count);
+    return true;
+}
+
+
+/** Replaces the rotation matrix pointers with 1-based indices in rotations (0 for no rotation). */
+template <typename Record>
+std::vector<Record> encodeRotations(const std::vector<Record> &records, std::vector<Rotate3 *> &rotations,
+                                    std::unordered_map<Rotate3 *, uintptr_t> &rotationIndices)
+{
+    std::vector<Record> encoded(records);
+
+    for (Record &record : encoded)
+    {
+        if (!record.rotationMatrix) continue;
+
+        auto result = rotationIndices.emplace(record.rotationMatrix, rotations.size() + 1);
+        if (result.second) rotations.push_back(record.rotationMatrix);
+
+        record.rotationMatrix = (Rotate3 *)result.first->second;
+    }
+
+    return encoded;
+}
+
+
+/** Replaces the 1-based rotation indices with pointers. Returns false if an index is out of range. */
+template <typename Record> bool decodeRotations(std::vector<Record> &records, const std::vector<Rotate3 *> &rotations)
+{
+    for (Record &record : records)
+    {
+        const uintptr_t index = (uintptr_t)record.rotationMatrix;
+        if (index > rotations.size()) return false;
+
+        record.rotationMatrix = index ? rotations[index - 1] : nullptr;
+    }
+
+    return true;
+}
+
+
+bool isValidRef(const PrimitiveRef &ref, const PrimitiveArrays &arrays, size_t numMaterials)
+{
+    if (ref.material >= numMaterials) return false;
+
+    switch (ref.type)
+    {
+        case PrimitiveType::Sphere:
+            return ref.index < arrays.spheres.radius.size();
+        case PrimitiveType::Cube:
+            return ref.index < arrays.cubes.size();
+        case PrimitiveType::Triangle:
+            return ref.index < arrays.triangles.size();
+        case PrimitiveType::Disc:
+            return ref.index < arrays.discs.size();
+        case PrimitiveType::Plane:
+            return ref.index < arrays.planes.size();
+        case PrimitiveType::Cylinder:
+            return ref.index < arrays.cylinders.size();
+        case PrimitiveType::Cone:
+            return ref.index < arrays.cones.size();
+        case PrimitiveType::Menger:
+            return ref.index < arrays.mengers.size();
+        case PrimitiveType::Sdf:
+            return ref.index < arrays.sdfs.size();
+        default:
+            return false;
+    }
+}
+} // namespace
+
+
+bool SceneCache::save(const char *path, uint64_t contentHash, Scene &scene)
+{
+    CompiledScene *compiled = scene.compiledScene();
+    if (!path || !compiled) return false;
+
+    const PrimitiveArrays &arrays = compiled->primitives;
+    const MaterialTable &materials = scene.materialTable;
+    const TextureTable &textures = materials.textureTable;
+
+    // Generic primitives and image textures are referenced by pointer.
+    if (!arrays.generic.empty() || !textures.images.empty()) return false;
+
+    std::vector<Rotate3 *> rotations;
+    std::unordered_map<Rotate3 *, uintptr_t> rotationIndices;
+
+    const auto cubes = encodeRotations(arrays.cubes, rotations, rotationIndices);
+    const auto cylinders = encodeRotations(arrays.cylinders, rotations, rotationIndices);
+    const auto cones = encodeRotations(arrays.cones, rotations, rotationIndices);
+
+    std::vector<uint8_t> rotationBytes(rotations.size() * sizeOfRotate3());
+
+    for (size_t i = 0; i < rotations.size(); ++i)
+    {
+        memcpy(&rotationBytes[i * sizeOfRotate3()], rotations[i], sizeOfRotate3());
+    }
+
+    SectionData sections[NumSections];
+    sections[Nodes] = section(compiled->nodes);
+    sections[LeafRefs] = section(compiled->leafRefs);
+    sections[UnboundedRefs] = section(compiled->unboundedRefs);
+    sections[PrimitiveRefs] = section(arrays.refs);
+    sections[SphereCenterX] = section(arrays.spheres.centerX);
+    sections[SphereCenterY] = section(arrays.spheres.centerY);
+    sections[SphereCenterZ] = section(arrays.spheres.centerZ);
+    sections[SphereRadius] = section(arrays.spheres.radius);
+    sections[Cubes] = section(cubes);
+    sections[Triangles] = section(arrays.triangles);
+    sections[Discs] = section(arrays.discs);
+    sections[Planes] = section(arrays.planes);
+    sections[Cylinders] = section(cylinders);
+    sections[Cones] = section(cones);
+    sections[Mengers] = section(arrays.mengers);
+    sections[Sdfs] = section(arrays.sdfs);
+    sections[Rotations] = {rotationBytes.data(), rotations.size(), sizeOfRotate3()};
+    sections[MaterialEntries] = section(materials.entries);
+    sections[Mattes] = section(materials.mattes);
+    sections[Metals] = section(materials.metals);
+    sections[Dielectrics] = section(materials.dielectrics);
+    sections[Emitters] = section(materials.emitters);
+    sections[TextureEntries] = section(textures.entries);
+    sections[SolidTextures] = section(textures.solids);
+    sections[CheckerTextures] = section(textures.checkers);
+
+    FileHeader header = {};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.realSize = sizeof(Real);
+    header.contentHash = contentHash;
+    header.maxLeafSize = CompiledScene::kMaxLeafSize;
+    header.maxSphereLeafSize = CompiledScene::kMaxSphereLeafSize;
+    header.numSections = NumSections;
+
+    SectionHeader sectionHeaders[NumSections];
+    uint64_t offset = sizeof(FileHeader) + sizeof(sectionHeaders);
+
+    for (uint32_t i = 0; i < NumSections; ++i)
+    {
+        offset = (offset + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+
+        sectionHeaders[i] = {offset, sections[i].count, sections[i].elementSize};
+        offset += sections[i].count * sections[i].elementSize;
+    }
+
+    // Write to a temporary file which replaces the cache once complete.
+    const std::string tmpPath = std::string(path) + ".tmp";
+
+    FILE *fp = fopen(tmpPath.c_str(), "wb");
+    if (!fp) return false;
+
+    bool success = (fwrite(&header, sizeof(header), 1, fp) == 1) &&
+                   (fwrite(sectionHeaders, sizeof(sectionHeaders), 1, fp) == 1);
+
+    static const uint8_t kPadding[kSectionAlignment] = {0};
+
+    for (uint32_t i = 0; success && i < NumSections; ++i)
+    {
+        const long padding = (long)sectionHeaders[i].offset - ftell(fp);
+        const size_t size = sections[i].count * sections[i].elementSize;
+
+        success = (padding >= 0 && fwrite(kPadding, 1, padding, fp) == (size_t)padding) &&
+                  (size == 0 || fwrite(sections[i].data, size, 1, fp) == 1);
+    }
+
+    success = (fclose(fp) == 0) && success;
+
+    if (!success || rename(tmpPath.c_str(), path) != 0)
+    {
+        remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+
+bool SceneCache::load(const char *path, uint64_t contentHash, Scene &scene)
+{
+    if (!path || scene.compiled || scene.bvh || !scene.objects.empty()) return false;
+
+    FileMapping file(path);
+    if (!file.data || file.size < sizeof(FileHeader) + NumSections * sizeof(SectionHeader)) return false;
+
+    const FileHeader *header = (const FileHeader *)file.data;
+
+    if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion ||
+        header->realSize != sizeof(Real) || header->contentHash != contentHash ||
+        header->maxLeafSize != CompiledScene::kMaxLeafSize ||
+        header->maxSphereLeafSize != CompiledScene::kMaxSphereLeafSize || header->numSections != NumSections)
+    {
+        return false;
+    }
+
+    const SectionHeader *sections = (const SectionHeader *)(file.data + sizeof(FileHeader));
+
+    for (uint32_t i = 0; i < NumSections; ++i)
+    {
+        const SectionHeader &s = sections[i];
+
+        if (s.offset % kSectionAlignment != 0 || s.offset > file.size || s.elementSize == 0 ||
+            s.count > (file.size - s.offset) / s.elementSize)
+        {
+            return false;
+        }
+    }
+
+    CompiledScene *compiled = new CompiledScene(scene.materialTable);
+    PrimitiveArrays &arrays = compiled->primitives;
+
+    MaterialTable materials;
+    TextureTable &textures = materials.textureTable;
+
+    bool success =
+        readSection(file, sections[Nodes], compiled->nodes) &&
+        readSection(file, sections[LeafRefs], compiled->leafRefs) &&
+        readSection(file, sections[UnboundedRefs], compiled->unboundedRefs) &&
+        readSection(file, sections[PrimitiveRefs], arrays.refs) &&
+        readSection(file, sections[SphereCenterX], arrays.spheres.centerX) &&
+        readSection(file, sections[SphereCenterY], arrays.spheres.centerY) &&
+        readSection(file, sections[SphereCenterZ], arrays.spheres.centerZ) &&
+        readSection(file, sections[SphereRadius], arrays.spheres.radius) &&
+        readSection(file, sections[Cubes], arrays.cubes) && readSection(file, sections[Triangles], arrays.triangles) &&
+        readSection(file, sections[Discs], arrays.discs) && readSection(file, sections[Planes], arrays.planes) &&
+        readSection(file, sections[Cylinders], arrays.cylinders) && readSection(file, sections[Cones], arrays.cones) &&
+        readSection(file, sections[Mengers], arrays.mengers) && readSection(file, sections[Sdfs], arrays.sdfs) &&
+        readSection(file, sections[MaterialEntries], materials.entries) &&
+        readSection(file, sections[Mattes], materials.mattes) &&
+        readSection(file, sections[Metals], materials.metals) &&
+        readSection(file, sections[Dielectrics], materials.dielectrics) &&
+        readSection(file, sections[Emitters], materials.emitters) &&
+        readSection(file, sections[TextureEntries], textures.entries) &&
+        readSection(file, sections[SolidTextures], textures.solids) &&
+        readSection(file, sections[CheckerTextures], textures.checkers) &&
+        sections[Rotations].elementSize == sizeOfRotate3();
+
+    // The rotation matrices are owned by the scene's arena.
+    std::vector<Rotate3 *> rotations;
+
+    for (uint64_t i = 0; success && i < sections[Rotations].count; ++i)
+    {
+        void *memory = scene.sceneArena.allocate(sizeOfRotate3(), alignof(std::max_align_t));
+        memcpy(memory, file.data + sections[Rotations].offset + i * sizeOfRotate3(), sizeOfRotate3());
+
+        rotations.push_back((Rotate3 *)memory);
+    }
+
+    success = success && decodeRotations(arrays.cubes, rotations) && decodeRotations(arrays.cylinders, rotations) &&
+              decodeRotations(arrays.cones, rotations);
+
+    // Check the references so that a corrupt cache cannot index out of bounds.
+    for (size_t i = 0; success && i < compiled->leafRefs.size(); ++i)
+    {
+        success = isValidRef(compiled->leafRefs[i], arrays, materials.size());
+    }
+
+    for (size_t i = 0; success && i < compiled->unboundedRefs.size(); ++i)
+    {
+        success = isValidRef(compiled->unboundedRefs[i], arrays, materials.size());
+    }
+
+    for (size_t i = 0; success && i < arrays.mengers.size(); ++i)
+    {
+        success = (arrays.mengers[i].level >= 0 && arrays.mengers[i].level <= MengerSponge::kMaxLevel);
+    }
+
+    for (size_t i = 0; success && i < arrays.sdfs.size(); ++i)
+    {
+        success = (arrays.sdfs[i].estimator >= SdfPrimitive::Sphere &&
+                   arrays.sdfs[i].estimator <= SdfPrimitive::QuaternionJulia);
+    }
+
+    success = success && isValidTree(*compiled) && isValidTable(materials) && isValidTable(textures);
+
+    if (!success)
+    {
+        delete compiled;
+        return false;
+    }
+
+    scene.materialTable = std::move(materials);
+    scene.compiled = compiled;
+    return true;
+}
+
+
+bool SceneCache::isValidTree(const CompiledScene &compiled)
+{
+    const std::vector<CompiledScene::Node> &nodes = compiled.nodes;
+
+    // Children follow their parent so the depths can be found in one pass. The build throws at kMaxDepth.
+    std::vector<int> depths(nodes.size(), 0);
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        const CompiledScene::Node &node = nodes[i];
+
+        if (node.count > 0)
+        {
+            if ((size_t)node.offset + node.count > compiled.leafRefs.size()) return false;
+            continue;
+        }
+
+        if (node.offset <= i || node.offset >= nodes.size() || depths[i] + 1 >= CompiledScene::kMaxDepth) return false;
+
+        depths[i + 1] = std::max(depths[i + 1], depths[i] + 1);
+        depths[node.offset] = std::max(depths[node.offset], depths[i] + 1);
+    }
+
+    return true;
+}
+
+
+bool SceneCache::isValidTable(const MaterialTable &materials)
+{
+    const size_t numTextures = materials.textureTable.size();
+
+    for (const MaterialTable::Entry &entry : materials.entries)
+    {
+        switch (entry.type)
+        {
+            case MaterialType::Matte:
+                if (entry.index >= materials.mattes.size() ||
+                    materials.mattes[entry.index].albedoTexture() >= numTextures)
+                {
+                    return false;
+                }
+                break;
+            case MaterialType::Metal:
+                if (entry.index >= materials.metals.size() ||
+                    materials.metals[entry.index].albedoTexture() >= numTextures)
+                {
+                    return false;
+                }
+                break;
+            case MaterialType::Dielectric:
+                if (entry.index >= materials.dielectrics.size()) return false;
+                break;
+            case MaterialType::Emitter:
+                if (entry.index >= materials.emitters.size()) return false;
+                break;
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool SceneCache::isValidTable(const TextureTable &textures)
+{
+    for (size_t i = 0; i < textures.entries.size(); ++i)
+    {
+        const TextureTable::Entry &entry = textures.entries[i];
+
+        switch (entry.type)
+        {
+            case TextureType::Solid:
+                if (entry.index >= textures.solids.size()) return false;
+                break;
+            case TextureType::Checker:
+                // Checkers may only reference earlier textures (see addChecker) so lookups always terminate.
+                if (entry.index >= textures.checkers.size() || textures.checkers[entry.index].oddTexture() >= i ||
+                    textures.checkers[entry.index].evenTexture() >= i)
+                {
+                    return false;
+                }
+                break;
+            default:
+                // Images are never cached.
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+uint64_t SceneCache::hash(const void *data, size_t size, uint64_t seed)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint64_t result = seed;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        result ^= bytes[i];
+        result *= 1099511628211ULL;
+    }
+
+    return result;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file SceneCache.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "engine/Scene.hpp"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Binary cache of a compiled scene (flattened BVH, primitive arrays and material tables). Each array is stored as a
+ * contiguous section in its in-memory layout so loading maps the file and copies the sections without any parsing.
+ *
+ * A cache is only loaded if its content hash matches (i.e. a hash of the scene description) and it was written by a
+ * build with the same format version, precision and record layouts. Otherwise the caller should rebuild the scene.
+ *
+ * NB: scenes containing generic primitives (e.g. CSG) or image textures cannot be cached since they hold pointers.
+ */
+class SceneCache
+{
+public:
+    SceneCache() = delete;
+
+    /** Writes the compiled scene and its materials. Returns false if the scene cannot be cached or writing fails. */
+    static bool save(const char *path, uint64_t contentHash, Scene &scene);
+
+    /**
+     * Loads a cached scene into an empty scene. Returns false if the file is missing, invalid or stale. On success,
+     * the scene's compiled scene and materials are set from the cache (it has no objects or BVH).
+     */
+    static bool load(const char *path, uint64_t contentHash, Scene &scene);
+
+    /** 64-bit FNV-1a hash. Pass the previous hash as seed to hash several buffers. */
+    static uint64_t hash(const void *data, size_t size, uint64_t seed = kHashSeed);
+
+    static constexpr uint64_t kHashSeed = 14695981039346656037ULL;
+
+    static constexpr uint32_t kVersion = 3;
+
+private:
+    /*
+     * Checks the indices of a loaded cache so that a corrupt file cannot index out of bounds, overflow the traversal
+     * stack or recurse through checker textures forever.
+     */
+    static bool isValidTree(const CompiledScene &compiled);
+    static bool isValidTable(const MaterialTable &materials);
+    static bool isValidTable(const TextureTable &textures);
+};
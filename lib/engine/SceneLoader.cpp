@@ -0,0 +1,682 @@
+/**
+ * @file SceneLoader.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/SceneLoader.hpp"
+#include "engine/SceneCache.hpp"
+#include "engine/primitives/Primitives.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+extern "C"
+{
+#include "logger/Logger.h"
+}
+
+static inline bool isSpace(char c);
+static std::string readFile(const char *path);
+
+
+SceneLoader::SceneLoader(Scene &scene_) : scene(scene_)
+{
+}
+
+
+void SceneLoader::loadFile(const char *path)
+{
+    const std::string text = readFile(path);
+
+    parse(text.data(), text.data() + text.size());
+}
+
+
+bool SceneLoader::loadFile(const char *path, const char *cachePath)
+{
+    const std::string text = readFile(path);
+    const uint64_t contentHash = hashStatements(text.data(), text.data() + text.size());
+
+    if (SceneCache::load(cachePath, contentHash, scene))
+    {
+        parse(text.data(), text.data() + text.size(), true);
+        return true;
+    }
+
+    parse(text.data(), text.data() + text.size());
+
+    // NB: a scene which cannot be cached is still loaded.
+    if (!SceneCache::save(cachePath, contentHash, scene))
+        LogWarning("unable to write scene cache: %s", cachePath);
+
+    return false;
+}
+
+
+void SceneLoader::loadString(std::string_view text)
+{
+    const std::string buffer(text); // NB: null-terminated copy for strtod.
+
+    parse(buffer.data(), buffer.data() + buffer.size());
+}
+
+
+Camera SceneLoader::camera(Real aspectRatio) const
+{
+    if (!hasCamera)
+    {
+        throw std::runtime_error("scene has no camera");
+    }
+
+    const CameraParameters &p = cameraParameters;
+    return Camera(p.verticalFOV, aspectRatio, p.focalLength, p.aperture, p.origin, p.target);
+}
+
+
+void SceneLoader::parse(const char *text, const char *textEnd, bool cameraOnly)
+{
+    lineNumber = 0;
+
+    for (const char *lineStart = text; lineStart < textEnd; lineStart = lineEnd + 1)
+    {
+        lineEnd = (const char *)memchr(lineStart, '\n', textEnd - lineStart);
+        if (!lineEnd) lineEnd = textEnd;
+
+        cursor = lineStart;
+        ++lineNumber;
+
+        std::string_view keyword;
+        if (nextToken(keyword) && (!cameraOnly || keyword == "camera")) parseStatement(keyword);
+    }
+}
+
+
+uint64_t SceneLoader::hashStatements(const char *text, const char *textEnd)
+{
+    uint64_t hash = SceneCache::kHashSeed;
+
+    for (const char *lineStart = text; lineStart < textEnd; lineStart = lineEnd + 1)
+    {
+        lineEnd = (const char *)memchr(lineStart, '\n', textEnd - lineStart);
+        if (!lineEnd) lineEnd = textEnd;
+
+        cursor = lineStart;
+
+        std::string_view keyword;
+        if (!nextToken(keyword) || keyword == "camera") continue;
+
+        // NB: includes the newline so that statements cannot run together.
+        hash = SceneCache::hash(lineStart, lineEnd - lineStart, hash);
+        hash = SceneCache::hash("\n", 1, hash);
+    }
+
+    return hash;
+}
+
+
+void SceneLoader::parseStatement(std::string_view keyword)
+{
+    if (keyword == "camera")
+    {
+        parseCamera();
+    }
+    else if (keyword == "texture")
+    {
+        parseTexture();
+    }
+    else if (keyword == "material")
+    {
+        parseMaterial();
+    }
+    else if (keyword == "csg")
+    {
+        parseCSG();
+    }
+    else if (keyword == "shape")
+    {
+        std::string name(expectToken("shape name"));
+        if (shapeIds.count(name)) error("duplicate shape: " + name);
+
+        Shape shape;
+        std::string_view primitive = expectToken("primitive");
+
+        if (!parseShape(primitive, shape))
+        {
+            error("unknown primitive: " + std::string(primitive));
+        }
+
+        shapeIds.emplace(std::move(name), (uint32_t)shapes.size());
+        shapes.push_back(shape);
+    }
+    else if (keyword == "add")
+    {
+        const uint32_t iShape = findShape(expectToken("shape name"));
+        expectEnd();
+
+        addObject(build(shapes[iShape], vector3(0, 0, 0)));
+    }
+    else if (keyword == "instance")
+    {
+        const uint32_t iShape = findShape(expectToken("shape name"));
+        const Vector3 offset = expectPoint("offset");
+        expectEnd();
+
+        addObject(build(shapes[iShape], offset));
+    }
+    else
+    {
+        Shape shape;
+
+        if (!parseShape(keyword, shape))
+        {
+            error("unknown statement: " + std::string(keyword));
+        }
+
+        addObject(build(shape, vector3(0, 0, 0)));
+    }
+}
+
+
+void SceneLoader::parseCamera()
+{
+    CameraParameters &p = cameraParameters;
+
+    p.verticalFOV = expectReal("vertical field of view");
+    p.focalLength = expectReal("focal length");
+    p.aperture = expectReal("aperture");
+    p.origin = expectPoint("camera position");
+    p.target = expectPoint("camera target");
+    expectEnd();
+
+    hasCamera = true;
+}
+
+
+void SceneLoader::parseTexture()
+{
+    std::string name(expectToken("texture name"));
+    if (textureIds.count(name)) error("duplicate texture: " + name);
+
+    TextureTable &textures = scene.materials().textures();
+
+    std::string_view type = expectToken("texture type");
+    TextureId id;
+
+    if (type == "solid")
+    {
+        id = textures.addSolid(expectPoint("color"));
+    }
+    else if (type == "preset")
+    {
+        std::string_view preset = expectToken("preset color");
+
+        if (preset == "gold")
+            id = textures.addSolid(SolidTexture::Gold);
+        else if (preset == "silver")
+            id = textures.addSolid(SolidTexture::Silver);
+        else if (preset == "grey")
+            id = textures.addSolid(SolidTexture::Grey);
+        else
+            error("unknown preset color: " + std::string(preset));
+    }
+    else if (type == "checker")
+    {
+        const TextureId odd = findTexture(expectToken("odd texture"));
+        const TextureId even = findTexture(expectToken("even texture"));
+
+        id = textures.addChecker(odd, even);
+    }
+    else
+    {
+        error("unknown texture type: " + std::string(type));
+    }
+
+    expectEnd();
+    textureIds.emplace(std::move(name), id);
+}
+
+
+void SceneLoader::parseMaterial()
+{
+    std::string name(expectToken("material name"));
+    if (materialIds.count(name)) error("duplicate material: " + name);
+
+    MaterialTable &materials = scene.materials();
+
+    std::string_view type = expectToken("material type");
+    MaterialId id;
+
+    try
+    {
+        if (type == "matte" || type == "metal")
+        {
+            // The albedo is either a color or the name of a texture.
+            const TextureId albedo =
+                peekReal() ? materials.textures().addSolid(expectPoint("color")) : findTexture(expectToken("texture"));
+
+            if (type == "matte")
+                id = materials.addMatte(albedo);
+            else
+                id = materials.addMetal(albedo, peekReal() ? expectReal("fuzziness") : 0.0);
+        }
+        else if (type == "dielectric")
+        {
+            id = materials.addDielectric(expectReal("index of refraction"));
+        }
+        else if (type == "emitter")
+        {
+            id = materials.addEmitter(expectPoint("color"));
+        }
+        else
+        {
+            error("unknown material type: " + std::string(type));
+        }
+    }
+    catch (const std::length_error &e)
+    {
+        error(e.what());
+    }
+
+    expectEnd();
+    materialIds.emplace(std::move(name), id);
+}
+
+
+void SceneLoader::parseCSG()
+{
+    std::string name(expectToken("shape name"));
+    if (shapeIds.count(name)) error("duplicate shape: " + name);
+
+    Shape shape;
+    shape.type = ShapeType::CSG;
+    shape.material = kNoMaterial;
+
+    std::string_view operation = expectToken("CSG operation");
+
+    if (operation == "union")
+        shape.operation = CSGNode::CSGUnion;
+    else if (operation == "difference")
+        shape.operation = CSGNode::CSGDifference;
+    else if (operation == "intersection")
+        shape.operation = CSGNode::CSGIntersection;
+    else
+        error("unknown CSG operation: " + std::string(operation));
+
+    shape.left = findShape(expectToken("left shape"));
+    shape.right = findShape(expectToken("right shape"));
+    expectEnd();
+
+    shapeIds.emplace(std::move(name), (uint32_t)shapes.size());
+    shapes.push_back(shape);
+}
+
+
+bool SceneLoader::parseShape(std::string_view keyword, Shape &shape)
+{
+    if (keyword == "sphere")
+        shape.type = ShapeType::Sphere;
+    else if (keyword == "cube")
+        shape.type = ShapeType::Cube;
+    else if (keyword == "triangle")
+        shape.type = ShapeType::Triangle;
+    else if (keyword == "disc")
+        shape.type = ShapeType::Disc;
+    else if (keyword == "plane")
+        shape.type = ShapeType::Plane;
+    else if (keyword == "cylinder")
+        shape.type = ShapeType::Cylinder;
+    else if (keyword == "cone")
+        shape.type = ShapeType::Cone;
+    else if (keyword == "menger")
+        shape.type = ShapeType::Menger;
+    else if (keyword == "sdf")
+        shape.type = ShapeType::Sdf;
+    else
+        return false;
+
+    shape.material = findMaterial(expectToken("material"));
+    shape.rotationMatrix = nullptr;
+
+    bool canRotate = false;
+
+    switch (shape.type)
+    {
+        case ShapeType::Sphere:
+            shape.points[0] = expectPoint("center");
+            shape.values[0] = expectPositiveReal("radius");
+            break;
+        case ShapeType::Cube:
+            shape.points[0] = expectPoint("center");
+            shape.values[0] = expectPositiveReal("length");
+            canRotate = true;
+            break;
+        case ShapeType::Triangle:
+            shape.points[0] = expectPoint("vertex");
+            shape.points[1] = expectPoint("vertex");
+            shape.points[2] = expectPoint("vertex");
+            break;
+        case ShapeType::Disc:
+        case ShapeType::Plane:
+        {
+            shape.points[0] = expectPoint("point");
+
+            const Vector3 normal = expectPoint("normal");
+            shape.values[0] = normal.x;
+            shape.values[1] = normal.y;
+            shape.values[2] = normal.z;
+
+            if (shape.type == ShapeType::Disc) shape.values[3] = expectPositiveReal("radius");
+            break;
+        }
+        case ShapeType::Cylinder:
+            shape.points[0] = expectPoint("center");
+            shape.values[0] = expectPositiveReal("radius");
+            shape.values[1] = expectPositiveReal("height");
+            canRotate = true;
+            break;
+        case ShapeType::Cone:
+            shape.points[0] = expectPoint("center");
+            shape.values[0] = expectPositiveReal("height");
+            canRotate = true;
+            break;
+        case ShapeType::Menger:
+        {
+            const int iterations = expectInt("iterations");
+
+            if (iterations < 0 || iterations > MengerSponge::kMaxLevel)
+            {
+                error("invalid Menger sponge iterations: " + std::to_string(iterations));
+            }
+
+            shape.values[0] = iterations;
+            shape.points[0] = expectPoint("center");
+            shape.values[1] = expectPositiveReal("side length");
+            break;
+        }
+        case ShapeType::Sdf:
+        {
+            std::string_view estimator = expectToken("distance estimator");
+
+            if (estimator == "sphere")
+                shape.values[0] = SdfPrimitive::Sphere;
+            else if (estimator == "mandelbulb")
+                shape.values[0] = SdfPrimitive::Mandelbulb;
+            else if (estimator == "julia")
+                shape.values[0] = SdfPrimitive::QuaternionJulia;
+            else
+                error("unknown distance estimator: " + std::string(estimator));
+
+            shape.points[0] = expectPoint("center");
+            shape.values[1] = expectPositiveReal("scale");
+            break;
+        }
+        case ShapeType::CSG:
+            break;
+    }
+
+    if (canRotate && peekReal())
+    {
+        shape.rotationMatrix = scene.arena().makeRotation(expectPoint("rotation"));
+    }
+
+    expectEnd();
+    return true;
+}
+
+
+Primitive *SceneLoader::build(const Shape &shape, Vector3 offset)
+{
+    SceneArena &arena = scene.arena();
+
+    const Point3 p0 = addVectors(shape.points[0], offset);
+    const Real *values = shape.values;
+
+    switch (shape.type)
+    {
+        case ShapeType::Sphere:
+            return arena.make<Sphere>(p0, values[0], shape.material);
+        case ShapeType::Cube:
+            return arena.make<Cube>(p0, shape.rotationMatrix, values[0], shape.material);
+        case ShapeType::Triangle:
+            return arena.make<Triangle>(p0, addVectors(shape.points[1], offset), addVectors(shape.points[2], offset),
+                                        shape.material);
+        case ShapeType::Disc:
+            return arena.make<Disc>(p0, vector3(values[0], values[1], values[2]), values[3], shape.material);
+        case ShapeType::Plane:
+            return arena.make<Plane>(p0, vector3(values[0], values[1], values[2]), shape.material);
+        case ShapeType::Cylinder:
+            return arena.make<Cylinder>(p0, shape.rotationMatrix, values[0], values[1], shape.material);
+        case ShapeType::Cone:
+            return arena.make<Cone>(p0, shape.rotationMatrix, values[0], shape.material);
+        case ShapeType::Menger:
+            return arena.make<MengerSponge>(p0, values[1], (int)values[0], shape.material);
+        case ShapeType::Sdf:
+            return arena.make<SdfPrimitive>((SdfPrimitive::Estimator)values[0], p0, values[1], shape.material);
+        case ShapeType::CSG:
+            return arena.make<CSGNode>(build(shapes[shape.left], offset), build(shapes[shape.right], offset),
+                                       shape.operation);
+    }
+
+    return nullptr;
+}
+
+
+void SceneLoader::addObject(Primitive *object)
+{
+    if (!scene.addObject(object))
+    {
+        error("cannot add objects to a compiled scene");
+    }
+
+    ++objectsAdded;
+}
+
+
+bool SceneLoader::nextToken(std::string_view &token)
+{
+    while (cursor < lineEnd && isSpace(*cursor))
+        ++cursor;
+
+    if (cursor == lineEnd || *cursor == '#') return false;
+
+    const char *start = cursor;
+
+    while (cursor < lineEnd && !isSpace(*cursor) && *cursor != '#')
+        ++cursor;
+
+    token = std::string_view(start, cursor - start);
+    return true;
+}
+
+
+std::string_view SceneLoader::expectToken(const char *what)
+{
+    std::string_view token;
+
+    if (!nextToken(token))
+    {
+        error(std::string("expected ") + what);
+    }
+
+    return token;
+}
+
+
+Real SceneLoader::expectReal(const char *what)
+{
+    while (cursor < lineEnd && isSpace(*cursor))
+        ++cursor;
+
+    if (cursor == lineEnd || *cursor == '#')
+    {
+        error(std::string("expected ") + what);
+    }
+
+    // NB: strtod stops at the end of the line since the text is null-terminated.
+    char *end = nullptr;
+    const Real value = strtod(cursor, &end);
+
+    if (end == cursor || (end < lineEnd && !isSpace(*end) && *end != '#'))
+    {
+        error(std::string("invalid number for ") + what);
+    }
+
+    // NB: strtod accepts "inf" and "nan" and overflows to infinity (also when narrowed to Real).
+    if (!std::isfinite(value))
+    {
+        error(std::string("non-finite number for ") + what);
+    }
+
+    cursor = end;
+    return value;
+}
+
+
+Real SceneLoader::expectPositiveReal(const char *what)
+{
+    const Real value = expectReal(what);
+
+    if (!(value > 0.0))
+    {
+        error(std::string("expected positive ") + what);
+    }
+
+    return value;
+}
+
+
+int SceneLoader::expectInt(const char *what)
+{
+    while (cursor < lineEnd && isSpace(*cursor))
+        ++cursor;
+
+    if (cursor == lineEnd || *cursor == '#')
+    {
+        error(std::string("expected ") + what);
+    }
+
+    char *end = nullptr;
+    errno = 0;
+    const long value = strtol(cursor, &end, 10);
+
+    if (end == cursor || errno == ERANGE || value < INT_MIN || value > INT_MAX ||
+        (end < lineEnd && !isSpace(*end) && *end != '#'))
+    {
+        error(std::string("invalid integer for ") + what);
+    }
+
+    cursor = end;
+    return (int)value;
+}
+
+
+Point3 SceneLoader::expectPoint(const char *what)
+{
+    const Real x = expectReal(what);
+    const Real y = expectReal(what);
+    const Real z = expectReal(what);
+
+    return point3(x, y, z);
+}
+
+
+bool SceneLoader::peekReal() const
+{
+    const char *c = cursor;
+
+    while (c < lineEnd && isSpace(*c))
+        ++c;
+
+    return (c < lineEnd && (isdigit(*c) || *c == '-' || *c == '+' || *c == '.'));
+}
+
+
+void SceneLoader::expectEnd()
+{
+    std::string_view token;
+
+    if (nextToken(token))
+    {
+        error("unexpected token: " + std::string(token));
+    }
+}
+
+
+MaterialId SceneLoader::findMaterial(std::string_view name) const
+{
+    auto it = materialIds.find(std::string(name));
+    if (it == materialIds.end()) error("unknown material: " + std::string(name));
+
+    return it->second;
+}
+
+
+TextureId SceneLoader::findTexture(std::string_view name) const
+{
+    auto it = textureIds.find(std::string(name));
+    if (it == textureIds.end()) error("unknown texture: " + std::string(name));
+
+    return it->second;
+}
+
+
+uint32_t SceneLoader::findShape(std::string_view name) const
+{
+    auto it = shapeIds.find(std::string(name));
+    if (it == shapeIds.end()) error("unknown shape: " + std::string(name));
+
+    return it->second;
+}
+
+
+void SceneLoader::error(const std::string &message) const
+{
+    throw std::runtime_error("line " + std::to_string(lineNumber) + ": " + message);
+}
+
+
+static inline bool isSpace(char c)
+{
+    return (c == ' ' || c == '\t' || c == '\r');
+}
+
+
+static std::string readFile(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+    {
+        throw std::runtime_error(std::string("failed to open ") + path);
+    }
+
+    std::string text;
+    char buffer[65536];
+
+    // NB: read until the end of the file rather than trusting its size (which may change or be unavailable).
+    size_t numRead;
+
+    while ((numRead = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+    {
+        text.append(buffer, numRead);
+    }
+
+    const bool failed = ferror(fp) || !feof(fp);
+    fclose(fp);
+
+    if (failed)
+    {
+        throw std::runtime_error(std::string("failed to read ") + path);
+    }
+
+    return text;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file SceneLoader.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "engine/Camera.hpp"
+#include "engine/Scene.hpp"
+#include "engine/primitives/CSGNode.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Loads a scene from a line-based text file. Each line is one statement, tokens are separated by whitespace and '#'
+ * starts a comment. Names must be defined before they are used. Rotations are angles in degrees about x, y and z.
+ *
+ *   camera <vertical-fov> <focal-length> <aperture> <from x y z> <target x y z>
+ *
+ *   texture <name> solid <r g b>
+ *   texture <name> preset gold|silver|grey
+ *   texture <name> checker <odd-texture> <even-texture>
+ *
+ *   material <name> matte <texture> | <r g b>
+ *   material <name> metal <texture> | <r g b> [<fuzziness>]
+ *   material <name> dielectric <index-of-refraction>
+ *   material <name> emitter <r g b>
+ *
+ *   sphere <material> <center x y z> <radius>
+ *   cube <material> <center x y z> <length> [<rotation x y z>]
+ *   triangle <material> <v0 x y z> <v1 x y z> <v2 x y z>
+ *   disc <material> <point x y z> <normal x y z> <radius>
+ *   plane <material> <point x y z> <normal x y z>
+ *   cylinder <material> <center x y z> <radius> <height> [<rotation x y z>]
+ *   cone <material> <center x y z> <height> [<rotation x y z>]
+ *   menger <material> <iterations 0-12> <center x y z> <side-length>
+ *   sdf <material> sphere|mandelbulb|julia <center x y z> <scale>
+ *
+ * A primitive statement adds the primitive to the scene. Prefixing it with "shape <name>" defines a named shape
+ * instead which can be combined with other shapes and added (or instanced) later:
+ *
+ *   shape <name> <primitive statement>
+ *   csg <name> union|difference|intersection <left-shape> <right-shape>
+ *   add <shape>
+ *   instance <shape> <offset x y z>
+ *
+ * Radii, lengths, heights and scales must be positive.
+ *
+ * NB: an instance is a translated copy of the shape's primitives (the geometry is not shared).
+ */
+class SceneLoader
+{
+public:
+    SceneLoader() = delete;
+    explicit SceneLoader(Scene &scene);
+
+    /** Loads the statements in a scene file. Throws std::runtime_error on failure. */
+    void loadFile(const char *path);
+
+    /**
+     * Loads a scene file using a compiled scene cache (see SceneCache). If the cache matches the file's statements,
+     * only the camera is parsed and the compiled scene is loaded from the cache. Otherwise the file is loaded and the
+     * cache is rewritten (a warning is logged if it cannot be). Camera statements are excluded from the cache's hash.
+     * Returns true if the cache was used.
+     *
+     * NB: numObjects() is zero when the cache is used.
+     */
+    bool loadFile(const char *path, const char *cachePath);
+
+    /** Loads the statements in text. Throws std::runtime_error on failure. */
+    void loadString(std::string_view text);
+
+    /** Returns the scene camera. Throws std::runtime_error if the scene has no camera statement. */
+    Camera camera(Real aspectRatio) const;
+
+    /** Returns the number of objects added to the scene. */
+    size_t numObjects() const
+    {
+        return objectsAdded;
+    }
+
+protected:
+    enum class ShapeType : uint8_t
+    {
+        Sphere,
+        Cube,
+        Triangle,
+        Disc,
+        Plane,
+        Cylinder,
+        Cone,
+        Menger,
+        Sdf,
+        CSG
+    };
+
+    /** Parameters of a primitive (or CSG node) which can be built at any offset. */
+    struct Shape
+    {
+        ShapeType type;
+        MaterialId material;
+
+        /* Points which are translated by the offset (i.e. center, vertices) */
+        Point3 points[3];
+
+        /* Other parameters (radius, length, normal, etc.) in the order they are parsed */
+        Real values[4];
+
+        /* Rotation matrix (nullptr if not rotated) */
+        Rotate3 *rotationMatrix;
+
+        /* CSG only: indices of the left and right shapes */
+        CSGNode::CSGOperation operation;
+        uint32_t left, right;
+    };
+
+    /** Parses the statements (or only the camera statements) in [text, textEnd). NB: requires *textEnd == '\0'. */
+    void parse(const char *text, const char *textEnd, bool cameraOnly = false);
+
+    /** Returns a hash of the statements in [text, textEnd) excluding camera statements. */
+    uint64_t hashStatements(const char *text, const char *textEnd);
+
+    void parseStatement(std::string_view keyword);
+    void parseCamera();
+    void parseTexture();
+    void parseMaterial();
+    void parseCSG();
+
+    /** Parses a primitive statement. Returns false if keyword is not a primitive. */
+    bool parseShape(std::string_view keyword, Shape &shape);
+
+    /** Constructs the primitive for a shape translated by offset. */
+    Primitive *build(const Shape &shape, Vector3 offset);
+
+    void addObject(Primitive *object);
+
+    /* Tokenizer for the current line */
+    bool nextToken(std::string_view &token);
+    std::string_view expectToken(const char *what);
+    Real expectReal(const char *what);
+    Real expectPositiveReal(const char *what);
+    int expectInt(const char *what);
+    Point3 expectPoint(const char *what);
+    bool peekReal() const;
+    void expectEnd();
+
+    MaterialId findMaterial(std::string_view name) const;
+    TextureId findTexture(std::string_view name) const;
+    uint32_t findShape(std::string_view name) const;
+
+    /** Throws a std::runtime_error for the current line. */
+    [[noreturn]] void error(const std::string &message) const;
+
+    Scene &scene;
+
+    std::unordered_map<std::string, TextureId> textureIds;
+    std::unordered_map<std::string, MaterialId> materialIds;
+    std::unordered_map<std::string, uint32_t> shapeIds;
+    std::vector<Shape> shapes;
+
+    struct CameraParameters
+    {
+        Real verticalFOV, focalLength, aperture;
+        Point3 origin, target;
+    };
+
+    CameraParameters cameraParameters;
+    bool hasCamera{false};
+
+    size_t objectsAdded{0};
+
+    /* Current position in the text */
+    const char *cursor{nullptr};
+    const char *lineEnd{nullptr};
+    int lineNumber{0};
+};
@@ -9,15 +9,13 @@
 
 #include "Span.hpp"
 #include <algorithm>
-#include <iostream>
-#include <list>
 
 extern "C"
 {
 #include "utility/Vector3.h"
 }
 
-Span::Span(double tentry, double texit)
+Span::Span(Real tentry, Real texit)
 {
     entry.t = tentry;
     exit.t = texit;
@@ -28,13 +26,13 @@ Span::Span(Hit entry_, Hit exit_) : entry(std::move(entry_)), exit(std::move(exi
 }
 
 
-bool Span::insideInterval(double t, double tolerance) const
+bool Span::insideInterval(Real t, Real tolerance) const
 {
     return (t >= (entry.t + tolerance) && t <= (exit.t - tolerance));
 }
 
 
-bool Span::completeOverlap(const Span &other, double tolerance) const
+bool Span::completeOverlap(const Span &other, Real tolerance) const
 {
     return (fabs(entry.t - other.entry.t) < tolerance && fabs(exit.t - other.exit.t) < tolerance);
 }
@@ -116,171 +114,141 @@ int Span::subtractIntervals(const Span &rhs, std::array<Span, 2> &result) const
 }
 
 
-std::vector<Span> Span::recursiveSpanSubtractor(const Span &lhs, const SpanList::iterator subtractFirst,
-                                                const SpanList::iterator subtractLast)
+int Span::differenceSpanLists(const SpanList &origList, SpanList &otherList, SpanList &result)
 {
+    result.clear();
+
+    SpanList origSorted, otherSorted;
+    const SpanList &lhs = sortedSpanList(origList, origSorted);
+    const SpanList &rhs = sortedSpanList(otherList, otherSorted);
+
     std::array<Span, 2> output;
+    size_t iFirst = 0; // First rhs span which can overlap the current lhs span.
 
-    for (SpanList::iterator iter = subtractFirst; iter != subtractLast; ++iter)
+    for (const Span &lhsSpan : lhs)
     {
-        int n = lhs.subtractIntervals(*iter, output);
-
-        switch (n)
+        // Skip rhs spans which end before this (and every later) lhs span starts.
+        while (iFirst < rhs.size() && rhs[iFirst].exit.t < lhsSpan.entry.t)
         {
-            case 0:
-                return {}; // Empty vector (complete overlap).
-            case 1:
-                return {output[0]};
-                // return recursiveSpanSubtractor(output[0], iter + 1, subtractLast);
-            case 2:
-            {
-                return {output[0], output[1]};
+            ++iFirst;
+        }
 
-                // SpanList leftResult = recursiveSpanSubtractor(output[0], iter + 1, subtractLast);
-                // SpanList rightResult = recursiveSpanSubtractor(output[1], iter + 1, subtractLast);
+        // Subtract each overlapping rhs span in turn from what remains of the lhs span.
+        Span remainder = lhsSpan;
+        bool isRemoved = false;
 
-                // leftResult.insert(leftResult.end(), rightResult.begin(), rightResult.end());
-                // return leftResult;
-            }
-            case (-1): // Continue. No overlap.
-            default:
+        for (size_t i = iFirst; i < rhs.size() && rhs[i].entry.t <= remainder.exit.t; ++i)
+        {
+            const int n = remainder.subtractIntervals(rhs[i], output);
+
+            if (n == 0)
+            {
+                isRemoved = true;
                 break;
+            }
+            else if (n == 1)
+            {
+                remainder = output[0];
+            }
+            else if (n == 2)
+            {
+                result.push_back(output[0]);
+                remainder = output[1];
+            }
+        }
+
+        if (!isRemoved)
+        {
+            result.push_back(remainder);
         }
     }
 
-    // No overlaps.
-    return {lhs};
+    return (result.size());
 }
 
 
-int Span::differenceSpanLists(const SpanList &origList, SpanList &otherList, SpanList &result)
+int Span::unionSpanLists(const SpanList &origList, const SpanList &otherList, SpanList &result)
 {
-    if (origList.empty()) // No result list or nothing to subtract from --> we have nothing.
-    {
-        return 0;
-    }
+    result.clear();
 
-    if (otherList.empty()) // Nothing to subtract --> copy list1.
-    {
-        std::copy(origList.begin(), origList.end(), std::back_inserter(result));
-        return result.size();
-    }
+    SpanList origSorted, otherSorted;
+    const SpanList &first = sortedSpanList(origList, origSorted);
+    const SpanList &second = sortedSpanList(otherList, otherSorted);
 
-    result.clear();
+    // Merge the lists in order of entry and extend the last span while the next span overlaps it.
+    size_t i = 0, j = 0;
 
-    // Keep looping over until we have no more splits.
-    for (auto &lhsSpan : origList)
+    while (i < first.size() || j < second.size())
     {
-        auto subSpans = recursiveSpanSubtractor(lhsSpan, otherList.begin(), otherList.end());
+        const bool takeFirst = (j == second.size() || (i < first.size() && first[i].entry.t <= second[j].entry.t));
+        const Span &next = takeFirst ? first[i++] : second[j++];
 
-        if (subSpans.size())
+        if (!result.empty() && result.back().intervalsOverlap(next))
+        {
+            if (next.exit.t > result.back().exit.t)
+            {
+                result.back().exit = next.exit;
+            }
+        }
+        else
         {
-            result.insert(result.end(), subSpans.begin(), subSpans.end());
+            result.push_back(next);
         }
     }
 
-    // Sort by increasing t-entry.
-    std::sort(result.begin(), result.end(),
-              [](const Span &left, const Span &right) { return left.entry.t < right.entry.t; });
-
-    return (result.size());
+    return result.size();
 }
 
 
-int Span::unionSpanLists(const SpanList &origList, const SpanList &otherList, SpanList &result)
+int Span::intersectionSpanLists(const SpanList &origList, const SpanList &otherList, SpanList &result)
 {
-    // Edge cases.
-    if (origList.empty())
-    {
-        std::copy(otherList.begin(), otherList.end(), std::back_inserter(result));
-        return result.size();
-    }
-    else if (otherList.empty())
-    {
-        std::copy(origList.begin(), origList.end(), std::back_inserter(result));
-        return result.size();
-    }
+    result.clear();
 
-    std::list<Span> spans;
-    std::copy(origList.begin(), origList.end(), std::back_inserter(spans));
-    std::copy(otherList.begin(), otherList.end(), std::back_inserter(spans));
+    SpanList origSorted, otherSorted;
+    const SpanList &first = sortedSpanList(origList, origSorted);
+    const SpanList &second = sortedSpanList(otherList, otherSorted);
 
-    bool eraseIter = false;
+    size_t i = 0, j = 0;
 
-    for (auto iter = spans.begin(); iter != spans.end();)
+    while (i < first.size() && j < second.size())
     {
-        eraseIter = false;
+        const Span &origSpan = first[i];
+        const Span &otherSpan = second[j];
 
-        for (auto iter2 = spans.begin(); iter2 != spans.end();)
+        if (otherSpan.intervalsOverlap(origSpan))
         {
-            if (iter2 != iter && (*iter).intervalsOverlap(*iter2))
-            {
-                Hit &minEntry = (*iter).entry.t < (*iter2).entry.t ? (*iter).entry : (*iter2).entry;
-                Hit &maxExit = (*iter).exit.t > (*iter2).exit.t ? (*iter).exit : (*iter2).exit;
+            // Find the exact overlap:
+            const Hit &entryIntersection = otherSpan.entry.t > origSpan.entry.t ? otherSpan.entry : origSpan.entry;
+            const Hit &exitIntersection = otherSpan.exit.t < origSpan.exit.t ? otherSpan.exit : origSpan.exit;
 
-                spans.push_back(Span(minEntry, maxExit));
-                eraseIter = true;
-                spans.erase(iter2++);
-                break;
-            }
-            else
+            // Ignore any spans we create where both tmin, tmax are less than zero.
+            if (exitIntersection.t > 0.0)
             {
-                iter2++;
+                result.push_back(Span(entryIntersection, exitIntersection));
             }
         }
 
-        if (eraseIter)
-        {
-            spans.erase(iter++);
-        }
+        // The span which exits first cannot overlap any later spans in the other list.
+        if (origSpan.exit.t < otherSpan.exit.t)
+            ++i;
         else
-        {
-            iter++;
-        }
+            ++j;
     }
 
-    result.clear();
-    std::copy(spans.begin(), spans.end(), std::back_inserter(result));
-
-    std::sort(result.begin(), result.end(),
-              [](const Span &left, const Span &right) { return left.entry.t < right.entry.t; });
-
     return result.size();
 }
 
 
-int Span::intersectionSpanLists(const SpanList &origList, const SpanList &otherList, SpanList &result)
+const Span::SpanList &Span::sortedSpanList(const SpanList &spans, SpanList &storage)
 {
-    // Edge cases.
-    if (origList.empty() || otherList.empty())
-    {
-        result.clear();
-        return 0;
-    }
+    auto entryOrder = [](const Span &left, const Span &right) { return left.entry.t < right.entry.t; };
 
-    result.clear();
-
-    for (auto &otherSpan : otherList)
+    if (std::is_sorted(spans.begin(), spans.end(), entryOrder))
     {
-        for (auto &origSpan : origList)
-        {
-            if (otherSpan.intervalsOverlap(origSpan))
-            {
-                // Find the exact overlap:
-                const Hit &entryIntersection = otherSpan.entry.t > origSpan.entry.t ? otherSpan.entry : origSpan.entry;
-                const Hit &exitIntersection = otherSpan.exit.t < origSpan.exit.t ? otherSpan.exit : origSpan.exit;
-
-                // Ignore any spans we create where both tmin, tmax are less than zero.
-                if (exitIntersection.t > 0.0)
-                {
-                    result.push_back(Span(entryIntersection, exitIntersection));
-                }
-            }
-        }
+        return spans;
     }
 
-    std::sort(result.begin(), result.end(),
-              [](const Span &left, const Span &right) { return left.entry.t < right.entry.t; });
-
-    return result.size();
+    storage = spans;
+    std::sort(storage.begin(), storage.end(), entryOrder);
+    return storage;
 }
@@ -22,14 +22,14 @@ struct Span
 
     // Construct a span in range [tentry, texit]. Useful for testing
     Span() = default;
-    Span(double tentry, double texit);
+    Span(Real tentry, Real texit);
     Span(Hit entry, Hit exit);
 
     /** Returns true if time t is inside span */
-    bool insideInterval(double t, double tolerance = 1e-6) const;
+    bool insideInterval(Real t, Real tolerance = 1e-6) const;
 
     /** Returns true on complete overlap */
-    bool completeOverlap(const Span &other, double tolerance = 1e-6) const;
+    bool completeOverlap(const Span &other, Real tolerance = 1e-6) const;
 
     /** Returns true if other span overlaps */
     bool intervalsOverlap(const Span &other) const;
@@ -47,20 +47,21 @@ struct Span
 
     using SpanList = std::vector<Span>;
 
+    /**
+     * The set operations on span lists merge the lists in a single pass in order of entry time so they are O(n + m)
+     * and the result is sorted. They assume no spans overlap within each list. Lists which are not sorted by entry
+     * time are sorted first.
+     */
+
     /** Subtracts otherList spans from origList */
     static int differenceSpanLists(const SpanList &origList, SpanList &otherList, SpanList &result);
 
-    /**
-     * Union operation on two span lists
-     * Assumptions:
-     * - No spans overlap within origList (and otherList)
-     *
-     */
+    /** Union operation on two span lists */
     static int unionSpanLists(const SpanList &origList, const SpanList &otherList, SpanList &result);
 
     static int intersectionSpanLists(const SpanList &origList, const SpanList &otherList, SpanList &result);
 
-    /** Recursive method which returns all subspans */
-    static SpanList recursiveSpanSubtractor(const Span &lhs, const SpanList::iterator subtractFirst,
-                                            const SpanList::iterator subtractLast);
+private:
+    /** Returns spans if it is sorted by entry time. Otherwise sorts a copy in storage and returns it */
+    static const SpanList &sortedSpanList(const SpanList &spans, SpanList &storage);
 };
\ No newline at end of file
@@ -0,0 +1,174 @@
+/**
+ * @file Telemetry.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/Telemetry.hpp"
+#include <sys/resource.h>
+#include <unistd.h>
+
+extern "C"
+{
+#include "threadpool/ThreadPool.h"
+}
+
+
+Telemetry::Telemetry(FILE *stream_, uint64_t totalPixels_, double intervalSeconds_)
+    : stream(stream_), totalPixels(totalPixels_), intervalSeconds(intervalSeconds_)
+{
+}
+
+
+Telemetry::~Telemetry()
+{
+    stop();
+}
+
+
+void Telemetry::start()
+{
+    if (reporter.joinable()) return;
+
+    startTime = lastTime = Clock::now();
+    lastTotals = totals();
+    isStopping = false;
+
+    reporter = std::thread(&Telemetry::report, this);
+}
+
+
+void Telemetry::stop()
+{
+    if (!reporter.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+
+    stopped.notify_one();
+    reporter.join();
+
+    writeLine(true);
+}
+
+
+void Telemetry::addPixel(uint64_t numSamples, uint64_t numRays)
+{
+    const int workerID = currentWorkerID();
+
+    if (workerID <= 0 || workerID >= kMaxThreads)
+    {
+        Counters &shared = counters[0];
+
+        shared.numPixels.fetch_add(1, std::memory_order_relaxed);
+        shared.numSamples.fetch_add(numSamples, std::memory_order_relaxed);
+        shared.numRays.fetch_add(numRays, std::memory_order_relaxed);
+        return;
+    }
+
+    Counters &worker = counters[workerID];
+
+    // NB: only this worker writes its counters so the increments do not need to be atomic.
+    worker.numPixels.store(worker.numPixels.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    worker.numSamples.store(worker.numSamples.load(std::memory_order_relaxed) + numSamples, std::memory_order_relaxed);
+    worker.numRays.store(worker.numRays.load(std::memory_order_relaxed) + numRays, std::memory_order_relaxed);
+}
+
+
+Telemetry::Totals Telemetry::totals() const
+{
+    Totals result;
+
+    for (const Counters &threadCounters : counters)
+    {
+        result.numPixels += threadCounters.numPixels.load(std::memory_order_relaxed);
+        result.numSamples += threadCounters.numSamples.load(std::memory_order_relaxed);
+        result.numRays += threadCounters.numRays.load(std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+
+void Telemetry::report()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    const auto interval = std::chrono::duration<double>(intervalSeconds);
+
+    while (!stopped.wait_for(lock, interval, [this] { return isStopping; }))
+    {
+        // NB: the lock only guards isStopping so it is released while writing.
+        lock.unlock();
+        writeLine(false);
+        lock.lock();
+    }
+}
+
+
+void Telemetry::writeLine(bool isDone)
+{
+    const Clock::time_point now = Clock::now();
+    const Totals current = totals();
+
+    const double elapsed = std::chrono::duration<double>(now - startTime).count();
+    const double intervalElapsed = std::chrono::duration<double>(now - lastTime).count();
+
+    const double percent = totalPixels ? (100.0 * (double)current.numPixels / (double)totalPixels) : 100.0;
+
+    double raysPerSecond = 0.0, samplesPerSecond = 0.0;
+
+    if (intervalElapsed > 0.0)
+    {
+        raysPerSecond = (double)(current.numRays - lastTotals.numRays) / intervalElapsed;
+        samplesPerSecond = (double)(current.numSamples - lastTotals.numSamples) / intervalElapsed;
+    }
+
+    // Remaining pixels at the average rate so far.
+    double eta = 0.0;
+
+    if (current.numPixels > 0 && current.numPixels < totalPixels)
+        eta = elapsed * (double)(totalPixels - current.numPixels) / (double)current.numPixels;
+
+    fprintf(stream,
+            "{\"elapsed_s\":%.2f,\"percent\":%.1f,\"pixels\":%llu,\"samples\":%llu,\"rays\":%llu,"
+            "\"mrays_per_s\":%.3f,\"samples_per_s\":%.0f,\"eta_s\":%.2f,\"rss_mb\":%.1f,\"done\":%s}\n",
+            elapsed, percent, (unsigned long long)current.numPixels, (unsigned long long)current.numSamples,
+            (unsigned long long)current.numRays, 1e-6 * raysPerSecond, samplesPerSecond, eta,
+            (double)residentBytes() / (1024.0 * 1024.0), isDone ? "true" : "false");
+    fflush(stream);
+
+    lastTime = now;
+    lastTotals = current;
+}
+
+
+size_t Telemetry::residentBytes()
+{
+#ifdef __linux__
+    FILE *statm = fopen("/proc/self/statm", "r");
+
+    if (statm)
+    {
+        unsigned long numPages = 0, numResidentPages = 0;
+        const int numRead = fscanf(statm, "%lu %lu", &numPages, &numResidentPages);
+        fclose(statm);
+
+        if (numRead == 2) return (size_t)numResidentPages * (size_t)sysconf(_SC_PAGESIZE);
+    }
+#endif
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss; // Bytes.
+#else
+    return (size_t)usage.ru_maxrss * 1024; // Kilobytes.
+#endif
+}
@@ -0,0 +1,109 @@
+/**
+ * @file Telemetry.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+/**
+ * Progress of a render as a stream of JSON lines which is written by a background reporter thread, e.g.
+ *
+ *   {"elapsed_s":2.00,"percent":41.3,"pixels":3968,"samples":812345,"rays":2456789,"mrays_per_s":1.21,
+ *    "samples_per_s":401234,"eta_s":2.84,"rss_mb":35.2,"done":false}
+ *
+ * The rates are for the interval since the previous line. A final line with "done":true is written when the reporter
+ * stops.
+ *
+ * Each thread pool worker adds to the counters for its worker ID (see addPixel) which are only written by that worker
+ * so there are no locks or read-modify-write atomics on the render path. The IDs are reused by every executeTasks so
+ * the workers of successive passes share the same counters. Other threads (and workers beyond kMaxThreads) share the
+ * first counters which are added to atomically. The reporter samples the counters with relaxed loads.
+ *
+ * NB: this assumes that only one thread pool adds pixels at a time.
+ */
+class Telemetry
+{
+public:
+    Telemetry() = delete;
+
+    /** NB: the stream is not closed. */
+    Telemetry(FILE *stream, uint64_t totalPixels, double intervalSeconds = kDefaultIntervalSeconds);
+
+    /** Stops the reporter if it is running. */
+    ~Telemetry();
+
+    Telemetry(const Telemetry &) = delete;
+    Telemetry &operator=(const Telemetry &) = delete;
+
+    /** Starts the reporter thread. */
+    void start();
+
+    /** Stops the reporter thread after writing the final line. */
+    void stop();
+
+    /** Adds a completed pixel to the calling thread's counters. */
+    void addPixel(uint64_t numSamples, uint64_t numRays);
+
+    /** Totals of the counters. */
+    struct Totals
+    {
+        uint64_t numPixels{0};
+        uint64_t numSamples{0};
+        uint64_t numRays{0};
+    };
+
+    /** Returns the sum of the threads' counters. */
+    Totals totals() const;
+
+    /** Returns the resident memory of the process in bytes (peak resident memory if unavailable). */
+    static size_t residentBytes();
+
+    static constexpr double kDefaultIntervalSeconds = 1.0;
+
+    /* Number of counters. NB: workers with IDs of kMaxThreads or more share the counters of non-worker threads */
+    static constexpr int kMaxThreads = 256;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /* Counters for a thread. NB: each is on its own cache line so that threads do not share lines */
+    struct alignas(64) Counters
+    {
+        std::atomic<uint64_t> numPixels{0};
+        std::atomic<uint64_t> numSamples{0};
+        std::atomic<uint64_t> numRays{0};
+    };
+
+    /** Reporter thread: writes a line each interval until stopped. */
+    void report();
+
+    /** Writes a line for the current totals. */
+    void writeLine(bool isDone);
+
+    FILE *stream;
+    uint64_t totalPixels;
+    double intervalSeconds;
+
+    /* Indexed by worker ID. NB: the first counters are shared by non-worker threads */
+    Counters counters[kMaxThreads];
+
+    Clock::time_point startTime;
+    Clock::time_point lastTime;
+    Totals lastTotals;
+
+    std::thread reporter;
+    std::mutex mutex;
+    std::condition_variable stopped;
+    bool isStopping{false};
+};
@@ -15,23 +15,23 @@ extern "C"
 }
 
 
-DielectricMaterial::DielectricMaterial(double indexOfRefraction_) : indexOfRefraction(indexOfRefraction_)
+DielectricMaterial::DielectricMaterial(Real indexOfRefraction_) : indexOfRefraction(indexOfRefraction_)
 {
 }
 
 
-bool DielectricMaterial::scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation)
+bool DielectricMaterial::scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation) const
 {
     Vector3 unitDirection = unitVector(incidentRay.direction);
 
     // Angle theta is the angle between the normal and incident ray.
-    const double cosTheta = dot(flipVector(unitDirection), hit.normal);
-    const double sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+    const Real cosTheta = dot(flipVector(unitDirection), hit.normal);
+    const Real sinTheta = sqrt(1.0 - cosTheta * cosTheta);
 
     // If it's the front face, we're going into the object otherwise we're leaving
     // and exiting into the air.
-    const double ir = indexOfRefraction;
-    const double refractionRatio =
+    const Real ir = indexOfRefraction;
+    const Real refractionRatio =
         hit.frontFace ? (1.0 / ir) : ir; // TODO: - we can calculate based on incident ray and normal whether this was
                                          // inside or outside object. Don't need this.
 
@@ -45,16 +45,16 @@ bool DielectricMaterial::scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay,
     else
         direction = refract(unitDirection, hit.normal, refractionRatio);
 
-    scatteredRay = Ray(hit.hitPt, direction);
+    scatteredRay = hit.spawnRay(direction);
     attenuation = color3(1.0, 1.0, 1.0);
 
     return true;
 }
 
 
-double DielectricMaterial::reflectance(double cosine, double refractionRatio)
+Real DielectricMaterial::reflectance(Real cosine, Real refractionRatio)
 {
-    double r0 = (1.0 - refractionRatio) / (1.0 + refractionRatio);
+    Real r0 = (1.0 - refractionRatio) / (1.0 + refractionRatio);
 
     r0 = r0 * r0;
 
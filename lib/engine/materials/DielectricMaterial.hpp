@@ -19,17 +19,17 @@ class DielectricMaterial : public Material
 public:
     DielectricMaterial() = delete;
 
-    DielectricMaterial(double indexOfRefraction);
+    DielectricMaterial(Real indexOfRefraction);
 
     /* Refracts an incident ray */
-    bool scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation) override;
+    bool scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation) const;
 
 protected:
-    double indexOfRefraction;
+    Real indexOfRefraction;
 
     /*
      * Schlick's approximation for reflectance. Glass has reflectivity that varies with angle. This is similar to
      * looking at a window at a steep angle---it mostly reflects. This will be when the cosine is small.
      */
-    double reflectance(double cosine, double refractionRatio);
+    static Real reflectance(Real cosine, Real refractionRatio);
 };
\ No newline at end of file
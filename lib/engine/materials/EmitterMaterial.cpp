@@ -14,13 +14,6 @@ EmitterMaterial::EmitterMaterial(Color3 color_) : color(std::move(color_))
 }
 
 
-bool EmitterMaterial::scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation)
-{
-    // Absorb ray:
-    return false;
-}
-
-
 Color3 EmitterMaterial::emitted() const
 {
     return color;
@@ -18,11 +18,8 @@ public:
     EmitterMaterial() = delete;
     EmitterMaterial(Color3 color);
 
-    /* Absorb incident ray (return false since ray totally absorbed) */
-    bool scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation) override;
-
-    /* Returns light-source color */
-    Color3 emitted() const override;
+    /* Returns light-source color. NB: incident rays are totally absorbed (there is no scattered ray) */
+    Color3 emitted() const;
 
 protected:
     /* Light-source color */
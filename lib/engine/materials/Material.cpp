@@ -9,12 +9,6 @@
 
 #include "Material.hpp"
 
-Color3 Material::emitted() const
-{
-    return color3(0, 0, 0);
-}
-
-
 Vector3 Material::reflect(Vector3 v, Vector3 n)
 {
     // Reflected vector: v - 2*(v.n)*n
@@ -22,7 +16,7 @@ Vector3 Material::reflect(Vector3 v, Vector3 n)
 }
 
 
-Vector3 Material::refract(Vector3 vin, Vector3 n, double refractionRatio)
+Vector3 Material::refract(Vector3 vin, Vector3 n, Real refractionRatio)
 {
     Vector3 vinParallel = scaleVector(n, dot(vin, n)); // Parallel to normal component, n.
     Vector3 vinPerpendicular = subtractVectors(vin, vinParallel);
@@ -9,32 +9,41 @@
 
 #pragma once
 #include "engine/Ray.hpp"
+#include <cstdint>
 
 // Forward declaration:
-struct Hit;
+class Hit;
 
 extern "C"
 {
 #include "utility/Vector3.h"
 }
 
+/** Index of a material in a MaterialTable. */
+using MaterialId = uint16_t;
+
+/** Material of primitives which are not shaded directly (i.e. BVH and CSG nodes). */
+static constexpr MaterialId kNoMaterial = UINT16_MAX;
+
+/** Material type tags used to dispatch shading without virtual calls. */
+enum class MaterialType : uint8_t
+{
+    Matte,
+    Metal,
+    Dielectric,
+    Emitter
+};
+
 /**
- * Base material class.
+ * Base material class. Materials are stored by value in a MaterialTable which dispatches on the material type.
  */
 class Material
 {
-public:
-    /* Sets the scatteredRay and attenuation */
-    virtual bool scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation) = 0;
-
-    /* Returns black color (material doesn't emit light). */
-    virtual Color3 emitted() const;
-
 protected:
     /* Protect default constructor to avoid direct initialization */
     Material() = default;
 
-    Vector3 reflect(Vector3 v, Vector3 n);
+    static Vector3 reflect(Vector3 v, Vector3 n);
 
-    Vector3 refract(Vector3 vin, Vector3 n, double refractionRatio);
+    static Vector3 refract(Vector3 vin, Vector3 n, Real refractionRatio);
 };
\ No newline at end of file
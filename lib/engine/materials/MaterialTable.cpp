@@ -0,0 +1,125 @@
+/**
+ * @file MaterialTable.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "MaterialTable.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+
+MaterialId MaterialTable::addEntry(MaterialType type, size_t index)
+{
+    // NB: kNoMaterial is reserved.
+    if (entries.size() >= kNoMaterial)
+    {
+        throw std::length_error("too many materials");
+    }
+
+    entries.push_back({.type = type, .index = (uint16_t)index});
+    return (MaterialId)(entries.size() - 1);
+}
+
+
+MaterialId MaterialTable::addMatte(TextureId albedo)
+{
+    const MaterialId id = addEntry(MaterialType::Matte, mattes.size());
+    mattes.emplace_back(albedo);
+    return id;
+}
+
+
+MaterialId MaterialTable::addMatte(Color3 color)
+{
+    return addMatte(textureTable.addSolid(color));
+}
+
+
+MaterialId MaterialTable::addMetal(TextureId albedo, Real fuzziness)
+{
+    const MaterialId id = addEntry(MaterialType::Metal, metals.size());
+    metals.emplace_back(albedo, fuzziness);
+    return id;
+}
+
+
+MaterialId MaterialTable::addMetal(Color3 color, Real fuzziness)
+{
+    return addMetal(textureTable.addSolid(color), fuzziness);
+}
+
+
+MaterialId MaterialTable::addDielectric(Real indexOfRefraction)
+{
+    const MaterialId id = addEntry(MaterialType::Dielectric, dielectrics.size());
+    dielectrics.emplace_back(indexOfRefraction);
+    return id;
+}
+
+
+MaterialId MaterialTable::addEmitter(Color3 color)
+{
+    const MaterialId id = addEntry(MaterialType::Emitter, emitters.size());
+    emitters.emplace_back(color);
+    return id;
+}
+
+
+bool MaterialTable::scatter(MaterialId id, Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation) const
+{
+    const Entry &entry = entries[id];
+
+    switch (entry.type)
+    {
+        case MaterialType::Matte:
+            return mattes[entry.index].scatter(textureTable, incidentRay, hit, scatteredRay, attenuation);
+        case MaterialType::Metal:
+            return metals[entry.index].scatter(textureTable, incidentRay, hit, scatteredRay, attenuation);
+        case MaterialType::Dielectric:
+            return dielectrics[entry.index].scatter(incidentRay, hit, scatteredRay, attenuation);
+        case MaterialType::Emitter:
+            return false; // Absorb ray.
+    }
+
+    return false;
+}
+
+
+Color3 MaterialTable::emitted(MaterialId id) const
+{
+    const Entry &entry = entries[id];
+
+    if (entry.type == MaterialType::Emitter)
+    {
+        return emitters[entry.index].emitted();
+    }
+
+    return color3(0, 0, 0);
+}
+
+
+Color3 MaterialTable::albedo(MaterialId id, Hit &hit) const
+{
+    const Entry &entry = entries[id];
+
+    switch (entry.type)
+    {
+        case MaterialType::Matte:
+            return textureTable.value(mattes[entry.index].albedoTexture(), hit.u, hit.v, &hit.hitPt);
+        case MaterialType::Metal:
+            return textureTable.value(metals[entry.index].albedoTexture(), hit.u, hit.v, &hit.hitPt);
+        case MaterialType::Dielectric:
+            return color3(1, 1, 1);
+        case MaterialType::Emitter:
+        {
+            const Color3 color = emitters[entry.index].emitted();
+            return color3(std::min<Real>(color.r, 1), std::min<Real>(color.g, 1), std::min<Real>(color.b, 1));
+        }
+    }
+
+    return color3(0, 0, 0);
+}
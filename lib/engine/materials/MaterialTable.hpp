@@ -0,0 +1,91 @@
+/**
+ * @file MaterialTable.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "DielectricMaterial.hpp"
+#include "EmitterMaterial.hpp"
+#include "Material.hpp"
+#include "MatteMaterial.hpp"
+#include "MetalMaterial.hpp"
+#include "engine/Hit.hpp"
+#include "engine/textures/TextureTable.hpp"
+#include <vector>
+
+/**
+ * Flat table of the materials (and their textures) used by a scene. Primitives reference materials by a 16-bit index
+ * (MaterialId). Materials are stored by value in one array per type and shading dispatches on the material type so
+ * hits can be grouped by material or type before they are shaded.
+ */
+class MaterialTable
+{
+public:
+    MaterialId addMatte(TextureId albedo);
+    MaterialId addMatte(Color3 color);
+    MaterialId addMetal(TextureId albedo, Real fuzziness = 0.0);
+    MaterialId addMetal(Color3 color, Real fuzziness = 0.0);
+    MaterialId addDielectric(Real indexOfRefraction);
+    MaterialId addEmitter(Color3 color);
+
+    /** Sets the scatteredRay and attenuation for a hit on material id. Returns false if the ray is absorbed. */
+    bool scatter(MaterialId id, Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation) const;
+
+    /** Returns the color emitted by material id (black unless it is an emitter). */
+    Color3 emitted(MaterialId id) const;
+
+    /**
+     * Returns the surface color of material id at a hit: the texture color for matte and metal materials, white for
+     * dielectrics and the emitted color clamped to [0, 1] for emitters.
+     */
+    Color3 albedo(MaterialId id, Hit &hit) const;
+
+    /** Returns the type of material id. */
+    MaterialType type(MaterialId id) const
+    {
+        return entries.at(id).type;
+    }
+
+    /** Returns the number of materials. */
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+    /** Returns the table of textures referenced by the materials. */
+    TextureTable &textures()
+    {
+        return textureTable;
+    }
+
+    const TextureTable &textures() const
+    {
+        return textureTable;
+    }
+
+protected:
+    friend class SceneCache;
+
+    struct Entry
+    {
+        MaterialType type;
+
+        /* Index in the array for the type */
+        uint16_t index;
+    };
+
+    MaterialId addEntry(MaterialType type, size_t index);
+
+    std::vector<Entry> entries;
+
+    std::vector<MatteMaterial> mattes;
+    std::vector<MetalMaterial> metals;
+    std::vector<DielectricMaterial> dielectrics;
+    std::vector<EmitterMaterial> emitters;
+
+    TextureTable textureTable;
+};
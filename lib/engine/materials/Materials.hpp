@@ -11,5 +11,6 @@
 #include "DielectricMaterial.hpp"
 #include "EmitterMaterial.hpp"
 #include "Material.hpp"
+#include "MaterialTable.hpp"
 #include "MatteMaterial.hpp"
 #include "MetalMaterial.hpp"
\ No newline at end of file
@@ -8,19 +8,14 @@
  */
 
 #include "MatteMaterial.hpp"
-#include "engine/textures/SolidTexture.hpp"
 
-MatteMaterial::MatteMaterial(std::shared_ptr<Texture> albedo_) : albedo(albedo_)
+MatteMaterial::MatteMaterial(TextureId albedo_) : albedo(albedo_)
 {
 }
 
 
-MatteMaterial::MatteMaterial(Color3 color_) : MatteMaterial(std::make_shared<SolidTexture>(color_))
-{
-}
-
-
-bool MatteMaterial::scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation)
+bool MatteMaterial::scatter(const TextureTable &textures, Ray &incidentRay, Hit &hit, Ray &scatteredRay,
+                            Color3 &attenuation) const
 {
     // Compute random scattering direction:
     Vector3 scatterDirection = addVectors(hit.normal, randomUnitVector());
@@ -32,8 +27,8 @@ bool MatteMaterial::scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color
         scatterDirection = hit.normal;
     }
 
-    scatteredRay = Ray(hit.hitPt, scatterDirection);
-    attenuation = albedo->value(hit.u, hit.v, &hit.hitPt);
+    scatteredRay = hit.spawnRay(scatterDirection);
+    attenuation = textures.value(albedo, hit.u, hit.v, &hit.hitPt);
 
     return true;
 }
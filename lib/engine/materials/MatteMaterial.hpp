@@ -10,9 +10,7 @@
 #pragma once
 #include "Material.hpp"
 #include "engine/Hit.hpp"
-#include "engine/textures/Texture.hpp"
-#include "utility/Vector3.h"
-#include <memory>
+#include "engine/textures/TextureTable.hpp"
 
 /**
  * Material class for a matte material ("lambertian").
@@ -21,12 +19,18 @@ class MatteMaterial : public Material
 {
 public:
     MatteMaterial() = delete;
-    MatteMaterial(std::shared_ptr<Texture> albedo);
-    MatteMaterial(Color3 color);
+    MatteMaterial(TextureId albedo);
 
     /* Scatters ray */
-    bool scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation) override;
+    bool scatter(const TextureTable &textures, Ray &incidentRay, Hit &hit, Ray &scatteredRay,
+                 Color3 &attenuation) const;
+
+    /* Returns the albedo texture */
+    TextureId albedoTexture() const
+    {
+        return albedo;
+    }
 
 protected:
-    std::shared_ptr<Texture> albedo{nullptr};
+    TextureId albedo;
 };
\ No newline at end of file
@@ -8,27 +8,20 @@
  */
 
 #include "MetalMaterial.hpp"
-#include "engine/textures/SolidTexture.hpp"
 
 extern "C"
 {
 #include "utility/MathMacros.h"
 }
 
-MetalMaterial::MetalMaterial(std::shared_ptr<Texture> albedo_, double fuzziness_)
-    : albedo(albedo_), fuzziness(fuzziness_)
+MetalMaterial::MetalMaterial(TextureId albedo_, Real fuzziness_) : albedo(albedo_), fuzziness(fuzziness_)
 {
     fuzziness = clamp(fuzziness_, 0, 1);
 }
 
 
-MetalMaterial::MetalMaterial(Color3 color_, double fuzziness_)
-    : MetalMaterial(std::make_shared<SolidTexture>(color_), fuzziness_)
-{
-}
-
-
-bool MetalMaterial::scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation)
+bool MetalMaterial::scatter(const TextureTable &textures, Ray &incidentRay, Hit &hit, Ray &scatteredRay,
+                            Color3 &attenuation) const
 {
     Vector3 reflectDirection = reflect(unitVector(incidentRay.direction), hit.normal);
 
@@ -39,8 +32,8 @@ bool MetalMaterial::scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color
         reflectDirection = addVectors(reflectDirection, changeToVector);
     }
 
-    scatteredRay = Ray(hit.hitPt, reflectDirection);
-    attenuation = albedo->value(hit.u, hit.v, &hit.hitPt);
+    scatteredRay = hit.spawnRay(reflectDirection);
+    attenuation = textures.value(albedo, hit.u, hit.v, &hit.hitPt);
 
     // Make sure that the scattered ray is not scattering into the object:
     return (dot(reflectDirection, hit.normal) > 0.0);
@@ -10,10 +10,7 @@
 #pragma once
 #include "Material.hpp"
 #include "engine/Hit.hpp"
-#include "engine/textures/Texture.hpp"
-#include <memory>
-
-// TODO: - instead of shared pointers for textures, we can store a reference.
+#include "engine/textures/TextureTable.hpp"
 
 /**
  * Class for a metal material (reflective).
@@ -22,13 +19,19 @@ class MetalMaterial : public Material
 {
 public:
     MetalMaterial() = delete;
-    MetalMaterial(std::shared_ptr<Texture> albedo, double fuzziness = 0.0);
-    MetalMaterial(Color3 color, double fuzziness = 0.0);
+    MetalMaterial(TextureId albedo, Real fuzziness = 0.0);
 
     /* Reflects incoming ray */
-    bool scatter(Ray &incidentRay, Hit &hit, Ray &scatteredRay, Color3 &attenuation) override;
+    bool scatter(const TextureTable &textures, Ray &incidentRay, Hit &hit, Ray &scatteredRay,
+                 Color3 &attenuation) const;
+
+    /* Returns the albedo texture */
+    TextureId albedoTexture() const
+    {
+        return albedo;
+    }
 
 protected:
-    std::shared_ptr<Texture> albedo{nullptr};
-    double fuzziness;
+    TextureId albedo;
+    Real fuzziness;
 };
\ No newline at end of file
@@ -8,6 +8,7 @@
  */
 
 #include "BVHNode.hpp"
+#include "PrimitiveArrays.hpp"
 #include <stdexcept>
 
 extern "C"
@@ -21,7 +22,7 @@ int boxComparatorY(const void *ptr1, const void *ptr2);
 int boxComparatorZ(const void *ptr1, const void *ptr2);
 
 
-BVHNode::BVHNode(Primitive **objects, int start, int end) : Primitive(nullptr)
+BVHNode::BVHNode(SceneArena &arena, Primitive **objects, int start, int end) : Primitive(kNoMaterial)
 {
     const int objectSpan = (end - start);
     const int axis = randomInt(0, 2); // TODO: - split about largest axis.
@@ -64,8 +65,8 @@ BVHNode::BVHNode(Primitive **objects, int start, int end) : Primitive(nullptr)
 
         int mid = start + objectSpan / 2;
 
-        left = new BVHNode(objects, start, mid);
-        right = new BVHNode(objects, mid, end);
+        left = arena.make<BVHNode>(arena, objects, start, mid);
+        right = arena.make<BVHNode>(arena, objects, mid, end);
     }
 
     // Calculate the node's bounding box (for objectSpan >= 2):
@@ -80,13 +81,6 @@ BVHNode::BVHNode(Primitive **objects, int start, int end) : Primitive(nullptr)
 }
 
 
-BVHNode::~BVHNode()
-{
-    if (left) delete left;
-    if (right) delete right;
-}
-
-
 bool BVHNode::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
 {
     if (!box.hit(ray, tmin, tmax)) return false;
@@ -104,9 +98,17 @@ bool BVHNode::boundingBox(AABB *outputBox)
     return true;
 }
 
+
+void BVHNode::compile(PrimitiveArrays &arrays)
+{
+    if (left) left->compile(arrays);
+    if (right) right->compile(arrays);
+}
+
+
 int compareBoundingBoxes(AABB *boxA, AABB *boxB, int axis)
 {
-    double minA, minB;
+    Real minA, minB;
 
     if (axis == 0)
     {
@@ -9,20 +9,26 @@
 
 #pragma once
 #include "Primitive.hpp"
+#include "engine/SceneArena.hpp"
 
 class BVHNode : public Primitive
 {
 public:
     BVHNode() = delete;
-    BVHNode(Primitive **objects, int start, int end);
-    ~BVHNode() override;
+    /** Builds the hierarchy for objects [start, end). Interior nodes are allocated from the arena. */
+    BVHNode(SceneArena &arena, Primitive **objects, int start, int end);
 
     bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override;
 
     bool boundingBox(AABB *boundingBox) override;
 
+    /** Flattens the hierarchy. The compiled scene builds its own linear BVH over the leaves. */
+    void compile(PrimitiveArrays &arrays) override;
+
 protected:
     AABB box;
+
+    /* Children (non-owning) */
     Primitive *left{nullptr};
     Primitive *right{nullptr};
 };
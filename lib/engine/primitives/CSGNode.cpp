@@ -19,19 +19,11 @@ extern "C"
 
 
 CSGNode::CSGNode(Primitive *left_, Primitive *right_, CSGOperation operationType_)
-    : Primitive(nullptr), left(left_), right(right_), operationType(operationType_)
+    : Primitive(kNoMaterial), left(left_), right(right_), operationType(operationType_)
 {
 }
 
 
-CSGNode::~CSGNode()
-{
-    /* NB: responsible for calling destructor of left, right primitives (take ownership in the constructor). */
-    if (left) delete left;
-    if (right) delete right;
-}
-
-
 /**
  * Calculate the bounding box for a CSG primitive.
  *
@@ -23,8 +23,8 @@ public:
     };
 
     CSGNode() = delete;
+    /* NB: does not take ownership of left_ and right_ */
     CSGNode(Primitive *left_, Primitive *right_, CSGOperation operationType_);
-    ~CSGNode() override;
 
     bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override;
 
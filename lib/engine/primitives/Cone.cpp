@@ -8,79 +8,205 @@
  */
 
 #include "Cone.hpp"
+#include "PrimitiveArrays.hpp"
+#include <algorithm>
+#include <cmath>
 
-Cone::Cone(Point3 center_, Vector3 rotAngles_, double height_, std::shared_ptr<Material> material_)
-    : Primitive(material_), center(center_), height(height_),
-      base(point3(0, height, 0), vector3(0, 1, 0), height, material), rotationMatrix(makeRotate3(rotAngles_))
+Cone::Cone(Point3 center_, Rotate3 *rotationMatrix_, Real height_, MaterialId material_)
+    : Primitive(material_), center(center_), height(height_), rotationMatrix(rotationMatrix_)
 {
 }
 
 
-Cone::~Cone()
+bool Cone::hit(Ray &ray, Hit &hit, HitType type)
 {
-    if (rotationMatrix)
+    if (!intersect(center, rotationMatrix, height, ray, hit, type)) return false;
+
+    hit.material = material;
+    return true;
+}
+
+
+bool Cone::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    if (!intersect(center, rotationMatrix, height, ray, tmin, tmax, hit)) return false;
+
+    hit.material = material;
+    return true;
+}
+
+
+bool Cone::hit(Ray &ray, Time tmin, Time tmax, Span::SpanList &result)
+{
+    Real tEnter, tExit;
+
+    if (!hitTimes(center, rotationMatrix, height, ray, &tEnter, &tExit)) return false;
+
+    // NB: the span is kept if it overlaps the range (see Primitive::hit).
+    if (tExit <= tmin || tEnter >= tmax) return false;
+
+    Hit entry, exit;
+    setHit(center, rotationMatrix, height, ray, tEnter, entry);
+    setHit(center, rotationMatrix, height, ray, tExit, exit);
+
+    entry.material = exit.material = material;
+
+    result.push_back(Span(entry, exit));
+    return true;
+}
+
+
+bool Cone::intersect(Point3 center, Rotate3 *rotationMatrix, Real height, Ray &ray, Hit &hit, HitType type)
+{
+    Real tEnter, tExit;
+
+    if (!hitTimes(center, rotationMatrix, height, ray, &tEnter, &tExit)) return false;
+
+    setHit(center, rotationMatrix, height, ray, ((type == HitType::Entry) ? tEnter : tExit), hit);
+    return true;
+}
+
+
+bool Cone::intersect(Point3 center, Rotate3 *rotationMatrix, Real height, Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    Real hitTime;
+
+    if (!intersect(center, rotationMatrix, height, ray, tmin, tmax, &hitTime)) return false;
+
+    setHit(center, rotationMatrix, height, ray, hitTime, hit);
+    return true;
+}
+
+
+bool Cone::intersect(Point3 center, Rotate3 *rotationMatrix, Real height, Ray &ray, Time tmin, Time tmax,
+                     Time *hitTime)
+{
+    Real tEnter, tExit;
+
+    if (!hitTimes(center, rotationMatrix, height, ray, &tEnter, &tExit)) return false;
+
+    // Try exit time if the entry is out of range (case: camera could be inside cone).
+    if (Hit::isValid(tEnter, tmin, tmax))
     {
-        free(rotationMatrix);
+        *hitTime = tEnter;
     }
+    else if (Hit::isValid(tExit, tmin, tmax))
+    {
+        *hitTime = tExit;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
 }
 
 
-bool Cone::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
+bool Cone::hitTimes(Point3 center, Rotate3 *rotationMatrix, Real height, Ray &ray, Time *tEnter, Time *tExit)
 {
     Ray tranRay = transformRay(ray, center, rotationMatrix);
     Vector3 tOrigin = tranRay.origin;
     Vector3 tdir = tranRay.direction;
 
-    const double quadA = (tdir.x * tdir.x + tdir.z * tdir.z - tdir.y * tdir.y);
-    const double quadB = 2 * (tOrigin.x * tdir.x + tOrigin.z * tdir.z - tOrigin.y * tdir.y);
-    const double quadC = (tOrigin.x * tOrigin.x + tOrigin.z * tOrigin.z - tOrigin.y * tOrigin.y);
+    // Double cone: x^2 + z^2 - y^2 <= 0. Along the ray this is an interval or (if the ray crosses both halves) the
+    // complement of one.
+    const Real quadA = (tdir.x * tdir.x + tdir.z * tdir.z - tdir.y * tdir.y);
+    const Real halfB = (tOrigin.x * tdir.x + tOrigin.z * tdir.z - tOrigin.y * tdir.y);
+    const Real quadC = (tOrigin.x * tOrigin.x + tOrigin.z * tOrigin.z - tOrigin.y * tOrigin.y);
 
-    double t1, t2;
+    Real coneEnter[2] = {-INFINITY, -INFINITY}, coneExit[2] = {INFINITY, INFINITY};
+    int numIntervals = 1;
 
-    if (!solveQuadratic(quadA, quadB, quadC, &t1, &t2)) return false;
+    const Real discriminant = halfB * halfB - quadA * quadC;
 
-    double hitTime = tmax; // Initialize to maximum time.
-    Point3 hitPoint = {0};
-    Vector3 outwardNormal = {0};
+    if (quadA > 0.0)
+    {
+        if (discriminant < 0.0) return false;
 
-    // Check for intersection with cone side:
-    const bool t1Valid = Hit::isValid(t1, tmin, tmax);
-    const bool t2Valid = Hit::isValid(t2, tmin, tmax);
+        const Real sqrtDiscriminant = sqrt(discriminant);
 
-    double minY = 0, maxY = height;
+        coneEnter[0] = (-halfB - sqrtDiscriminant) / quadA;
+        coneExit[0] = (-halfB + sqrtDiscriminant) / quadA;
+    }
+    else if (quadA < 0.0)
+    {
+        // NB: if there are no roots, the whole ray is inside (i.e. along the axis).
+        if (discriminant >= 0.0)
+        {
+            const Real sqrtDiscriminant = sqrt(discriminant);
 
-    if (t1Valid || t2Valid)
+            coneExit[0] = (-halfB + sqrtDiscriminant) / quadA;
+            coneEnter[1] = (-halfB - sqrtDiscriminant) / quadA;
+            numIntervals = 2;
+        }
+    }
+    else if (halfB != 0.0)
     {
-        Point3 hitPt1 = tranRay.pointAtTime(t1);
-        Point3 hitPt2 = tranRay.pointAtTime(t2);
+        // Parallel to the side: 2 * halfB * t + quadC <= 0.
+        const Real t = -quadC / (2.0 * halfB);
 
-        const bool hitPt1Valid = (hitPt1.y > minY && hitPt1.y < maxY);
-        const bool hitPt2Valid = (hitPt2.y > minY && hitPt2.y < maxY);
+        if (halfB > 0.0)
+            coneExit[0] = t;
+        else
+            coneEnter[0] = t;
+    }
+    else if (quadC > 0.0)
+    {
+        return false;
+    }
 
-        if (t1Valid && hitPt1Valid)
-        {
-            hitTime = t1;
-            outwardNormal = unitVector(vector3(hitPt1.x, -hitPt1.y, hitPt1.z));
-        }
-        else if (t2Valid && hitPt2Valid)
-        {
-            hitTime = t2;
-            outwardNormal = unitVector(vector3(hitPt2.x, -hitPt2.y, hitPt2.z));
-        }
+    // Base and apex: 0 <= y <= height.
+    Real slabEnter = -INFINITY, slabExit = INFINITY;
+
+    if (tdir.y != 0.0)
+    {
+        const Real divY = 1.0 / tdir.y;
+
+        slabEnter = (0.0 - tOrigin.y) * divY;
+        slabExit = (height - tOrigin.y) * divY;
+
+        if (slabEnter > slabExit) std::swap(slabEnter, slabExit);
+    }
+    else if (tOrigin.y < 0.0 || tOrigin.y > height)
+    {
+        return false;
     }
 
-    // Check for a closer intersection from hitting the base of the cone:
-    if (base.hit(tranRay, tmin, hitTime, hit))
+    // The slab only contains the upper half of the double cone (the lower half touches it at the apex).
+    for (int i = 0; i < numIntervals; ++i)
     {
-        hitTime = hit.t;
-        outwardNormal = hit.normal;
+        *tEnter = std::max(coneEnter[i], slabEnter);
+        *tExit = std::min(coneExit[i], slabExit);
+
+        if (*tEnter < *tExit) return true;
     }
 
-    // No intersections --> return false;
-    if (hitTime == tmax) return false;
+    return false;
+}
+
+
+void Cone::setHit(Point3 center, Rotate3 *rotationMatrix, Real height, Ray &ray, Time hitTime, Hit &hit)
+{
+    Point3 hitPoint = ray.pointAtTime(hitTime);
+
+    // The hit is on the base if it is closer to the base than the side. This works for both entry and exit hits.
+    Point3 localPoint = inverseRotation(subtractVectors(hitPoint, center), rotationMatrix);
+
+    const Real radialDistance = sqrt(localPoint.x * localPoint.x + localPoint.z * localPoint.z);
+    const Real baseDistance = fabs(height - localPoint.y);
+    const Real sideDistance = fabs(radialDistance - localPoint.y) * M_SQRT1_2;
 
-    // Calculate the hit point in original coordinates and rotate normal:
-    hitPoint = ray.pointAtTime(hitTime);
+    Vector3 outwardNormal;
+
+    if (baseDistance < sideDistance)
+        outwardNormal = vector3(0, 1, 0);
+    else if (radialDistance > 0.0)
+        outwardNormal = unitVector(vector3(localPoint.x, -localPoint.y, localPoint.z));
+    else
+        outwardNormal = vector3(0, -1, 0); // Apex.
+
+    // Rotate the outward normal back to the original coordinates.
     outwardNormal = rotation(outwardNormal, rotationMatrix);
 
     const bool frontFace = (dot(ray.direction, outwardNormal) < 0.0);
@@ -89,12 +215,9 @@ bool Cone::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
     hit.t = hitTime;
     hit.hitPt = hitPoint;
     hit.normal = frontFace ? outwardNormal : flipVector(outwardNormal);
-    hit.material = material.get();
 
     hit.u = 0.0;
     hit.v = 0.0;
-
-    return true;
 }
 
 
@@ -132,3 +255,12 @@ bool Cone::boundingBox(AABB *outputBox)
 
     return true;
 }
+
+
+void Cone::compile(PrimitiveArrays &arrays)
+{
+    AABB box;
+    boundingBox(&box);
+
+    arrays.addCone(center, rotationMatrix, height, material, box);
+}
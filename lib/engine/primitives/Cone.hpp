@@ -8,7 +8,6 @@
  */
 
 #pragma once
-#include "Disc.hpp"
 #include "Primitive.hpp"
 
 extern "C"
@@ -21,16 +20,42 @@ class Cone : public Primitive
 {
 public:
     Cone() = delete;
-    Cone(Point3 center_, Vector3 rotAngles_, double height_, std::shared_ptr<Material> material_);
-    ~Cone() override;
+    /* NB: rotationMatrix_ is optional (nullptr) and is not owned. See SceneArena::makeRotation */
+    Cone(Point3 center_, Rotate3 *rotationMatrix_, Real height_, MaterialId material_);
+
+    using Primitive::hit;
+
+    /* Returns the entry or exit hit time. NB: this allows the cone to be used in CSG */
+    bool hit(Ray &ray, Hit &hit, HitType type) override;
 
     bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override;
 
+    /* Returns the span from the entry to the exit hit in one pass. NB: this is the query for CSG operands */
+    bool hit(Ray &ray, Time tmin, Time tmax, Span::SpanList &result) override;
+
     bool boundingBox(AABB *boundingBox) override;
 
+    void compile(PrimitiveArrays &arrays) override;
+
+    /* Intersection kernels shared with the compiled scene. NB: these do not set hit.material */
+    static bool intersect(Point3 center, Rotate3 *rotationMatrix, Real height, Ray &ray, Hit &hit, HitType type);
+    static bool intersect(Point3 center, Rotate3 *rotationMatrix, Real height, Ray &ray, Time tmin, Time tmax,
+                          Hit &hit);
+    static bool intersect(Point3 center, Rotate3 *rotationMatrix, Real height, Ray &ray, Time tmin, Time tmax,
+                          Time *hitTime);
+
+    /*
+     * Returns the entry and exit times (which may be outside of the ray's range) including the base. The solid is the
+     * intersection of the double cone x^2 + z^2 <= y^2 and the slab 0 <= y <= height which only contains its upper
+     * half.
+     */
+    static bool hitTimes(Point3 center, Rotate3 *rotationMatrix, Real height, Ray &ray, Time *tEnter, Time *tExit);
+
+    /* Populates the hit (except the material) for a known hit time on the side or the base */
+    static void setHit(Point3 center, Rotate3 *rotationMatrix, Real height, Ray &ray, Time hitTime, Hit &hit);
+
 protected:
     Point3 center;
-    double height;
-    Disc base;
+    Real height;
     Rotate3 *rotationMatrix;
 };
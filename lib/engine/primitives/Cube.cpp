@@ -8,6 +8,7 @@
  */
 
 #include "Cube.hpp"
+#include "PrimitiveArrays.hpp"
 
 extern "C"
 {
@@ -15,24 +16,80 @@ extern "C"
 }
 
 
-Cube::Cube(Point3 center_, Vector3 rotAngles_, double length_, std::shared_ptr<Material> material_)
-    : Primitive(material_), center(center_), length(length_)
+Cube::Cube(Point3 center_, Rotate3 *rotationMatrix_, Real length_, MaterialId material_)
+    : Primitive(material_), center(center_), rotationMatrix(rotationMatrix_), length(length_)
 {
-    rotationMatrix = makeRotate3(rotAngles_);
 }
 
-Cube::~Cube()
+
+bool Cube::hit(Ray &ray, Hit &hit, HitType type)
 {
-    if (rotationMatrix)
+    if (!intersect(center, rotationMatrix, length, ray, hit, type)) return false;
+
+    hit.material = material;
+    return true;
+}
+
+
+bool Cube::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    if (!intersect(center, rotationMatrix, length, ray, tmin, tmax, hit)) return false;
+
+    hit.material = material;
+    return true;
+}
+
+
+bool Cube::intersect(Point3 center, Rotate3 *rotationMatrix, Real length, Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    Real hitTime;
+
+    if (!intersect(center, rotationMatrix, length, ray, tmin, tmax, &hitTime)) return false;
+
+    setHit(center, rotationMatrix, ray, hitTime, hit);
+    return true;
+}
+
+
+bool Cube::intersect(Point3 center, Rotate3 *rotationMatrix, Real length, Ray &ray, Time tmin, Time tmax,
+                     Time *hitTime)
+{
+    Real tEnter, tExit;
+
+    if (!hitTimes(center, rotationMatrix, length, ray, &tEnter, &tExit)) return false;
+
+    // Try exit time if the entry is out of range (case: camera could be inside cube).
+    if (Hit::isValid(tEnter, tmin, tmax))
+    {
+        *hitTime = tEnter;
+    }
+    else if (Hit::isValid(tExit, tmin, tmax))
     {
-        free(rotationMatrix);
+        *hitTime = tExit;
     }
+    else
+    {
+        return false;
+    }
+
+    return true;
 }
 
 
-bool Cube::hit(Ray &ray, Hit &hit, HitType type)
+bool Cube::intersect(Point3 center, Rotate3 *rotationMatrix, Real length, Ray &ray, Hit &hit, HitType type)
+{
+    Real tEnter, tExit;
+
+    if (!hitTimes(center, rotationMatrix, length, ray, &tEnter, &tExit)) return false;
+
+    setHit(center, rotationMatrix, ray, ((type == HitType::Entry) ? tEnter : tExit), hit);
+    return true;
+}
+
+
+bool Cube::hitTimes(Point3 center, Rotate3 *rotationMatrix, Real length, Ray &ray, Time *tEnter, Time *tExit)
 {
-    const double halfLength = 0.5 * length;
+    const Real halfLength = 0.5 * length;
 
     // Transform ray and shift it so that cube is at the origin and oriented
     // along the y-axis.
@@ -40,22 +97,21 @@ bool Cube::hit(Ray &ray, Hit &hit, HitType type)
     Point3 tOrigin = tranRay.origin;
     Vector3 tDir = tranRay.direction;
 
-    double tEnter, tExit;
-    const double divX = 1.0 / tDir.x;
+    const Real divX = 1.0 / tDir.x;
 
     if (divX >= 0)
     {
-        tEnter = (-halfLength - tOrigin.x) * divX;
-        tExit = (+halfLength - tOrigin.x) * divX;
+        *tEnter = (-halfLength - tOrigin.x) * divX;
+        *tExit = (+halfLength - tOrigin.x) * divX;
     }
     else
     {
-        tExit = (-halfLength - tOrigin.x) * divX;
-        tEnter = (+halfLength - tOrigin.x) * divX;
+        *tExit = (-halfLength - tOrigin.x) * divX;
+        *tEnter = (+halfLength - tOrigin.x) * divX;
     }
 
-    double tyEnter, tyExit;
-    const double divY = 1.0 / tDir.y;
+    Real tyEnter, tyExit;
+    const Real divY = 1.0 / tDir.y;
 
     if (divY >= 0)
     {
@@ -68,13 +124,13 @@ bool Cube::hit(Ray &ray, Hit &hit, HitType type)
         tyEnter = (+halfLength - tOrigin.y) * divY;
     }
 
-    tEnter = max(tEnter, tyEnter);
-    tExit = min(tExit, tyExit);
+    *tEnter = max(*tEnter, tyEnter);
+    *tExit = min(*tExit, tyExit);
 
-    if (tExit < tEnter) return false; // No intersection.
+    if (*tExit < *tEnter) return false; // No intersection.
 
-    double tzEnter, tzExit;
-    const double divZ = 1.0 / tDir.z;
+    Real tzEnter, tzExit;
+    const Real divZ = 1.0 / tDir.z;
 
     if (divZ >= 0)
     {
@@ -87,25 +143,32 @@ bool Cube::hit(Ray &ray, Hit &hit, HitType type)
         tzEnter = (+halfLength - tOrigin.z) * divZ;
     }
 
-    tEnter = max(tEnter, tzEnter);
-    tExit = min(tExit, tzExit);
+    *tEnter = max(*tEnter, tzEnter);
+    *tExit = min(*tExit, tzExit);
 
-    if (tExit < tEnter) return false;
+    return (*tEnter <= *tExit);
+}
+
+
+void Cube::setHit(Point3 center, Rotate3 *rotationMatrix, Ray &ray, Time hitTime, Hit &hit)
+{
+    Point3 hitPoint = ray.pointAtTime(hitTime);
+
+    // The face hit is the one whose axis has the largest coordinate in the cube's frame. This works for both entry
+    // and exit hits.
+    Point3 localPoint = inverseRotation(subtractVectors(hitPoint, center), rotationMatrix);
 
-    const double hitTime = ((type == HitType::Entry) ? tEnter : tExit);
+    const Real absX = fabs(localPoint.x), absY = fabs(localPoint.y), absZ = fabs(localPoint.z);
     Vector3 outwardNormal;
 
-    // The hit will occur at time tmin. Now calculate which face it intersects.
-    if (tyEnter == hitTime)
-        outwardNormal = vector3(0, (divY >= 0 ? -1 : 1), 0);
-    else if (tzEnter == hitTime)
-        outwardNormal = vector3(0, 0, (divZ >= 0 ? -1 : 1));
+    if (absY >= absX && absY >= absZ)
+        outwardNormal = vector3(0, (localPoint.y < 0 ? -1 : 1), 0);
+    else if (absZ >= absX)
+        outwardNormal = vector3(0, 0, (localPoint.z < 0 ? -1 : 1));
     else
-        outwardNormal = vector3((divX >= 0 ? -1 : 1), 0, 0);
+        outwardNormal = vector3((localPoint.x < 0 ? -1 : 1), 0, 0);
 
-    // Calculate the hit point and outward normal in original coordinates
-    // (rotate back to original). hitTime is correct in both coordinates.
-    Vector3 hitPoint = ray.pointAtTime(hitTime);
+    // Rotate the outward normal back to the original coordinates.
     outwardNormal = rotation(outwardNormal, rotationMatrix);
 
     const bool frontFace = (dot(ray.direction, outwardNormal) < 0.0);
@@ -114,18 +177,15 @@ bool Cube::hit(Ray &ray, Hit &hit, HitType type)
     hit.t = hitTime;
     hit.hitPt = hitPoint;
     hit.normal = frontFace ? outwardNormal : flipVector(outwardNormal);
-    hit.material = material.get();
 
     hit.u = 0.0;
     hit.v = 0.0;
-
-    return true;
 }
 
 
 bool Cube::boundingBox(AABB *outputBox)
 {
-    const double halfL = 0.5 * length;
+    const Real halfL = 0.5 * length;
 
     if (!rotationMatrix)
     {
@@ -159,3 +219,12 @@ bool Cube::boundingBox(AABB *outputBox)
 
     return true;
 }
+
+
+void Cube::compile(PrimitiveArrays &arrays)
+{
+    AABB box;
+    boundingBox(&box);
+
+    arrays.addCube(center, rotationMatrix, length, material, box);
+}
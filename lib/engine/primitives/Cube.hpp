@@ -21,15 +21,34 @@ class Cube : public Primitive
 {
 public:
     Cube() = delete;
-    Cube(Point3 center_, Vector3 rotAngles_, double length_, std::shared_ptr<Material> material_);
-    ~Cube() override;
+    /* NB: rotationMatrix_ is optional (nullptr) and is not owned. See SceneArena::makeRotation */
+    Cube(Point3 center_, Rotate3 *rotationMatrix_, Real length_, MaterialId material_);
+
+    using Primitive::hit;
 
     bool hit(Ray &ray, Hit &hit, HitType type) override;
 
+    bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override;
+
     bool boundingBox(AABB *boundingBox) override;
 
+    void compile(PrimitiveArrays &arrays) override;
+
+    /* Intersection kernels shared with the compiled scene. NB: these do not set hit.material */
+    static bool intersect(Point3 center, Rotate3 *rotationMatrix, Real length, Ray &ray, Hit &hit, HitType type);
+    static bool intersect(Point3 center, Rotate3 *rotationMatrix, Real length, Ray &ray, Time tmin, Time tmax,
+                          Hit &hit);
+    static bool intersect(Point3 center, Rotate3 *rotationMatrix, Real length, Ray &ray, Time tmin, Time tmax,
+                          Time *hitTime);
+
+    /* Returns the entry and exit times (which may be outside of the ray's range) */
+    static bool hitTimes(Point3 center, Rotate3 *rotationMatrix, Real length, Ray &ray, Time *tEnter, Time *tExit);
+
+    /* Populates the hit (except the material) for a known hit time */
+    static void setHit(Point3 center, Rotate3 *rotationMatrix, Ray &ray, Time hitTime, Hit &hit);
+
 protected:
     Point3 center;
     Rotate3 *rotationMatrix;
-    double length;
+    Real length;
 };
\ No newline at end of file
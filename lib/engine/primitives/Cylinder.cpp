@@ -8,30 +8,106 @@
  */
 
 #include "Cylinder.hpp"
+#include "PrimitiveArrays.hpp"
+#include <algorithm>
+#include <cmath>
 
-Cylinder::Cylinder(Point3 center_, Vector3 rotAngles_, double radius_, double height_,
-                   std::shared_ptr<Material> material_)
-    : Primitive(material_), center(center_), radius(radius_), height(height_),
-      topCap(point3(0, height / 2.0, 0), vector3(0, 1, 0), radius, material),
-      bottomCap(point3(0, -height / 2.0, 0), vector3(0, -1, 0), radius, material),
-      rotationMatrix(makeRotate3(rotAngles_))
+Cylinder::Cylinder(Point3 center_, Rotate3 *rotationMatrix_, Real radius_, Real height_, MaterialId material_)
+    : Primitive(material_), center(center_), rotationMatrix(rotationMatrix_), radius(radius_), height(height_)
 {
 }
 
-Cylinder::~Cylinder()
+
+bool Cylinder::hit(Ray &ray, Hit &hit, HitType type)
 {
-    if (rotationMatrix)
-    {
-        free(rotationMatrix);
-    }
+    if (!intersect(center, rotationMatrix, radius, height, ray, hit, type)) return false;
+
+    hit.material = material;
+    return true;
 }
 
 
 bool Cylinder::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
 {
-    const double ymin = -height / 2.0;
-    const double ymax = height / 2.0;
+    if (!intersect(center, rotationMatrix, radius, height, ray, tmin, tmax, hit)) return false;
+
+    hit.material = material;
+    return true;
+}
+
+
+bool Cylinder::hit(Ray &ray, Time tmin, Time tmax, Span::SpanList &result)
+{
+    Real tEnter, tExit;
+
+    if (!hitTimes(center, rotationMatrix, radius, height, ray, &tEnter, &tExit)) return false;
+
+    // NB: the span is kept if it overlaps the range (see Primitive::hit).
+    if (tExit <= tmin || tEnter >= tmax) return false;
+
+    Hit entry, exit;
+    setHit(center, rotationMatrix, radius, height, ray, tEnter, entry);
+    setHit(center, rotationMatrix, radius, height, ray, tExit, exit);
+
+    entry.material = exit.material = material;
 
+    result.push_back(Span(entry, exit));
+    return true;
+}
+
+
+bool Cylinder::intersect(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Ray &ray, Hit &hit,
+                         HitType type)
+{
+    Real tEnter, tExit;
+
+    if (!hitTimes(center, rotationMatrix, radius, height, ray, &tEnter, &tExit)) return false;
+
+    setHit(center, rotationMatrix, radius, height, ray, ((type == HitType::Entry) ? tEnter : tExit), hit);
+    return true;
+}
+
+
+bool Cylinder::intersect(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Ray &ray, Time tmin,
+                         Time tmax, Hit &hit)
+{
+    Real hitTime;
+
+    if (!intersect(center, rotationMatrix, radius, height, ray, tmin, tmax, &hitTime)) return false;
+
+    setHit(center, rotationMatrix, radius, height, ray, hitTime, hit);
+    return true;
+}
+
+
+bool Cylinder::intersect(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Ray &ray, Time tmin,
+                         Time tmax, Time *hitTime)
+{
+    Real tEnter, tExit;
+
+    if (!hitTimes(center, rotationMatrix, radius, height, ray, &tEnter, &tExit)) return false;
+
+    // Try exit time if the entry is out of range (case: camera could be inside cylinder).
+    if (Hit::isValid(tEnter, tmin, tmax))
+    {
+        *hitTime = tEnter;
+    }
+    else if (Hit::isValid(tExit, tmin, tmax))
+    {
+        *hitTime = tExit;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+bool Cylinder::hitTimes(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Ray &ray, Time *tEnter,
+                        Time *tExit)
+{
     // Transform the ray by rotating and shifting it so that the cylinder is
     // centered at the origin. In this rotated space, the cylinder is oriented
     // along the y-axis.
@@ -39,61 +115,74 @@ bool Cylinder::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
     Point3 tOrigin = tranRay.origin;
     Vector3 tDir = tranRay.direction;
 
-    // Solve:
-    const double quadA = tDir.x * tDir.x + tDir.z * tDir.z;
-    const double quadB = 2.0 * (tDir.x * tOrigin.x + tDir.z * tOrigin.z);
-    const double quadC = (tOrigin.x * tOrigin.x + tOrigin.z * tOrigin.z) - (radius * radius);
+    // Side: x^2 + z^2 <= radius^2.
+    const Real quadA = tDir.x * tDir.x + tDir.z * tDir.z;
+    const Real halfB = tDir.x * tOrigin.x + tDir.z * tOrigin.z;
+    const Real quadC = (tOrigin.x * tOrigin.x + tOrigin.z * tOrigin.z) - (radius * radius);
 
-    double t1, t2;
+    Real sideEnter = -INFINITY, sideExit = INFINITY;
 
-    if (!solveQuadratic(quadA, quadB, quadC, &t1, &t2)) return false;
-
-    const bool t1Valid = Hit::isValid(t1, tmin, tmax);
-    const bool t2Valid = Hit::isValid(t2, tmin, tmax);
+    if (quadA > 0.0)
+    {
+        const Real discriminant = halfB * halfB - quadA * quadC;
+        if (discriminant < 0.0) return false;
 
-    double hitTime = tmax; // Set to tmax initially.
-    Point3 hitPoint = {0};
-    Vector3 outwardNormal = {0};
+        const Real sqrtDiscriminant = sqrt(discriminant);
 
-    // Check for intersections with side of cylinder:
-    if (t1Valid || t2Valid)
+        sideEnter = (-halfB - sqrtDiscriminant) / quadA;
+        sideExit = (-halfB + sqrtDiscriminant) / quadA;
+    }
+    else if (quadC > 0.0)
     {
-        Point3 hitPt1 = tranRay.pointAtTime(t1);
-        Point3 hitPt2 = tranRay.pointAtTime(t2);
+        return false; // Parallel to the axis outside of the cylinder.
+    }
 
-        const bool hitPt1Valid = (hitPt1.y > ymin && hitPt1.y < ymax);
-        const bool hitPt2Valid = (hitPt2.y > ymin && hitPt2.y < ymax);
+    // Caps: -height / 2 <= y <= height / 2.
+    const Real halfHeight = 0.5 * height;
 
-        if (t1Valid && hitPt1Valid)
-        {
-            hitTime = t1;
-            outwardNormal = unitVector(vector3(hitPt1.x, 0, hitPt1.z));
-        }
-        else if (t2Valid && hitPt2Valid)
-        {
-            hitTime = t2;
-            outwardNormal = unitVector(vector3(hitPt2.x, 0, hitPt2.z));
-        }
-    }
+    Real capEnter = -INFINITY, capExit = INFINITY;
 
-    // Check for closer intersection with bottom or top cap:
-    if (topCap.hit(tranRay, tmin, hitTime, hit))
+    if (tDir.y != 0.0)
     {
-        hitTime = hit.t;
-        outwardNormal = hit.normal;
+        const Real divY = 1.0 / tDir.y;
+
+        capEnter = (-halfHeight - tOrigin.y) * divY;
+        capExit = (+halfHeight - tOrigin.y) * divY;
+
+        if (capEnter > capExit) std::swap(capEnter, capExit);
     }
-    else if (bottomCap.hit(tranRay, tmin, hitTime, hit))
+    else if (fabs(tOrigin.y) > halfHeight)
     {
-        hitTime = hit.t;
-        outwardNormal = hit.normal;
+        return false; // Parallel to the caps above or below the cylinder.
     }
 
-    // Check for any hits:
-    if (hitTime == tmax) return false;
+    *tEnter = std::max(sideEnter, capEnter);
+    *tExit = std::min(sideExit, capExit);
+
+    return (*tEnter <= *tExit);
+}
+
+
+void Cylinder::setHit(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Ray &ray, Time hitTime,
+                      Hit &hit)
+{
+    Point3 hitPoint = ray.pointAtTime(hitTime);
+
+    // The hit is on a cap if it is closer to the cap than the side. This works for both entry and exit hits.
+    Point3 localPoint = inverseRotation(subtractVectors(hitPoint, center), rotationMatrix);
+
+    const Real radialDistance = sqrt(localPoint.x * localPoint.x + localPoint.z * localPoint.z);
+    const Real capDistance = fabs(0.5 * height - fabs(localPoint.y));
+    const Real sideDistance = fabs(radius - radialDistance);
+
+    Vector3 outwardNormal;
 
-    // Calculate the hit point and outward normal in original coordinates
-    // (rotate back to original). hitTime is correct in both coordinates.
-    hitPoint = ray.pointAtTime(hitTime);
+    if (capDistance < sideDistance || radialDistance == 0.0)
+        outwardNormal = vector3(0, (localPoint.y < 0 ? -1 : 1), 0);
+    else
+        outwardNormal = vector3(localPoint.x / radialDistance, 0, localPoint.z / radialDistance);
+
+    // Rotate the outward normal back to the original coordinates.
     outwardNormal = rotation(outwardNormal, rotationMatrix);
 
     const bool frontFace = (dot(ray.direction, outwardNormal) < 0.0);
@@ -102,18 +191,15 @@ bool Cylinder::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
     hit.t = hitTime;
     hit.hitPt = hitPoint;
     hit.normal = frontFace ? outwardNormal : flipVector(outwardNormal);
-    hit.material = material.get();
 
     hit.u = 0.0;
     hit.v = 0.0;
-
-    return true;
 }
 
 
 bool Cylinder::boundingBox(AABB *outputBox)
 {
-    const double halfHeight = 0.5 * height;
+    const Real halfHeight = 0.5 * height;
 
     if (!rotationMatrix)
     {
@@ -147,3 +233,12 @@ bool Cylinder::boundingBox(AABB *outputBox)
 
     return true;
 }
+
+
+void Cylinder::compile(PrimitiveArrays &arrays)
+{
+    AABB box;
+    boundingBox(&box);
+
+    arrays.addCylinder(center, rotationMatrix, radius, height, material, box);
+}
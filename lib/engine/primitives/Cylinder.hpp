@@ -16,7 +16,6 @@ extern "C"
 #include "utility/Vector3.h"
 }
 
-#include "Disc.hpp"
 #include "Primitive.hpp"
 
 
@@ -24,19 +23,46 @@ class Cylinder : public Primitive
 {
 public:
     Cylinder() = delete;
-    Cylinder(Point3 center_, Vector3 rotAngles_, double radius_, double height_, std::shared_ptr<Material> material_);
-    ~Cylinder() override;
+    /* NB: rotationMatrix_ is optional (nullptr) and is not owned. See SceneArena::makeRotation */
+    Cylinder(Point3 center_, Rotate3 *rotationMatrix_, Real radius_, Real height_, MaterialId material_);
+
+    using Primitive::hit;
+
+    /* Returns the entry or exit hit time. NB: this allows the cylinder to be used in CSG */
+    bool hit(Ray &ray, Hit &hit, HitType type) override;
 
     bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override;
 
+    /* Returns the span from the entry to the exit hit in one pass. NB: this is the query for CSG operands */
+    bool hit(Ray &ray, Time tmin, Time tmax, Span::SpanList &result) override;
+
     bool boundingBox(AABB *boundingBox) override;
 
-protected:
-    Disc topCap;
-    Disc bottomCap;
+    void compile(PrimitiveArrays &arrays) override;
 
+    /* Intersection kernels shared with the compiled scene. NB: these do not set hit.material */
+    static bool intersect(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Ray &ray, Hit &hit,
+                          HitType type);
+    static bool intersect(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Ray &ray, Time tmin,
+                          Time tmax, Hit &hit);
+    static bool intersect(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Ray &ray, Time tmin,
+                          Time tmax, Time *hitTime);
+
+    /*
+     * Returns the entry and exit times (which may be outside of the ray's range) including the caps. The solid is the
+     * intersection of an infinite cylinder and the slab between the caps so the entry is the later of their entries
+     * and the exit is the earlier of their exits.
+     */
+    static bool hitTimes(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Ray &ray, Time *tEnter,
+                         Time *tExit);
+
+    /* Populates the hit (except the material) for a known hit time on the side or a cap */
+    static void setHit(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Ray &ray, Time hitTime,
+                       Hit &hit);
+
+protected:
     Point3 center;
     Rotate3 *rotationMatrix;
-    double radius;
-    double height;
+    Real radius;
+    Real height;
 };
\ No newline at end of file
@@ -8,8 +8,9 @@
  */
 
 #include "Disc.hpp"
+#include "PrimitiveArrays.hpp"
 
-Disc::Disc(Point3 p0_, Point3 normal_, double radius_, std::shared_ptr<Material> material_)
+Disc::Disc(Point3 p0_, Point3 normal_, Real radius_, MaterialId material_)
     : Plane(p0_, normal_, material_), radius(radius_)
 {
 }
@@ -17,43 +18,38 @@ Disc::Disc(Point3 p0_, Point3 normal_, double radius_, std::shared_ptr<Material>
 
 bool Disc::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
 {
-    double hitTime = 0.0;
+    if (!intersect(p0, normal, radius, ray, tmin, tmax, hit)) return false;
 
-    if (intersectionWithPlane(p0, normal, ray, &hitTime) && Hit::isValid(hitTime, tmin, tmax))
-    {
-        // Check that hit point is inside disc radius:
-        Point3 hitPoint = ray.pointAtTime(hitTime);
+    hit.material = material;
+    return true;
+}
 
-        Vector3 hitPointMinusCenter = subtractVectors(hitPoint, p0);
 
-        if (dot(hitPointMinusCenter, hitPointMinusCenter) > (radius * radius))
-        {
-            return false;
-        }
+bool Disc::intersect(Point3 p0, Vector3 normal, Real radius, Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    Real hitTime;
 
-        Vector3 outwardNormal = normal;
+    if (!intersect(p0, normal, radius, ray, tmin, tmax, &hitTime)) return false;
 
-        const bool frontFace = (dot(ray.direction, outwardNormal) < 0.0);
+    setHit(normal, ray, hitTime, hit);
+    return true;
+}
 
-        hit.frontFace = frontFace;
-        hit.t = hitTime;
-        hit.hitPt = hitPoint;
-        hit.normal = frontFace ? outwardNormal : flipVector(outwardNormal);
-        hit.material = material.get();
 
-        hit.u = 0.0;
-        hit.v = 0.0;
+bool Disc::intersect(Point3 p0, Vector3 normal, Real radius, Ray &ray, Time tmin, Time tmax, Time *hitTime)
+{
+    if (!intersectionWithPlane(p0, normal, ray, hitTime) || !Hit::isValid(*hitTime, tmin, tmax)) return false;
 
-        return true;
-    }
+    // Check that hit point is inside disc radius:
+    Vector3 hitPointMinusCenter = subtractVectors(ray.pointAtTime(*hitTime), p0);
 
-    return false;
+    return (dot(hitPointMinusCenter, hitPointMinusCenter) <= (radius * radius));
 }
 
 
 bool Disc::boundingBox(AABB *outputBox)
 {
-    const double deltaR = 0.001;
+    const Real deltaR = 0.001;
 
     if (fabs(normal.x) == 1.0)
     {
@@ -77,4 +73,13 @@ bool Disc::boundingBox(AABB *outputBox)
     }
 
     return true;
-}
\ No newline at end of file
+}
+
+
+void Disc::compile(PrimitiveArrays &arrays)
+{
+    AABB box;
+    boundingBox(&box);
+
+    arrays.addDisc(p0, normal, radius, material, box);
+}
@@ -14,13 +14,18 @@ class Disc : public Plane
 {
 public:
     Disc() = delete;
-    Disc(Point3 p0_, Point3 normal_, double radius_, std::shared_ptr<Material> material_);
-    ~Disc() override = default;
+    Disc(Point3 p0_, Point3 normal_, Real radius_, MaterialId material_);
 
     bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override;
 
     bool boundingBox(AABB *boundingBox) override;
 
+    void compile(PrimitiveArrays &arrays) override;
+
+    /* Intersection kernels shared with the compiled scene. NB: these do not set hit.material (see Plane::setHit) */
+    static bool intersect(Point3 p0, Vector3 normal, Real radius, Ray &ray, Time tmin, Time tmax, Hit &hit);
+    static bool intersect(Point3 p0, Vector3 normal, Real radius, Ray &ray, Time tmin, Time tmax, Time *hitTime);
+
 protected:
-    double radius;
+    Real radius;
 };
\ No newline at end of file
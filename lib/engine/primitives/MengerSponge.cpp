@@ -0,0 +1,222 @@
+/**
+ * @file MengerSponge.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "MengerSponge.hpp"
+#include "PrimitiveArrays.hpp"
+#include <algorithm>
+#include <cmath>
+
+/* Ray in the sponge's frame where it occupies the unit cube [0, 1]^3. Hit times are unchanged */
+struct SpongeRay
+{
+    Real origin[3];
+    Real direction[3];
+    Real invDirection[3];
+};
+
+static bool traverseCube(const SpongeRay &ray, const Real cellMin[3], Real cellSize, int levelsLeft, Real tmin,
+                         Real tmax, Real *hitTime, int *face);
+
+
+MengerSponge::MengerSponge(Point3 center_, Real length_, int level_, MaterialId material_)
+    : Primitive(material_), center(center_), length(length_), level(std::clamp(level_, 0, kMaxLevel))
+{
+}
+
+
+bool MengerSponge::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    if (!intersect(center, length, level, ray, tmin, tmax, hit)) return false;
+
+    hit.material = material;
+    return true;
+}
+
+
+bool MengerSponge::intersect(Point3 center, Real length, int level, Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    Time hitTime;
+    int face;
+
+    if (!intersect(center, length, level, ray, tmin, tmax, &hitTime, &face)) return false;
+
+    setHit(ray, hitTime, face, hit);
+    return true;
+}
+
+
+bool MengerSponge::intersect(Point3 center, Real length, int level, Ray &ray, Time tmin, Time tmax, Time *hitTime,
+                             int *face)
+{
+    const Real invLength = 1.0 / length;
+
+    // Shift the corner of the sponge to the origin and scale it to a unit cube.
+    const Point3 origin = scaleVector(subtractVectors(ray.origin, center), invLength);
+    const Vector3 direction = scaleVector(ray.direction, invLength);
+
+    const SpongeRay spongeRay = {.origin = {origin.x + Real(0.5), origin.y + Real(0.5), origin.z + Real(0.5)},
+                                 .direction = {direction.x, direction.y, direction.z},
+                                 .invDirection = {Real(1) / direction.x, Real(1) / direction.y, Real(1) / direction.z}};
+
+    const Real cellMin[3] = {0.0, 0.0, 0.0};
+
+    return traverseCube(spongeRay, cellMin, 1.0, level, tmin, tmax, hitTime, face);
+}
+
+
+/// Returns the closest hit in range (tmin, tmax) with the solid cube at cellMin which is subdivided levelsLeft more
+/// times.
+static bool traverseCube(const SpongeRay &ray, const Real cellMin[3], Real cellSize, int levelsLeft, Real tmin,
+                         Real tmax, Real *hitTime, int *face)
+{
+    Real tEnter = -INFINITY, tExit = INFINITY;
+    int enterAxis = 0, exitAxis = 0;
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (ray.direction[axis] == 0.0)
+        {
+            // Parallel to the slab.
+            if (ray.origin[axis] < cellMin[axis] || ray.origin[axis] > cellMin[axis] + cellSize) return false;
+            continue;
+        }
+
+        Real t0 = (cellMin[axis] - ray.origin[axis]) * ray.invDirection[axis];
+        Real t1 = (cellMin[axis] + cellSize - ray.origin[axis]) * ray.invDirection[axis];
+
+        if (t0 > t1) std::swap(t0, t1);
+
+        if (t0 > tEnter)
+        {
+            tEnter = t0;
+            enterAxis = axis;
+        }
+
+        if (t1 < tExit)
+        {
+            tExit = t1;
+            exitAxis = axis;
+        }
+    }
+
+    if (tEnter > tExit || tExit <= tmin || tEnter >= tmax) return false;
+
+    if (levelsLeft == 0)
+    {
+        // Try exit time if the entry is out of range (case: camera could be inside cube).
+        if (tEnter > tmin)
+        {
+            *hitTime = tEnter;
+            *face = (ray.direction[enterAxis] > 0.0) ? -(enterAxis + 1) : (enterAxis + 1);
+            return true;
+        }
+        else if (tExit < tmax)
+        {
+            *hitTime = tExit;
+            *face = (ray.direction[exitAxis] > 0.0) ? (exitAxis + 1) : -(exitAxis + 1);
+            return true;
+        }
+
+        return false;
+    }
+
+    // Step through the 3x3x3 children in the order that the ray crosses them (3D DDA).
+    const Real childSize = cellSize / 3.0;
+    const Real tStart = std::max(tEnter, tmin);
+    const Real tEnd = std::min(tExit, tmax);
+
+    int index[3], step[3];
+    Real tNext[3], tDelta[3];
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const Real position = ray.origin[axis] + tStart * ray.direction[axis];
+
+        index[axis] = std::clamp((int)floor((position - cellMin[axis]) / childSize), 0, 2);
+
+        if (ray.direction[axis] > 0.0)
+        {
+            step[axis] = 1;
+            tNext[axis] = (cellMin[axis] + (index[axis] + 1) * childSize - ray.origin[axis]) * ray.invDirection[axis];
+            tDelta[axis] = childSize * ray.invDirection[axis];
+        }
+        else if (ray.direction[axis] < 0.0)
+        {
+            step[axis] = -1;
+            tNext[axis] = (cellMin[axis] + index[axis] * childSize - ray.origin[axis]) * ray.invDirection[axis];
+            tDelta[axis] = -childSize * ray.invDirection[axis];
+        }
+        else
+        {
+            step[axis] = 0;
+            tNext[axis] = tDelta[axis] = INFINITY;
+        }
+    }
+
+    for (;;)
+    {
+        // The center child and the centers of the faces (two or more central indices) are removed.
+        const int numCentral = (index[0] == 1) + (index[1] == 1) + (index[2] == 1);
+
+        if (numCentral < 2)
+        {
+            const Real childMin[3] = {cellMin[0] + index[0] * childSize, cellMin[1] + index[1] * childSize,
+                                      cellMin[2] + index[2] * childSize};
+
+            // NB: the children do not overlap so the first hit found is the closest.
+            if (traverseCube(ray, childMin, childSize, levelsLeft - 1, tmin, tmax, hitTime, face)) return true;
+        }
+
+        const int axis = (tNext[0] < tNext[1]) ? ((tNext[0] < tNext[2]) ? 0 : 2) : ((tNext[1] < tNext[2]) ? 1 : 2);
+
+        if (tNext[axis] >= tEnd) return false;
+
+        index[axis] += step[axis];
+        if (index[axis] < 0 || index[axis] > 2) return false;
+
+        tNext[axis] += tDelta[axis];
+    }
+}
+
+
+void MengerSponge::setHit(Ray &ray, Time hitTime, int face, Hit &hit)
+{
+    const Real sign = (face < 0) ? -1.0 : 1.0;
+    const int axis = abs(face) - 1;
+
+    const Vector3 outwardNormal = vector3(axis == 0 ? sign : 0.0, axis == 1 ? sign : 0.0, axis == 2 ? sign : 0.0);
+    const bool frontFace = (dot(ray.direction, outwardNormal) < 0.0);
+
+    hit.frontFace = frontFace;
+    hit.t = hitTime;
+    hit.hitPt = ray.pointAtTime(hitTime);
+    hit.normal = frontFace ? outwardNormal : flipVector(outwardNormal);
+
+    hit.u = 0.0;
+    hit.v = 0.0;
+}
+
+
+bool MengerSponge::boundingBox(AABB *outputBox)
+{
+    const Real halfL = 0.5 * length;
+
+    outputBox->minPt() = point3(center.x - halfL, center.y - halfL, center.z - halfL);
+    outputBox->maxPt() = point3(center.x + halfL, center.y + halfL, center.z + halfL);
+    return true;
+}
+
+
+void MengerSponge::compile(PrimitiveArrays &arrays)
+{
+    AABB box;
+    boundingBox(&box);
+
+    arrays.addMenger(center, length, level, material, box);
+}
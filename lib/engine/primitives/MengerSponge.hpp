@@ -0,0 +1,58 @@
+/**
+ * @file MengerSponge.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "Primitive.hpp"
+#include <cstdint>
+
+extern "C"
+{
+#include "utility/Vector3.h"
+}
+
+/**
+ * Axis-aligned Menger sponge which is intersected implicitly. The ray steps through the 3x3x3 subdivision of each
+ * solid cube (3D DDA) in the order it crosses them and descends into the 20 solid children until it reaches a cube at
+ * the final level. The storage is independent of the level and the traversal stack grows linearly with it.
+ *
+ * Reference: https://en.wikipedia.org/wiki/Menger_sponge
+ */
+class MengerSponge : public Primitive
+{
+public:
+    /* Deepest level supported. NB: the smallest cubes are 3^-level times the side length */
+    static constexpr int kMaxLevel = 12;
+
+    MengerSponge() = delete;
+    MengerSponge(Point3 center_, Real length_, int level_, MaterialId material_);
+
+    bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override;
+
+    bool boundingBox(AABB *boundingBox) override;
+
+    void compile(PrimitiveArrays &arrays) override;
+
+    /* Intersection kernels shared with the compiled scene. NB: these do not set hit.material */
+    static bool intersect(Point3 center, Real length, int level, Ray &ray, Time tmin, Time tmax, Hit &hit);
+
+    /*
+     * Returns the closest hit time in range (tmin, tmax) and the face hit: +/-(axis + 1) for an outward normal along
+     * +/- the x, y or z axis.
+     */
+    static bool intersect(Point3 center, Real length, int level, Ray &ray, Time tmin, Time tmax, Time *hitTime,
+                          int *face);
+
+    /* Populates the hit (except the material) for a known hit time and face */
+    static void setHit(Ray &ray, Time hitTime, int face, Hit &hit);
+
+protected:
+    Point3 center;
+    Real length;
+    int level;
+};
@@ -8,8 +8,9 @@
  */
 
 #include "Plane.hpp"
+#include "PrimitiveArrays.hpp"
 
-Plane::Plane(Point3 p0_, Point3 normal_, std::shared_ptr<Material> material_)
+Plane::Plane(Point3 p0_, Point3 normal_, MaterialId material_)
     : Primitive(material_), p0(p0_), normal(normal_)
 {
 }
@@ -17,33 +18,49 @@ Plane::Plane(Point3 p0_, Point3 normal_, std::shared_ptr<Material> material_)
 
 bool Plane::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
 {
-    double hitTime = 0.0;
+    if (!intersect(p0, normal, ray, tmin, tmax, hit)) return false;
 
-    if (intersectionWithPlane(p0, normal, ray, &hitTime) && Hit::isValid(hitTime, tmin, tmax))
-    {
-        Vector3 outwardNormal = normal;
+    hit.material = material;
+    return true;
+}
 
-        const bool frontFace = (dot(ray.direction, outwardNormal) < 0.0);
 
-        hit.frontFace = frontFace;
-        hit.t = hitTime;
-        hit.hitPt = ray.pointAtTime(hitTime);
-        hit.normal = frontFace ? outwardNormal : flipVector(outwardNormal);
-        hit.material = material.get();
+bool Plane::intersect(Point3 p0, Vector3 normal, Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    Real hitTime;
 
-        hit.u = 0.0;
-        hit.v = 0.0;
+    if (!intersect(p0, normal, ray, tmin, tmax, &hitTime)) return false;
+
+    setHit(normal, ray, hitTime, hit);
+    return true;
+}
 
-        return true;
-    }
 
-    return false;
+bool Plane::intersect(Point3 p0, Vector3 normal, Ray &ray, Time tmin, Time tmax, Time *hitTime)
+{
+    return (intersectionWithPlane(p0, normal, ray, hitTime) && Hit::isValid(*hitTime, tmin, tmax));
+}
+
+
+void Plane::setHit(Vector3 normal, Ray &ray, Time hitTime, Hit &hit)
+{
+    Vector3 outwardNormal = normal;
+
+    const bool frontFace = (dot(ray.direction, outwardNormal) < 0.0);
+
+    hit.frontFace = frontFace;
+    hit.t = hitTime;
+    hit.hitPt = ray.pointAtTime(hitTime);
+    hit.normal = frontFace ? outwardNormal : flipVector(outwardNormal);
+
+    hit.u = 0.0;
+    hit.v = 0.0;
 }
 
 
 bool Plane::boundingBox(AABB *outputBox)
 {
-    const double deltaR = 0.001;
+    const Real deltaR = 0.001;
 
     if (fabs(normal.x) == 1.0)
     {
@@ -68,3 +85,12 @@ bool Plane::boundingBox(AABB *outputBox)
 
     return true;
 }
+
+
+void Plane::compile(PrimitiveArrays &arrays)
+{
+    AABB box;
+    boundingBox(&box);
+
+    arrays.addPlane(p0, normal, material, box);
+}
@@ -14,13 +14,21 @@ class Plane : public Primitive
 {
 public:
     Plane() = delete;
-    Plane(Point3 p0_, Point3 normal_, std::shared_ptr<Material> material_);
-    ~Plane() override = default;
+    Plane(Point3 p0_, Point3 normal_, MaterialId material_);
 
     bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override;
 
     bool boundingBox(AABB *boundingBox) override;
 
+    void compile(PrimitiveArrays &arrays) override;
+
+    /* Intersection kernels shared with the compiled scene. NB: these do not set hit.material */
+    static bool intersect(Point3 p0, Vector3 normal, Ray &ray, Time tmin, Time tmax, Hit &hit);
+    static bool intersect(Point3 p0, Vector3 normal, Ray &ray, Time tmin, Time tmax, Time *hitTime);
+
+    /* Populates the hit (except the material) for a known hit time */
+    static void setHit(Vector3 normal, Ray &ray, Time hitTime, Hit &hit);
+
 protected:
     Point3 p0; // Point on the plane.
     Point3 normal;
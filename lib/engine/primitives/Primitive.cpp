@@ -8,9 +8,10 @@
  */
 
 #include "Primitive.hpp"
+#include "PrimitiveArrays.hpp"
 #include <stdexcept>
 
-Primitive::Primitive(std::shared_ptr<Material> material_) : material(material_)
+Primitive::Primitive(MaterialId material_) : material(material_)
 {
 }
 
@@ -55,13 +56,14 @@ bool Primitive::hit(Ray &ray, Time tmin, Time tmax, Span::SpanList &result)
     (void)hit(ray, exit, Exit);
 
     /*
-     * NB: we allow 1 of the intersections to be invalid. i.e. Entry is behind camera but exit is ahead of camera
-     * which would be the case where camera is inside object. This is fine because we will be performing CSG operations
-     * and only need to check at the end whether the intersection is valid.
+     * NB: we allow both of the intersections to be invalid provided that the span overlaps the range. i.e. Entry is
+     * behind camera but exit is ahead of camera which would be the case where camera is inside object. This is fine
+     * because we will be performing CSG operations and only need to check at the end whether the intersection is
+     * valid. Dropping a span which covers the whole range would change the result of a CSG difference.
      */
-    if (!entry.isValid(tmin, tmax) && !exit.isValid(tmin, tmax))
+    if (exit.t <= tmin || entry.t >= tmax)
     {
-        return false; // Full intersection behind camera --> ignore.
+        return false; // Full intersection outside range --> ignore.
     }
 
     result.push_back(Span(entry, exit));
@@ -69,23 +71,35 @@ bool Primitive::hit(Ray &ray, Time tmin, Time tmax, Span::SpanList &result)
 }
 
 
+void Primitive::compile(PrimitiveArrays &arrays)
+{
+    AABB box;
+    if (!boundingBox(&box))
+    {
+        throw std::runtime_error("unable to compile primitive without a bounding box");
+    }
+
+    arrays.addGeneric(this, box);
+}
+
+
 /// Returns a positive value > 0 if a ray intersects with a plane. p0 is an
 /// arbitrary point on the plane and n is the plane's normal vector.
-bool intersectionWithPlane(Point3 p0, Vector3 n, Ray &ray, double *hitTime)
+bool intersectionWithPlane(Point3 p0, Vector3 n, Ray &ray, Real *hitTime)
 {
     // Eqn for line: p = origin + t * d
     // Plane: (p - p0).n = 0 where n is normal to plane and p0 is point on the plane.
     //
     // --> (origin - p0).n + t*(d.n) = 0
     // --> t = (p0 - origin).n / (d.n)
-    const double directionDotN = dot(ray.direction, n);
-    const double p0MinusOriginDotN = dot(subtractVectors(p0, ray.origin), n);
+    const Real directionDotN = dot(ray.direction, n);
+    const Real p0MinusOriginDotN = dot(subtractVectors(p0, ray.origin), n);
 
     // Line and plane are parallel --> no intersection point:
     if (directionDotN == 0) return false;
 
     // Negative intersect time --> intersects behind ray's position:
-    const double intersectTime = (p0MinusOriginDotN / directionDotN);
+    const Real intersectTime = (p0MinusOriginDotN / directionDotN);
     if (intersectTime < 0.0) return false;
 
     *hitTime = intersectTime;
@@ -102,13 +116,13 @@ Ray transformRay(Ray &ray, Point3 center, Rotate3 *rotation)
 }
 
 
-bool solveQuadratic(double a, double b, double c, double *t1, double *t2)
+bool solveQuadratic(Real a, Real b, Real c, Real *t1, Real *t2)
 {
-    const double discriminant = b * b - 4.0 * a * c;
+    const Real discriminant = b * b - 4.0 * a * c;
 
     if (discriminant < 0.0) return 0; // No roots.
 
-    const double sqrtDiscriminant = sqrt(discriminant);
+    const Real sqrtDiscriminant = sqrt(discriminant);
 
     *t1 = (-b - sqrtDiscriminant) / (2 * a);
     *t2 = (-b + sqrtDiscriminant) / (2 * a);
@@ -20,7 +20,8 @@ extern "C"
 #include "engine/Ray.hpp"
 #include "engine/Span.hpp"
 #include "engine/materials/Material.hpp"
-#include <memory>
+
+class PrimitiveArrays;
 
 /** Base object class. */
 class Primitive
@@ -28,9 +29,7 @@ class Primitive
 public:
     Primitive() = delete;
 
-    virtual ~Primitive() = default;
-
-    using Time = double;
+    using Time = Real;
 
     enum HitType
     {
@@ -53,15 +52,24 @@ public:
     /** On success, returns true and populates bounding box structure. */
     virtual bool boundingBox(AABB *boundingBox) = 0;
 
+    /** Appends the primitive to the type-tagged arrays used for rendering. By default it is stored as generic. */
+    virtual void compile(PrimitiveArrays &arrays);
+
 protected:
-    Primitive(std::shared_ptr<Material> material_);
+    Primitive(MaterialId material_);
+
+    /*
+     * NB: primitives are allocated from a SceneArena and are never deleted individually. They hold non-owning
+     * handles (or indices) so that they are trivially destructible.
+     */
+    ~Primitive() = default;
 
-    /** Object material. */
-    std::shared_ptr<Material> material{nullptr};
+    /** Object material (index in the scene's MaterialTable). */
+    MaterialId material{kNoMaterial};
 };
 
-bool intersectionWithPlane(Point3 p0, Vector3 n, Ray &ray, double *hitTime);
+bool intersectionWithPlane(Point3 p0, Vector3 n, Ray &ray, Real *hitTime);
 
 Ray transformRay(Ray &ray, Point3 center, Rotate3 *rotation);
 
-bool solveQuadratic(double a, double b, double c, double *t1, double *t2);
+bool solveQuadratic(Real a, Real b, Real c, Real *t1, Real *t2);
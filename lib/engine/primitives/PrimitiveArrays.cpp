@@ -0,0 +1,474 @@
+/**
+ * @file PrimitiveArrays.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "PrimitiveArrays.hpp"
+#include "Cone.hpp"
+#include "Cube.hpp"
+#include "Cylinder.hpp"
+#include "Disc.hpp"
+#include "MengerSponge.hpp"
+#include "Plane.hpp"
+#include "SdfPrimitive.hpp"
+#include "Sphere.hpp"
+#include "Triangle.hpp"
+#include <cmath>
+
+
+void PrimitiveArrays::addRef(PrimitiveType type, size_t index, MaterialId material, const AABB &box)
+{
+    refs.push_back({.type = type, .material = material, .index = (uint32_t)index});
+    boxes.push_back(box);
+}
+
+
+void PrimitiveArrays::addSphere(Point3 center, Real radius, MaterialId material, const AABB &box)
+{
+    addRef(PrimitiveType::Sphere, spheres.radius.size(), material, box);
+
+    spheres.centerX.push_back(center.x);
+    spheres.centerY.push_back(center.y);
+    spheres.centerZ.push_back(center.z);
+    spheres.radius.push_back(radius);
+}
+
+
+void PrimitiveArrays::addCube(Point3 center, Rotate3 *rotationMatrix, Real length, MaterialId material,
+                              const AABB &box)
+{
+    addRef(PrimitiveType::Cube, cubes.size(), material, box);
+    cubes.push_back({center, rotationMatrix, length});
+}
+
+
+void PrimitiveArrays::addTriangle(Point3 v0, Point3 v1, Point3 v2, Vector3 normal, MaterialId material,
+                                  const AABB &box)
+{
+    addRef(PrimitiveType::Triangle, triangles.size(), material, box);
+    triangles.push_back({v0, v1, v2, normal});
+}
+
+
+void PrimitiveArrays::addDisc(Point3 p0, Vector3 normal, Real radius, MaterialId material, const AABB &box)
+{
+    addRef(PrimitiveType::Disc, discs.size(), material, box);
+    discs.push_back({p0, normal, radius});
+}
+
+
+void PrimitiveArrays::addPlane(Point3 p0, Vector3 normal, MaterialId material, const AABB &box)
+{
+    addRef(PrimitiveType::Plane, planes.size(), material, box);
+    planes.push_back({p0, normal});
+}
+
+
+void PrimitiveArrays::addCylinder(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height,
+                                  MaterialId material, const AABB &box)
+{
+    addRef(PrimitiveType::Cylinder, cylinders.size(), material, box);
+    cylinders.push_back({center, rotationMatrix, radius, height});
+}
+
+
+void PrimitiveArrays::addCone(Point3 center, Rotate3 *rotationMatrix, Real height, MaterialId material,
+                              const AABB &box)
+{
+    addRef(PrimitiveType::Cone, cones.size(), material, box);
+    cones.push_back({center, rotationMatrix, height});
+}
+
+
+void PrimitiveArrays::addMenger(Point3 center, Real length, int level, MaterialId material, const AABB &box)
+{
+    addRef(PrimitiveType::Menger, mengers.size(), material, box);
+    mengers.push_back({center, length, level});
+}
+
+
+void PrimitiveArrays::addSdf(int estimator, Point3 center, Real scale, int maxIterations, Real epsilon,
+                             Real relaxation, MaterialId material, const AABB &box)
+{
+    addRef(PrimitiveType::Sdf, sdfs.size(), material, box);
+    sdfs.push_back({center, scale, epsilon, relaxation, maxIterations, estimator});
+}
+
+
+void PrimitiveArrays::addGeneric(Primitive *primitive, const AABB &box)
+{
+    addRef(PrimitiveType::Generic, generic.size(), kNoMaterial, box);
+    generic.push_back(primitive);
+}
+
+
+void PrimitiveArrays::reserve(const PrimitiveArrays &other)
+{
+    spheres.centerX.reserve(other.spheres.centerX.size());
+    spheres.centerY.reserve(other.spheres.centerY.size());
+    spheres.centerZ.reserve(other.spheres.centerZ.size());
+    spheres.radius.reserve(other.spheres.radius.size());
+
+    cubes.reserve(other.cubes.size());
+    triangles.reserve(other.triangles.size());
+    discs.reserve(other.discs.size());
+    planes.reserve(other.planes.size());
+    cylinders.reserve(other.cylinders.size());
+    cones.reserve(other.cones.size());
+    mengers.reserve(other.mengers.size());
+    sdfs.reserve(other.sdfs.size());
+    generic.reserve(other.generic.size());
+
+    refs.reserve(other.refs.size());
+    boxes.reserve(other.boxes.size());
+}
+
+
+PrimitiveRef PrimitiveArrays::append(const PrimitiveArrays &other, size_t position)
+{
+    const PrimitiveRef ref = other.refs.at(position);
+    const AABB *box = &other.boxes[position];
+    const uint32_t i = ref.index;
+
+    switch (ref.type)
+    {
+        case PrimitiveType::Sphere:
+        {
+            const Spheres &s = other.spheres;
+            addSphere(point3(s.centerX[i], s.centerY[i], s.centerZ[i]), s.radius[i], ref.material, *box);
+            break;
+        }
+        case PrimitiveType::Cube:
+        {
+            const CubeRecord &cube = other.cubes[i];
+            addCube(cube.center, cube.rotationMatrix, cube.length, ref.material, *box);
+            break;
+        }
+        case PrimitiveType::Triangle:
+        {
+            const TriangleRecord &tri = other.triangles[i];
+            addTriangle(tri.v0, tri.v1, tri.v2, tri.normal, ref.material, *box);
+            break;
+        }
+        case PrimitiveType::Disc:
+        {
+            const DiscRecord &disc = other.discs[i];
+            addDisc(disc.p0, disc.normal, disc.radius, ref.material, *box);
+            break;
+        }
+        case PrimitiveType::Plane:
+        {
+            const PlaneRecord &plane = other.planes[i];
+            addPlane(plane.p0, plane.normal, ref.material, *box);
+            break;
+        }
+        case PrimitiveType::Cylinder:
+        {
+            const CylinderRecord &cyl = other.cylinders[i];
+            addCylinder(cyl.center, cyl.rotationMatrix, cyl.radius, cyl.height, ref.material, *box);
+            break;
+        }
+        case PrimitiveType::Cone:
+        {
+            const ConeRecord &cone = other.cones[i];
+            addCone(cone.center, cone.rotationMatrix, cone.height, ref.material, *box);
+            break;
+        }
+        case PrimitiveType::Menger:
+        {
+            const MengerRecord &menger = other.mengers[i];
+            addMenger(menger.center, menger.length, menger.level, ref.material, *box);
+            break;
+        }
+        case PrimitiveType::Sdf:
+        {
+            const SdfRecord &sdf = other.sdfs[i];
+            addSdf(sdf.estimator, sdf.center, sdf.scale, sdf.maxIterations, sdf.epsilon, sdf.relaxation, ref.material,
+                   *box);
+            break;
+        }
+        case PrimitiveType::Generic:
+            addGeneric(other.generic[i], *box);
+            break;
+    }
+
+    return refs.back();
+}
+
+
+bool PrimitiveArrays::intersect(PrimitiveRef ref, Ray &ray, Real tmin, Real tmax, Hit &hit) const
+{
+    const uint32_t i = ref.index;
+
+    switch (ref.type)
+    {
+        case PrimitiveType::Sphere:
+        {
+            const Point3 center = point3(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]);
+            if (!Sphere::intersect(center, spheres.radius[i], ray, tmin, tmax, hit)) return false;
+            break;
+        }
+        case PrimitiveType::Cube:
+        {
+            const CubeRecord &cube = cubes[i];
+            if (!Cube::intersect(cube.center, cube.rotationMatrix, cube.length, ray, tmin, tmax, hit)) return false;
+            break;
+        }
+        case PrimitiveType::Triangle:
+        {
+            const TriangleRecord &tri = triangles[i];
+            if (!Triangle::intersect(tri.v0, tri.v1, tri.v2, tri.normal, ray, tmin, tmax, hit)) return false;
+            break;
+        }
+        case PrimitiveType::Disc:
+        {
+            const DiscRecord &disc = discs[i];
+            if (!Disc::intersect(disc.p0, disc.normal, disc.radius, ray, tmin, tmax, hit)) return false;
+            break;
+        }
+        case PrimitiveType::Plane:
+        {
+            const PlaneRecord &plane = planes[i];
+            if (!Plane::intersect(plane.p0, plane.normal, ray, tmin, tmax, hit)) return false;
+            break;
+        }
+        case PrimitiveType::Cylinder:
+        {
+            const CylinderRecord &cyl = cylinders[i];
+            if (!Cylinder::intersect(cyl.center, cyl.rotationMatrix, cyl.radius, cyl.height, ray, tmin, tmax, hit))
+                return false;
+            break;
+        }
+        case PrimitiveType::Cone:
+        {
+            const ConeRecord &cone = cones[i];
+            if (!Cone::intersect(cone.center, cone.rotationMatrix, cone.height, ray, tmin, tmax, hit)) return false;
+            break;
+        }
+        case PrimitiveType::Menger:
+        {
+            const MengerRecord &menger = mengers[i];
+            if (!MengerSponge::intersect(menger.center, menger.length, menger.level, ray, tmin, tmax, hit))
+                return false;
+            break;
+        }
+        case PrimitiveType::Sdf:
+        {
+            const SdfRecord &sdf = sdfs[i];
+
+            SdfPrimitive::Settings settings;
+            settings.maxIterations = sdf.maxIterations;
+            settings.epsilon = sdf.epsilon;
+            settings.relaxation = sdf.relaxation;
+
+            if (!SdfPrimitive::intersect((SdfPrimitive::Estimator)sdf.estimator, sdf.center, sdf.scale, settings, ray,
+                                         tmin, tmax, hit))
+                return false;
+            break;
+        }
+        case PrimitiveType::Generic:
+            return generic[i]->hit(ray, tmin, tmax, hit); // Sets the material.
+    }
+
+    hit.material = ref.material;
+    return true;
+}
+
+
+bool PrimitiveArrays::intersect(PrimitiveRef ref, Ray &ray, Real tmin, Real tmax, HitRecord &record) const
+{
+    const uint32_t i = ref.index;
+    Real t = 0.0, u = 0.0, v = 0.0;
+
+    switch (ref.type)
+    {
+        case PrimitiveType::Sphere:
+        {
+            const Point3 center = point3(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]);
+            if (!Sphere::intersect(center, spheres.radius[i], ray, tmin, tmax, &t)) return false;
+            break;
+        }
+        case PrimitiveType::Cube:
+        {
+            const CubeRecord &cube = cubes[i];
+            if (!Cube::intersect(cube.center, cube.rotationMatrix, cube.length, ray, tmin, tmax, &t)) return false;
+            break;
+        }
+        case PrimitiveType::Triangle:
+        {
+            const TriangleRecord &tri = triangles[i];
+            if (!Triangle::intersect(tri.v0, tri.v1, tri.v2, tri.normal, ray, tmin, tmax, &t, &u, &v)) return false;
+            break;
+        }
+        case PrimitiveType::Disc:
+        {
+            const DiscRecord &disc = discs[i];
+            if (!Disc::intersect(disc.p0, disc.normal, disc.radius, ray, tmin, tmax, &t)) return false;
+            break;
+        }
+        case PrimitiveType::Plane:
+        {
+            const PlaneRecord &plane = planes[i];
+            if (!Plane::intersect(plane.p0, plane.normal, ray, tmin, tmax, &t)) return false;
+            break;
+        }
+        case PrimitiveType::Menger:
+        {
+            const MengerRecord &menger = mengers[i];
+            int face;
+            if (!MengerSponge::intersect(menger.center, menger.length, menger.level, ray, tmin, tmax, &t, &face))
+                return false;
+            u = face;
+            break;
+        }
+        case PrimitiveType::Cylinder:
+        {
+            const CylinderRecord &cyl = cylinders[i];
+            if (!Cylinder::intersect(cyl.center, cyl.rotationMatrix, cyl.radius, cyl.height, ray, tmin, tmax, &t))
+                return false;
+            break;
+        }
+        case PrimitiveType::Cone:
+        {
+            const ConeRecord &cone = cones[i];
+            if (!Cone::intersect(cone.center, cone.rotationMatrix, cone.height, ray, tmin, tmax, &t)) return false;
+            break;
+        }
+        case PrimitiveType::Sdf:
+        case PrimitiveType::Generic:
+        {
+            // No separate hit-time kernel. The hit is recomputed by surfaceInteraction().
+            Hit hit;
+            if (!intersect(ref, ray, tmin, tmax, hit)) return false;
+            t = hit.t;
+            ref.material = hit.material; // NB: in case the hit cannot be recomputed.
+            break;
+        }
+    }
+
+    record = {.t = t, .ref = ref, .u = u, .v = v};
+    return true;
+}
+
+
+bool PrimitiveArrays::intersect(const PrimitiveRef *leafRefs, size_t count, Ray &ray, Real tmin, Real tmax,
+                                HitRecord &record) const
+{
+    bool hitAnything = false;
+
+    for (size_t i = 0; i < count;)
+    {
+        // Spheres with consecutive indices (the leaf order) are tested together by the packed kernel.
+        size_t runLength = 1;
+
+        if (leafRefs[i].type == PrimitiveType::Sphere)
+        {
+            while (i + runLength < count && leafRefs[i + runLength].type == PrimitiveType::Sphere &&
+                   leafRefs[i + runLength].index == leafRefs[i].index + runLength)
+            {
+                ++runLength;
+            }
+        }
+
+        const bool didHit = (runLength > 1) ? intersectSpheres(&leafRefs[i], runLength, ray, tmin, tmax, record)
+                                            : intersect(leafRefs[i], ray, tmin, tmax, record);
+        if (didHit)
+        {
+            hitAnything = true;
+            tmax = record.t;
+        }
+
+        i += runLength;
+    }
+
+    return hitAnything;
+}
+
+
+bool PrimitiveArrays::intersectSpheres(const PrimitiveRef *runRefs, size_t count, Ray &ray, Real tmin, Real tmax,
+                                       HitRecord &record) const
+{
+    const size_t first = runRefs[0].index;
+    Real hitTime;
+
+    const int iHit = Sphere::intersectPacked(&spheres.centerX[first], &spheres.centerY[first], &spheres.centerZ[first],
+                                             &spheres.radius[first], (int)count, ray, tmin, tmax, &hitTime);
+    if (iHit < 0) return false;
+
+    record = {.t = hitTime, .ref = runRefs[iHit], .u = 0.0, .v = 0.0};
+    return true;
+}
+
+
+void PrimitiveArrays::surfaceInteraction(const HitRecord &record, Ray &ray, Real tmin, Hit &hit) const
+{
+    const uint32_t i = record.ref.index;
+
+    hit.material = record.ref.material; // NB: generic primitives also set their own material.
+
+    switch (record.ref.type)
+    {
+        case PrimitiveType::Sphere:
+        {
+            const Point3 center = point3(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]);
+            Sphere::setHit(center, spheres.radius[i], ray, record.t, hit);
+            break;
+        }
+        case PrimitiveType::Cube:
+        {
+            const CubeRecord &cube = cubes[i];
+            Cube::setHit(cube.center, cube.rotationMatrix, ray, record.t, hit);
+            break;
+        }
+        case PrimitiveType::Triangle:
+        {
+            const TriangleRecord &tri = triangles[i];
+            Triangle::setHit(tri.normal, ray, record.t, record.u, record.v, hit);
+            break;
+        }
+        case PrimitiveType::Disc:
+        {
+            const DiscRecord &disc = discs[i];
+            Plane::setHit(disc.normal, ray, record.t, hit);
+            break;
+        }
+        case PrimitiveType::Plane:
+        {
+            const PlaneRecord &plane = planes[i];
+            Plane::setHit(plane.normal, ray, record.t, hit);
+            break;
+        }
+        case PrimitiveType::Menger:
+            MengerSponge::setHit(ray, record.t, (int)record.u, hit);
+            break;
+        case PrimitiveType::Cylinder:
+        {
+            const CylinderRecord &cyl = cylinders[i];
+            Cylinder::setHit(cyl.center, cyl.rotationMatrix, cyl.radius, cyl.height, ray, record.t, hit);
+            break;
+        }
+        case PrimitiveType::Cone:
+        {
+            const ConeRecord &cone = cones[i];
+            Cone::setHit(cone.center, cone.rotationMatrix, cone.height, ray, record.t, hit);
+            break;
+        }
+        case PrimitiveType::Sdf:
+        case PrimitiveType::Generic:
+            // Repeat the full intersection. Nothing else lies in (tmin, t) so the same hit is found.
+            if (intersect(record.ref, ray, tmin, std::nextafter(record.t, (Real)INFINITY), hit)) break;
+
+            // NB: should not happen. Keep the recorded hit with a normal facing the ray.
+            hit.t = record.t;
+            hit.hitPt = ray.pointAtTime(record.t);
+            hit.normal = unitVector(flipVector(ray.direction));
+            hit.frontFace = true;
+            hit.u = record.u;
+            hit.v = record.v;
+            break;
+    }
+}
@@ -0,0 +1,195 @@
+/**
+ * @file PrimitiveArrays.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "Primitive.hpp"
+#include <cstdint>
+#include <vector>
+
+extern "C"
+{
+#include "utility/Matrix3.h"
+#include "utility/Vector3.h"
+}
+
+/** Primitive type tags used to dispatch intersections without virtual calls. */
+enum class PrimitiveType : uint8_t
+{
+    Sphere,
+    Cube,
+    Triangle,
+    Disc,
+    Plane,
+    Cylinder,
+    Cone,
+    Menger,
+    Sdf,
+
+    /* Any other primitive (e.g. CSG). Falls back to the virtual hit method. */
+    Generic
+};
+
+/**
+ * References a primitive stored in PrimitiveArrays. The material is stored in the reference (rather than the record
+ * for each type) since it fits in the padding after the type.
+ */
+struct PrimitiveRef
+{
+    PrimitiveType type;
+
+    /* Primitive material (kNoMaterial for generic primitives except in a HitRecord where it is the hit's material) */
+    MaterialId material;
+
+    uint32_t index;
+};
+
+/**
+ * Minimal hit data recorded while searching for the closest hit. The full surface interaction (Hit) is computed once
+ * from this record with PrimitiveArrays::surfaceInteraction.
+ */
+struct HitRecord
+{
+    Real t;
+    PrimitiveRef ref;
+
+    /* Barycentric coordinates (triangles) or the face hit in u (Menger sponges) */
+    Real u, v;
+};
+
+/**
+ * Scene primitives grouped by type. Spheres are stored as a structure of arrays so that runs of spheres can be tested
+ * together. The other types store one small record per primitive.
+ *
+ * NB: rotation matrices and generic primitives are owned by the scene's arena which must outlive the arrays.
+ */
+class PrimitiveArrays
+{
+public:
+    struct Spheres
+    {
+        std::vector<Real> centerX, centerY, centerZ;
+        std::vector<Real> radius;
+    };
+
+    struct CubeRecord
+    {
+        Point3 center;
+        Rotate3 *rotationMatrix;
+        Real length;
+    };
+
+    struct TriangleRecord
+    {
+        Point3 v0, v1, v2;
+        Vector3 normal;
+    };
+
+    struct DiscRecord
+    {
+        Point3 p0;
+        Vector3 normal;
+        Real radius;
+    };
+
+    struct PlaneRecord
+    {
+        Point3 p0;
+        Vector3 normal;
+    };
+
+    struct CylinderRecord
+    {
+        Point3 center;
+        Rotate3 *rotationMatrix;
+        Real radius;
+        Real height;
+    };
+
+    struct ConeRecord
+    {
+        Point3 center;
+        Rotate3 *rotationMatrix;
+        Real height;
+    };
+
+    struct MengerRecord
+    {
+        Point3 center;
+        Real length;
+        int32_t level;
+    };
+
+    struct SdfRecord
+    {
+        Point3 center;
+        Real scale;
+        Real epsilon;
+        Real relaxation;
+        int32_t maxIterations;
+        int32_t estimator;
+    };
+
+    void addSphere(Point3 center, Real radius, MaterialId material, const AABB &box);
+    void addCube(Point3 center, Rotate3 *rotationMatrix, Real length, MaterialId material, const AABB &box);
+    void addTriangle(Point3 v0, Point3 v1, Point3 v2, Vector3 normal, MaterialId material, const AABB &box);
+    void addDisc(Point3 p0, Vector3 normal, Real radius, MaterialId material, const AABB &box);
+    void addPlane(Point3 p0, Vector3 normal, MaterialId material, const AABB &box);
+    void addCylinder(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, MaterialId material,
+                     const AABB &box);
+    void addCone(Point3 center, Rotate3 *rotationMatrix, Real height, MaterialId material, const AABB &box);
+    void addMenger(Point3 center, Real length, int level, MaterialId material, const AABB &box);
+    void addSdf(int estimator, Point3 center, Real scale, int maxIterations, Real epsilon, Real relaxation,
+                MaterialId material, const AABB &box);
+    void addGeneric(Primitive *primitive, const AABB &box);
+
+    /** Reserves space for the primitives in other. */
+    void reserve(const PrimitiveArrays &other);
+
+    /** Copies the primitive at position in other.refs. Returns its reference in these arrays. */
+    PrimitiveRef append(const PrimitiveArrays &other, size_t position);
+
+    /** Returns the closest hit in range (tmin, tmax) for a single primitive. */
+    bool intersect(PrimitiveRef ref, Ray &ray, Real tmin, Real tmax, Hit &hit) const;
+    bool intersect(PrimitiveRef ref, Ray &ray, Real tmin, Real tmax, HitRecord &record) const;
+
+    /** Returns the closest hit in range (tmin, tmax) for a run of primitives (i.e. a BVH leaf). */
+    bool intersect(const PrimitiveRef *leafRefs, size_t count, Ray &ray, Real tmin, Real tmax,
+                   HitRecord &record) const;
+
+    /** Computes the hit for a record returned by intersect() with the same ray and tmin. */
+    void surfaceInteraction(const HitRecord &record, Ray &ray, Real tmin, Hit &hit) const;
+
+    /** Returns the number of primitives. */
+    size_t size() const
+    {
+        return refs.size();
+    }
+
+    Spheres spheres;
+    std::vector<CubeRecord> cubes;
+    std::vector<TriangleRecord> triangles;
+    std::vector<DiscRecord> discs;
+    std::vector<PlaneRecord> planes;
+    std::vector<CylinderRecord> cylinders;
+    std::vector<ConeRecord> cones;
+    std::vector<MengerRecord> mengers;
+    std::vector<SdfRecord> sdfs;
+    std::vector<Primitive *> generic;
+
+    /** Every primitive in the order it was added, with its bounding box. */
+    std::vector<PrimitiveRef> refs;
+    std::vector<AABB> boxes;
+
+protected:
+    void addRef(PrimitiveType type, size_t index, MaterialId material, const AABB &box);
+
+    /** Returns the closest hit for a run of spheres with consecutive indices using the packed kernel. */
+    bool intersectSpheres(const PrimitiveRef *runRefs, size_t count, Ray &ray, Real tmin, Real tmax,
+                          HitRecord &record) const;
+};
@@ -14,7 +14,9 @@
 #include "Cube.hpp"
 #include "Cylinder.hpp"
 #include "Disc.hpp"
+#include "MengerSponge.hpp"
 #include "Plane.hpp"
 #include "Primitive.hpp"
+#include "SdfPrimitive.hpp"
 #include "Sphere.hpp"
 #include "Triangle.hpp"
\ No newline at end of file
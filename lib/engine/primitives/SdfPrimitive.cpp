@@ -0,0 +1,450 @@
+/**
+ * @file SdfPrimitive.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "SdfPrimitive.hpp"
+#include "PrimitiveArrays.hpp"
+#include <algorithm>
+#include <cmath>
+
+/*
+ * The estimators loop over the points with the same operations for each point (escaped points keep their values) so
+ * that the compiler can vectorise the loops.
+ */
+static const int kMandelbulbIterations = 12;
+static const Real kMandelbulbBailout = 256.0; /* Squared radius */
+
+static const int kJuliaIterations = 64;
+static const Real kJuliaBailout = 9.0; /* Squared radius */
+
+/* Constant of the quaternion Julia set: (a, b, c, d) = a + bi + cj + dk */
+static const Real kJuliaC[4] = {0.1, 0.1, 0.1, -1.0};
+
+/* Smallest value of x^2 + z^2 in the Mandelbulb's polynomial (which divides by its 3.5th power) */
+static const Real kMinRadialSquared = 1e-10;
+
+static void sphereDistance(const Real *x, const Real *y, const Real *z, Real *distance, int count);
+static void mandelbulbDistance(const Real *x, const Real *y, const Real *z, Real *distance, int count);
+static void quaternionJuliaDistance(const Real *x, const Real *y, const Real *z, Real *distance, int count);
+
+
+SdfPrimitive::SdfPrimitive(Estimator estimator_, Point3 center_, Real scale_, MaterialId material_)
+    : SdfPrimitive(estimator_, center_, scale_, material_, Settings())
+{
+}
+
+
+SdfPrimitive::SdfPrimitive(Estimator estimator_, Point3 center_, Real scale_, MaterialId material_,
+                           const Settings &settings_)
+    : Primitive(material_), estimator(estimator_), center(center_), scale(scale_), settings(settings_)
+{
+}
+
+
+bool SdfPrimitive::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    return (hitPacket(&ray, 1, tmin, tmax, &hit) != 0);
+}
+
+
+bool SdfPrimitive::intersect(Estimator estimator, Point3 center, Real scale, const Settings &settings, Ray &ray,
+                             Time tmin, Time tmax, Hit &hit)
+{
+    // NB: the primitive only holds the values so it is cheap to construct for each ray.
+    const SdfPrimitive sdf(estimator, center, scale, kNoMaterial, settings);
+
+    return (sdf.hitPacket(&ray, 1, tmin, tmax, &hit) != 0);
+}
+
+
+uint32_t SdfPrimitive::hitPacket(Ray *rays, int count, Time tmin, Time tmax, Hit *hits) const
+{
+    Point3 origins[kPacketSize];
+    Vector3 directions[kPacketSize];
+    Real tStart[kPacketSize], tEnd[kPacketSize], hitTimes[kPacketSize];
+
+    /* Hit time per unscaled unit along the unit direction */
+    Real timeScale[kPacketSize];
+
+    const Real invScale = 1.0 / scale;
+    // NB: the bounding sphere is padded so that rays do not start marching on the surface (see march).
+    const Real radius = boundingRadius(estimator) + 2.0 * settings.epsilon;
+
+    count = std::min(count, kPacketSize);
+
+    uint32_t mask = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        const Real directionLength = vectorLength(rays[i].direction);
+
+        origins[i] = scaleVector(subtractVectors(rays[i].origin, center), invScale);
+        directions[i] = scaleVector(rays[i].direction, 1.0 / directionLength);
+        timeScale[i] = scale / directionLength;
+
+        // Only march inside the bounding sphere.
+        const Real halfB = dot(origins[i], directions[i]);
+        const Real quadC = dot(origins[i], origins[i]) - radius * radius;
+        const Real discriminant = halfB * halfB - quadC;
+
+        if (discriminant < 0.0) continue;
+
+        const Real sqrtDiscriminant = sqrt(discriminant);
+
+        tStart[i] = std::max(-halfB - sqrtDiscriminant, tmin / timeScale[i]);
+        tEnd[i] = std::min(-halfB + sqrtDiscriminant, tmax / timeScale[i]);
+
+        if (tStart[i] < tEnd[i]) mask |= (1u << i);
+    }
+
+    if (mask) mask = march(origins, directions, tStart, tEnd, count, mask, hitTimes);
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (!(mask & (1u << i))) continue;
+
+        const Time hitTime = hitTimes[i] * timeScale[i];
+
+        if (!Hit::isValid(hitTime, tmin, tmax))
+        {
+            mask &= ~(1u << i);
+            continue;
+        }
+
+        const Vector3 outwardNormal = normal(addVectors(origins[i], scaleVector(directions[i], hitTimes[i])));
+        const bool frontFace = (dot(rays[i].direction, outwardNormal) < 0.0);
+
+        Hit &hit = hits[i];
+
+        hit.t = hitTime;
+        hit.hitPt = rays[i].pointAtTime(hitTime);
+        hit.frontFace = frontFace;
+        hit.normal = frontFace ? outwardNormal : flipVector(outwardNormal);
+        hit.u = 0.0;
+        hit.v = 0.0;
+        hit.material = material;
+    }
+
+    return mask;
+}
+
+
+uint32_t SdfPrimitive::march(const Point3 *origins, const Vector3 *directions, const Real *tStart, const Real *tEnd,
+                             int count, uint32_t mask, Real *hitTimes) const
+{
+    Real x[kPacketSize], y[kPacketSize], z[kPacketSize], distances[kPacketSize];
+
+    Real t[kPacketSize], relaxation[kPacketSize];
+
+    /* Previous position and distance (to undo an unsafe over-relaxed step) */
+    Real previousT[kPacketSize], previousRadius[kPacketSize];
+
+    /* Ray starts on the surface (e.g. it was scattered from it) and must move away before it can hit */
+    bool isEscaping[kPacketSize];
+
+    /* Sign of the distance on the side of the surface that the ray starts on (i.e. -1 inside) */
+    Real side[kPacketSize];
+
+    for (int i = 0; i < count; ++i)
+    {
+        t[i] = previousT[i] = tStart[i];
+        relaxation[i] = settings.relaxation;
+        previousRadius[i] = 0.0;
+        isEscaping[i] = false;
+        side[i] = 1.0;
+    }
+
+    const Real epsilon = settings.epsilon;
+
+    uint32_t active = mask, hitMask = 0;
+
+    for (int iter = 0; active && iter < settings.maxIterations; ++iter)
+    {
+        // NB: rays which are not active are evaluated at their last position.
+        for (int i = 0; i < count; ++i)
+        {
+            x[i] = origins[i].x + t[i] * directions[i].x;
+            y[i] = origins[i].y + t[i] * directions[i].y;
+            z[i] = origins[i].z + t[i] * directions[i].z;
+        }
+
+        distance(estimator, x, y, z, distances, count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            const uint32_t bit = (1u << i);
+            if (!(active & bit)) continue;
+
+            if (iter == 0)
+            {
+                side[i] = (distances[i] < 0.0) ? -1.0 : 1.0;
+                isEscaping[i] = (fabs(distances[i]) < epsilon);
+            }
+
+            // NB: the radius is negative if the ray crossed the surface (only possible with over-relaxation).
+            const Real radius = side[i] * distances[i];
+
+            // The over-relaxed step is unsafe if the unbounding spheres at the previous and current positions do
+            // not overlap. Step back to the largest safe step from the previous position and stop over-relaxing.
+            if (relaxation[i] > 1.0 && radius + previousRadius[i] < t[i] - previousT[i])
+            {
+                t[i] = previousT[i] + previousRadius[i];
+                relaxation[i] = 1.0;
+                continue;
+            }
+
+            if (isEscaping[i])
+            {
+                isEscaping[i] = (radius < 2.0 * epsilon);
+            }
+            else if (radius < epsilon)
+            {
+                hitTimes[i] = t[i];
+                hitMask |= bit;
+                active &= ~bit;
+                continue;
+            }
+
+            previousT[i] = t[i];
+            previousRadius[i] = radius;
+
+            t[i] += isEscaping[i] ? std::max(relaxation[i] * radius, epsilon) : relaxation[i] * radius;
+
+            // Only leave the bounding sphere with a safe step.
+            if (t[i] > tEnd[i] && relaxation[i] > 1.0)
+            {
+                t[i] = previousT[i] + previousRadius[i];
+                relaxation[i] = 1.0;
+            }
+
+            if (t[i] > tEnd[i]) active &= ~bit;
+        }
+    }
+
+    return hitMask;
+}
+
+
+Vector3 SdfPrimitive::normal(Point3 point) const
+{
+    // Tetrahedral estimate: sum of k * distance(point + h * k) for the vertices k of a tetrahedron.
+    static const Real kVertices[4][3] = {{1, -1, -1}, {-1, -1, 1}, {-1, 1, -1}, {1, 1, 1}};
+
+    const Real h = settings.epsilon;
+
+    Real x[4], y[4], z[4], distances[4];
+
+    for (int i = 0; i < 4; ++i)
+    {
+        x[i] = point.x + h * kVertices[i][0];
+        y[i] = point.y + h * kVertices[i][1];
+        z[i] = point.z + h * kVertices[i][2];
+    }
+
+    distance(estimator, x, y, z, distances, 4);
+
+    Vector3 gradient = vector3(0, 0, 0);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        gradient = addVectors(gradient, scaleVector(vector3(kVertices[i][0], kVertices[i][1], kVertices[i][2]),
+                                                    distances[i]));
+    }
+
+    const Real length = vectorLength(gradient);
+
+    // Degenerate gradient (e.g. at the center of the sphere): use any unit vector.
+    return (length > 0.0) ? scaleVector(gradient, 1.0 / length) : vector3(0, 1, 0);
+}
+
+
+bool SdfPrimitive::boundingBox(AABB *boundingBox)
+{
+    const Real radius = scale * boundingRadius(estimator);
+
+    Point3 min = point3(center.x - radius, center.y - radius, center.z - radius);
+    Point3 max = point3(center.x + radius, center.y + radius, center.z + radius);
+    *boundingBox = AABB(min, max);
+    return true;
+}
+
+
+void SdfPrimitive::compile(PrimitiveArrays &arrays)
+{
+    AABB box;
+    boundingBox(&box);
+
+    arrays.addSdf(estimator, center, scale, settings.maxIterations, settings.epsilon, settings.relaxation, material,
+                  box);
+}
+
+
+void SdfPrimitive::distance(Estimator estimator, const Real *x, const Real *y, const Real *z, Real *distance,
+                            int count)
+{
+    switch (estimator)
+    {
+        case Sphere:
+            sphereDistance(x, y, z, distance, count);
+            break;
+        case Mandelbulb:
+            mandelbulbDistance(x, y, z, distance, count);
+            break;
+        case QuaternionJulia:
+            quaternionJuliaDistance(x, y, z, distance, count);
+            break;
+    }
+}
+
+
+Real SdfPrimitive::boundingRadius(Estimator estimator)
+{
+    switch (estimator)
+    {
+        case Mandelbulb:
+            return 1.25;
+        case QuaternionJulia:
+            return 2.0;
+        case Sphere:
+        default:
+            return 1.0;
+    }
+}
+
+
+static void sphereDistance(const Real *x, const Real *y, const Real *z, Real *distance, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        distance[i] = sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]) - 1.0;
+    }
+}
+
+
+/// Iterates w --> w^8 + c using the polynomial (trigonometry-free) form of the power 8 triplex. The running derivative
+/// gives the distance estimate 0.5 * log(r) * r / dr.
+static void mandelbulbDistance(const Real *x, const Real *y, const Real *z, Real *distance, int count)
+{
+    const int kLanes = SdfPrimitive::kPacketSize;
+
+    Real wx[kLanes], wy[kLanes], wz[kLanes], m[kLanes], dr[kLanes];
+
+    for (int i = 0; i < count; ++i)
+    {
+        wx[i] = x[i];
+        wy[i] = y[i];
+        wz[i] = z[i];
+        m[i] = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+        dr[i] = 1.0;
+    }
+
+    for (int iter = 0; iter < kMandelbulbIterations; ++iter)
+    {
+        int numActive = 0;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const bool isActive = (m[i] <= kMandelbulbBailout);
+            numActive += isActive;
+
+            const Real x1 = wx[i], x2 = x1 * x1, x4 = x2 * x2;
+            const Real y1 = wy[i], y2 = y1 * y1, y4 = y2 * y2;
+            const Real z1 = wz[i], z2 = z1 * z1, z4 = z2 * z2;
+
+            const Real k3 = std::max(x2 + z2, kMinRadialSquared);
+            const Real k2 = 1.0 / (k3 * k3 * k3 * sqrt(k3));
+            const Real k1 = x4 + y4 + z4 - 6.0 * y2 * z2 - 6.0 * x2 * y2 + 2.0 * z2 * x2;
+            const Real k4 = x2 - y2 + z2;
+
+            const Real nextX = x[i] + 64.0 * x1 * y1 * z1 * (x2 - z2) * k4 * (x4 - 6.0 * x2 * z2 + z4) * k1 * k2;
+            const Real nextY = y[i] - 16.0 * y2 * k3 * k4 * k4 + k1 * k1;
+            const Real nextZ = z[i] - 8.0 * y1 * k4 *
+                                          (x4 * x4 - 28.0 * x4 * x2 * z2 + 70.0 * x4 * z4 - 28.0 * x2 * z2 * z4 +
+                                           z4 * z4) *
+                                          k1 * k2;
+
+            // dr --> 8 * r^7 * dr + 1
+            const Real nextDr = 8.0 * m[i] * m[i] * m[i] * sqrt(m[i]) * dr[i] + 1.0;
+
+            wx[i] = isActive ? nextX : wx[i];
+            wy[i] = isActive ? nextY : wy[i];
+            wz[i] = isActive ? nextZ : wz[i];
+            dr[i] = isActive ? nextDr : dr[i];
+            m[i] = isActive ? (nextX * nextX + nextY * nextY + nextZ * nextZ) : m[i];
+        }
+
+        if (numActive == 0) break;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        const Real r2 = std::max(m[i], kMinRadialSquared);
+
+        distance[i] = 0.25 * log(r2) * sqrt(r2) / dr[i];
+    }
+}
+
+
+/// Iterates q --> q^3 + c for the quaternion q = x + yi + zj. Since q^2 has the same imaginary direction as q, the
+/// cube is (a * (A - 2|v|^2), (A + 2a^2) * v) where q = (a, v) and A = a^2 - |v|^2.
+static void quaternionJuliaDistance(const Real *x, const Real *y, const Real *z, Real *distance, int count)
+{
+    const int kLanes = SdfPrimitive::kPacketSize;
+
+    Real qa[kLanes], qb[kLanes], qc[kLanes], qd[kLanes], r2[kLanes], dr2[kLanes];
+
+    for (int i = 0; i < count; ++i)
+    {
+        qa[i] = x[i];
+        qb[i] = y[i];
+        qc[i] = z[i];
+        qd[i] = 0.0;
+        r2[i] = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+        dr2[i] = 1.0;
+    }
+
+    for (int iter = 0; iter < kJuliaIterations; ++iter)
+    {
+        int numActive = 0;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const bool isActive = (r2[i] <= kJuliaBailout);
+            numActive += isActive;
+
+            const Real a = qa[i];
+            const Real v2 = qb[i] * qb[i] + qc[i] * qc[i] + qd[i] * qd[i];
+            const Real squareA = a * a - v2;
+            const Real vectorScale = squareA + 2.0 * a * a;
+
+            // |dq|^2 --> 9 * |q|^4 * |dq|^2
+            const Real nextDr2 = 9.0 * r2[i] * r2[i] * dr2[i];
+
+            const Real nextA = a * (squareA - 2.0 * v2) + kJuliaC[0];
+            const Real nextB = vectorScale * qb[i] + kJuliaC[1];
+            const Real nextC = vectorScale * qc[i] + kJuliaC[2];
+            const Real nextD = vectorScale * qd[i] + kJuliaC[3];
+
+            qa[i] = isActive ? nextA : qa[i];
+            qb[i] = isActive ? nextB : qb[i];
+            qc[i] = isActive ? nextC : qc[i];
+            qd[i] = isActive ? nextD : qd[i];
+            dr2[i] = isActive ? nextDr2 : dr2[i];
+            r2[i] = isActive ? (nextA * nextA + nextB * nextB + nextC * nextC + nextD * nextD) : r2[i];
+        }
+
+        if (numActive == 0) break;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        const Real radiusSquared = std::max(r2[i], kMinRadialSquared);
+
+        distance[i] = 0.25 * log(radiusSquared) * sqrt(radiusSquared / dr2[i]);
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * @file SdfPrimitive.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "Primitive.hpp"
+#include "engine/Ray.hpp"
+#include <cstdint>
+
+extern "C"
+{
+#include "utility/Vector3.h"
+}
+
+/**
+ * Primitive defined by a (signed) distance estimator which is rendered by sphere tracing: each step along the ray is
+ * the estimated distance to the surface (scaled by a relaxation factor) until the distance is below the threshold.
+ *
+ * The estimators are evaluated for several points at once (structure of arrays) so that the loops over the points can
+ * be vectorised. A packet of rays is marched together (see hitPacket) and the four points of the tetrahedral normal
+ * estimate are evaluated together.
+ *
+ * NB: the estimator is for a unit-sized shape at the origin which is scaled and translated.
+ */
+class SdfPrimitive : public Primitive
+{
+public:
+    enum Estimator : uint8_t
+    {
+        /* Unit sphere (exact distance) */
+        Sphere,
+
+        /* Power 8 Mandelbulb about the y-axis (bounding radius 1.25) */
+        Mandelbulb,
+
+        /* Cubic quaternion Julia set (bounding radius 2) */
+        QuaternionJulia
+    };
+
+    struct Settings
+    {
+        int maxIterations{256};   /* Per-ray cap on the number of steps (the ray misses if it is reached) */
+        Real epsilon{1e-4};       /* Surface threshold (unscaled) */
+        Real relaxation{1.5};     /* Step scale factor: > 1 over-relaxes (falling back if unsafe), < 1 under-relaxes */
+    };
+
+    /* Maximum number of rays in a packet (and points in one estimator call) */
+    static constexpr int kPacketSize = 8;
+
+    SdfPrimitive() = delete;
+    SdfPrimitive(Estimator estimator_, Point3 center_, Real scale_, MaterialId material_);
+    SdfPrimitive(Estimator estimator_, Point3 center_, Real scale_, MaterialId material_, const Settings &settings_);
+
+    /* Returns the closest hit in range (tmin, tmax) */
+    bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override;
+
+    bool boundingBox(AABB *boundingBox) override;
+
+    void compile(PrimitiveArrays &arrays) override;
+
+    /* Intersection kernel shared with the compiled scene. NB: this does not set hit.material */
+    static bool intersect(Estimator estimator, Point3 center, Real scale, const Settings &settings, Ray &ray,
+                          Time tmin, Time tmax, Hit &hit);
+
+    /**
+     * Marches count <= kPacketSize rays together. Returns a mask with bit i set if rays[i] hit in range (tmin, tmax)
+     * in which case hits[i] is set.
+     */
+    uint32_t hitPacket(Ray *rays, int count, Time tmin, Time tmax, Hit *hits) const;
+
+    /* Returns the unscaled distances from count <= kPacketSize points (relative to the shape's center) */
+    static void distance(Estimator estimator, const Real *x, const Real *y, const Real *z, Real *distance, int count);
+
+    /* Returns the radius of a sphere at the origin which bounds the unscaled shape */
+    static Real boundingRadius(Estimator estimator);
+
+protected:
+    /**
+     * Marches the rays in the mask from tStart to tEnd (unscaled units along the unit directions). Returns the mask of
+     * rays which reached the surface and sets their hitTimes.
+     */
+    uint32_t march(const Point3 *origins, const Vector3 *directions, const Real *tStart, const Real *tEnd, int count,
+                   uint32_t mask, Real *hitTimes) const;
+
+    /* Returns the unit outward normal at an unscaled point with the tetrahedral estimate */
+    Vector3 normal(Point3 point) const;
+
+    Estimator estimator;
+    Point3 center;
+    Real scale;
+    Settings settings;
+};
@@ -8,14 +8,92 @@
  */
 
 #include "Sphere.hpp"
+#include "PrimitiveArrays.hpp"
+#include <algorithm>
 
-Sphere::Sphere(Point3 center_, double radius_, std::shared_ptr<Material> material_)
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+static inline bool sphereHitTimes(Point3 center, Real radius, Ray &ray, Real *t1, Real *t2);
+
+Sphere::Sphere(Point3 center_, Real radius_, MaterialId material_)
     : Primitive(material_), center(center_), radius(radius_)
 {
 }
 
 
 bool Sphere::hit(Ray &ray, Hit &hit, HitType type)
+{
+    if (!intersect(center, radius, ray, hit, type)) return false;
+
+    hit.material = material;
+    return true;
+}
+
+
+bool Sphere::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    if (!intersect(center, radius, ray, tmin, tmax, hit)) return false;
+
+    hit.material = material;
+    return true;
+}
+
+
+bool Sphere::intersect(Point3 center, Real radius, Ray &ray, Hit &hit, HitType type)
+{
+    Real t1, t2;
+
+    if (!sphereHitTimes(center, radius, ray, &t1, &t2))
+    {
+        return false; // No hits.
+    }
+
+    setHit(center, radius, ray, ((type == Entry) ? t1 : t2), hit);
+    return true;
+}
+
+
+bool Sphere::intersect(Point3 center, Real radius, Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    Real hitTime;
+
+    if (!intersect(center, radius, ray, tmin, tmax, &hitTime)) return false;
+
+    setHit(center, radius, ray, hitTime, hit);
+    return true;
+}
+
+
+bool Sphere::intersect(Point3 center, Real radius, Ray &ray, Time tmin, Time tmax, Time *hitTime)
+{
+    Real t1, t2;
+
+    if (!sphereHitTimes(center, radius, ray, &t1, &t2))
+    {
+        return false; // No hits.
+    }
+
+    // Try exit time if the entry is out of range (case: camera could be inside sphere).
+    if (Hit::isValid(t1, tmin, tmax))
+    {
+        *hitTime = t1;
+    }
+    else if (Hit::isValid(t2, tmin, tmax))
+    {
+        *hitTime = t2;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+
+static inline bool sphereHitTimes(Point3 center, Real radius, Ray &ray, Real *t1, Real *t2)
 {
     // ray origin 	 = O
     // ray direction = d
@@ -38,19 +116,16 @@ bool Sphere::hit(Ray &ray, Hit &hit, HitType type)
 
     Vector3 rayOriginMinusCenter = subtractVectors(ray.origin, center);
 
-    const double quadA = dot(ray.direction, ray.direction);
-    const double quadB = 2.0 * dot(ray.direction, rayOriginMinusCenter);
-    const double quadC = dot(rayOriginMinusCenter, rayOriginMinusCenter) - radius * radius;
+    const Real quadA = dot(ray.direction, ray.direction);
+    const Real quadB = 2.0 * dot(ray.direction, rayOriginMinusCenter);
+    const Real quadC = dot(rayOriginMinusCenter, rayOriginMinusCenter) - radius * radius;
 
-    double t1, t2;
-
-    if (!solveQuadratic(quadA, quadB, quadC, &t1, &t2))
-    {
-        return false; // No hits.
-    }
+    return solveQuadratic(quadA, quadB, quadC, t1, t2);
+}
 
-    double hitTime = ((type == Entry) ? t1 : t2);
 
+void Sphere::setHit(Point3 center, Real radius, Ray &ray, Time hitTime, Hit &hit)
+{
     Point3 hitPoint = ray.pointAtTime(hitTime);
 
     // Compute the normal vector:
@@ -63,14 +138,176 @@ bool Sphere::hit(Ray &ray, Hit &hit, HitType type)
     hit.t = hitTime;
     hit.hitPt = hitPoint;
     hit.normal = frontFace ? outwardNormal : flipVector(outwardNormal);
-    hit.material = material.get();
 
     // Calculate the U, V texture coordinates:
     setSphereUV(&hit.normal, &hit.u, &hit.v);
-    return true;
 }
 
 
+#if defined(__AVX__)
+
+/* 4 x double or 8 x float lanes */
+#ifdef CPHOTON_FLOAT32
+typedef __m256 RealLanes;
+static const int kLanes = 8;
+
+static inline RealLanes broadcastLanes(Real x)
+{
+    return _mm256_set1_ps(x);
+}
+
+/* Loads the first count lanes. The remainder are zero and are not read from memory */
+static inline RealLanes loadLanes(const Real *ptr, int count)
+{
+    const __m256 laneIndex = _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256 mask = _mm256_cmp_ps(laneIndex, _mm256_set1_ps((float)count), _CMP_LT_OQ);
+
+    return _mm256_maskload_ps(ptr, _mm256_castps_si256(mask));
+}
+
+#define addLanes _mm256_add_ps
+#define subtractLanes _mm256_sub_ps
+#define multiplyLanes _mm256_mul_ps
+#define sqrtLanes _mm256_sqrt_ps
+#define compareLanes _mm256_cmp_ps
+#define blendLanes _mm256_blendv_ps
+#define andLanes _mm256_and_ps
+#define storeLanes _mm256_store_ps
+#define maskLanes _mm256_movemask_ps
+#else
+typedef __m256d RealLanes;
+static const int kLanes = 4;
+
+static inline RealLanes broadcastLanes(Real x)
+{
+    return _mm256_set1_pd(x);
+}
+
+/* Loads the first count lanes. The remainder are zero and are not read from memory */
+static inline RealLanes loadLanes(const Real *ptr, int count)
+{
+    const __m256d laneIndex = _mm256_set_pd(3, 2, 1, 0);
+    const __m256d mask = _mm256_cmp_pd(laneIndex, _mm256_set1_pd((double)count), _CMP_LT_OQ);
+
+    return _mm256_maskload_pd(ptr, _mm256_castpd_si256(mask));
+}
+
+#define addLanes _mm256_add_pd
+#define subtractLanes _mm256_sub_pd
+#define multiplyLanes _mm256_mul_pd
+#define sqrtLanes _mm256_sqrt_pd
+#define compareLanes _mm256_cmp_pd
+#define blendLanes _mm256_blendv_pd
+#define andLanes _mm256_and_pd
+#define storeLanes _mm256_store_pd
+#define maskLanes _mm256_movemask_pd
+#endif
+
+int Sphere::intersectPacked(const Real *centerX, const Real *centerY, const Real *centerZ, const Real *radius,
+                            int count, Ray &ray, Time tmin, Time tmax, Time *hitTime)
+{
+    // Same quadratic as sphereHitTimes() with kLanes spheres at a time.
+    const RealLanes dx = broadcastLanes(ray.direction.x);
+    const RealLanes dy = broadcastLanes(ray.direction.y);
+    const RealLanes dz = broadcastLanes(ray.direction.z);
+
+    const Real quadAScalar = dot(ray.direction, ray.direction);
+    const RealLanes quadA = broadcastLanes(quadAScalar);
+    const RealLanes invTwoQuadA = broadcastLanes(1.0 / (2.0 * quadAScalar));
+    const RealLanes four = broadcastLanes(4.0);
+    const RealLanes zero = broadcastLanes(0.0);
+    const RealLanes infinity = broadcastLanes(INFINITY);
+
+    int iClosest = -1;
+    Time tClosest = tmax;
+
+    for (int iBase = 0; iBase < count; iBase += kLanes)
+    {
+        const int numLanes = std::min(kLanes, count - iBase);
+
+        const RealLanes ocX = subtractLanes(broadcastLanes(ray.origin.x), loadLanes(centerX + iBase, numLanes));
+        const RealLanes ocY = subtractLanes(broadcastLanes(ray.origin.y), loadLanes(centerY + iBase, numLanes));
+        const RealLanes ocZ = subtractLanes(broadcastLanes(ray.origin.z), loadLanes(centerZ + iBase, numLanes));
+        const RealLanes r = loadLanes(radius + iBase, numLanes);
+
+        const RealLanes dDotOC =
+            addLanes(addLanes(multiplyLanes(dx, ocX), multiplyLanes(dy, ocY)), multiplyLanes(dz, ocZ));
+        const RealLanes quadB = addLanes(dDotOC, dDotOC);
+        const RealLanes quadC = subtractLanes(
+            addLanes(addLanes(multiplyLanes(ocX, ocX), multiplyLanes(ocY, ocY)), multiplyLanes(ocZ, ocZ)),
+            multiplyLanes(r, r));
+
+        const RealLanes discriminant =
+            subtractLanes(multiplyLanes(quadB, quadB), multiplyLanes(four, multiplyLanes(quadA, quadC)));
+        const RealLanes hasRoots = compareLanes(discriminant, zero, _CMP_GE_OQ);
+
+        // Most rays miss most spheres.
+        if (maskLanes(hasRoots) == 0) continue;
+
+        const RealLanes sqrtDiscriminant = sqrtLanes(andLanes(discriminant, hasRoots));
+        const RealLanes t1 = multiplyLanes(subtractLanes(subtractLanes(zero, quadB), sqrtDiscriminant), invTwoQuadA);
+        const RealLanes t2 = multiplyLanes(addLanes(subtractLanes(zero, quadB), sqrtDiscriminant), invTwoQuadA);
+
+        // Entry if it is in range, otherwise exit (case: inside sphere).
+        const RealLanes laneMin = broadcastLanes(tmin), laneMax = broadcastLanes(tClosest);
+        const RealLanes t1Valid =
+            andLanes(compareLanes(t1, laneMin, _CMP_GT_OQ), compareLanes(t1, laneMax, _CMP_LT_OQ));
+        const RealLanes t2Valid =
+            andLanes(compareLanes(t2, laneMin, _CMP_GT_OQ), compareLanes(t2, laneMax, _CMP_LT_OQ));
+
+        RealLanes t = blendLanes(blendLanes(infinity, t2, t2Valid), t1, t1Valid);
+        t = blendLanes(infinity, t, hasRoots);
+
+        alignas(32) Real times[kLanes];
+        storeLanes(times, t);
+
+        for (int iLane = 0; iLane < numLanes; ++iLane)
+        {
+            if (times[iLane] < tClosest)
+            {
+                tClosest = times[iLane];
+                iClosest = iBase + iLane;
+            }
+        }
+    }
+
+    if (iClosest >= 0) *hitTime = tClosest;
+    return iClosest;
+}
+
+#else
+
+int Sphere::intersectPacked(const Real *centerX, const Real *centerY, const Real *centerZ, const Real *radius,
+                            int count, Ray &ray, Time tmin, Time tmax, Time *hitTime)
+{
+    int iClosest = -1;
+    Time tClosest = tmax;
+
+    for (int i = 0; i < count; ++i)
+    {
+        Real t1, t2;
+
+        if (!sphereHitTimes(point3(centerX[i], centerY[i], centerZ[i]), radius[i], ray, &t1, &t2)) continue;
+
+        if (Hit::isValid(t1, tmin, tClosest))
+        {
+            tClosest = t1;
+            iClosest = i;
+        }
+        else if (Hit::isValid(t2, tmin, tClosest))
+        {
+            tClosest = t2;
+            iClosest = i;
+        }
+    }
+
+    if (iClosest >= 0) *hitTime = tClosest;
+    return iClosest;
+}
+
+#endif
+
+
 bool Sphere::boundingBox(AABB *boundingBox)
 {
     Point3 min = point3(center.x - radius, center.y - radius, center.z - radius);
@@ -80,14 +317,23 @@ bool Sphere::boundingBox(AABB *boundingBox)
 }
 
 
+void Sphere::compile(PrimitiveArrays &arrays)
+{
+    AABB box;
+    boundingBox(&box);
+
+    arrays.addSphere(center, radius, material, box);
+}
+
+
 /// Calculate the texture coordinates which are in range [0, 1] using the outward
 /// normal calculated from the hit. We are using spherical polar coordinates with
 /// theta being the angle from the +y axis and phi being the anticlockwise angle
 /// starting from the +x axis.
-void setSphereUV(Vector3 *outwardNormal, double *u, double *v)
+void setSphereUV(Vector3 *outwardNormal, Real *u, Real *v)
 {
-    const double theta = acos(-outwardNormal->y);
-    const double phi = atan2(-outwardNormal->z, outwardNormal->x) + M_PI;
+    const Real theta = acos(-outwardNormal->y);
+    const Real phi = atan2(-outwardNormal->z, outwardNormal->x) + M_PI;
 
     *u = phi / (2.0 * M_PI);
     *v = theta / M_PI;
@@ -22,16 +22,38 @@ class Sphere : public Primitive
 {
 public:
     Sphere() = delete;
-    Sphere(Point3 center, double radius, std::shared_ptr<Material> material);
+    Sphere(Point3 center, Real radius, MaterialId material);
+
+    using Primitive::hit;
 
     /* Returns the entry or exit hit time */
     bool hit(Ray &ray, Hit &hit, HitType type) override;
 
+    /* Returns the closest hit in range (tmin, tmax) */
+    bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override;
+
     bool boundingBox(AABB *boundingBox) override;
 
+    void compile(PrimitiveArrays &arrays) override;
+
+    /* Intersection kernels shared with the compiled scene. NB: these do not set hit.material */
+    static bool intersect(Point3 center, Real radius, Ray &ray, Hit &hit, HitType type);
+    static bool intersect(Point3 center, Real radius, Ray &ray, Time tmin, Time tmax, Hit &hit);
+    static bool intersect(Point3 center, Real radius, Ray &ray, Time tmin, Time tmax, Time *hitTime);
+
+    /*
+     * Packed kernel for count spheres stored as arrays. Returns the index of the closest sphere hit in range
+     * (tmin, tmax) and sets hitTime, or returns -1. Uses AVX when available (bazel build --config=simd).
+     */
+    static int intersectPacked(const Real *centerX, const Real *centerY, const Real *centerZ, const Real *radius,
+                               int count, Ray &ray, Time tmin, Time tmax, Time *hitTime);
+
+    /* Populates the hit (except the material) for a known hit time */
+    static void setHit(Point3 center, Real radius, Ray &ray, Time hitTime, Hit &hit);
+
 protected:
     Point3 center;
-    double radius;
+    Real radius;
 };
 
-void setSphereUV(Vector3 *outwardNormal, double *u, double *v);
+void setSphereUV(Vector3 *outwardNormal, Real *u, Real *v);
@@ -8,14 +8,37 @@
  */
 
 #include "Triangle.hpp"
+#include "PrimitiveArrays.hpp"
+#include <algorithm>
 
-Triangle::Triangle(Point3 v0_, Point3 v1_, Point3 v2_, std::shared_ptr<Material> material_)
+Triangle::Triangle(Point3 v0_, Point3 v1_, Point3 v2_, MaterialId material_)
     : Primitive(material_), v0(v0_), v1(v1_), v2(v2_)
 {
     normal = cross(subtractVectors(v1, v0), subtractVectors(v2, v1));
 }
 
 bool Triangle::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    if (!intersect(v0, v1, v2, normal, ray, tmin, tmax, hit)) return false;
+
+    hit.material = material;
+    return true;
+}
+
+
+bool Triangle::intersect(Point3 v0, Point3 v1, Point3 v2, Vector3 normal, Ray &ray, Time tmin, Time tmax, Hit &hit)
+{
+    Real hitTime, u, v;
+
+    if (!intersect(v0, v1, v2, normal, ray, tmin, tmax, &hitTime, &u, &v)) return false;
+
+    setHit(normal, ray, hitTime, u, v, hit);
+    return true;
+}
+
+
+bool Triangle::intersect(Point3 v0, Point3 v1, Point3 v2, Vector3 normal, Ray &ray, Time tmin, Time tmax,
+                         Time *hitTime, Real *u, Real *v)
 {
     // Triangle can be defined in terms of coordinates (u, v):
     // T(u, v) = (1 - u - v) * V0 + u * V1 + v * V2
@@ -45,9 +68,7 @@ bool Triangle::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
     //
     // where P = D x E2, Q = T x E1
 
-    double hitTime = 0.0;
-
-    if (intersectionWithPlane(v0, normal, ray, &hitTime) && Hit::isValid(hitTime, tmin, tmax))
+    if (intersectionWithPlane(v0, normal, ray, hitTime) && Hit::isValid(*hitTime, tmin, tmax))
     {
         Vector3 vecO = ray.origin;
         Vector3 vecD = ray.direction;
@@ -58,38 +79,39 @@ bool Triangle::hit(Ray &ray, Time tmin, Time tmax, Hit &hit)
 
         Vector3 vecP = cross(vecD, vecE2);
 
-        const double invPDotE1 = 1.0 / dot(vecP, vecE1);
+        const Real invPDotE1 = 1.0 / dot(vecP, vecE1);
 
-        const double u = invPDotE1 * dot(vecP, vecT);
+        *u = invPDotE1 * dot(vecP, vecT);
 
-        if (u < 0.0 || u > 1.0) return false;
+        if (*u < 0.0 || *u > 1.0) return false;
 
         Vector3 vecQ = cross(vecT, vecE1);
 
-        const double v = invPDotE1 * dot(vecQ, vecD);
+        *v = invPDotE1 * dot(vecQ, vecD);
 
-        if (v < 0.0 || u + v > 1.0) return false;
+        return (*v >= 0.0 && *u + *v <= 1.0);
+    }
 
-        // Compute the normal vector:
-        Point3 hitPoint = ray.pointAtTime(hitTime);
-        Vector3 outwardNormal = normal;
+    return false;
+}
 
-        // Are we hitting the outside surface or are we hitting the inside?
-        const bool frontFace = (dot(ray.direction, outwardNormal) < 0.0);
 
-        hit.frontFace = frontFace;
-        hit.t = hitTime;
-        hit.hitPt = hitPoint;
-        hit.normal = frontFace ? outwardNormal : flipVector(outwardNormal);
-        hit.material = material.get();
+void Triangle::setHit(Vector3 normal, Ray &ray, Time hitTime, Real u, Real v, Hit &hit)
+{
+    // Compute the normal vector:
+    Point3 hitPoint = ray.pointAtTime(hitTime);
+    Vector3 outwardNormal = normal;
 
-        hit.u = u;
-        hit.v = v;
+    // Are we hitting the outside surface or are we hitting the inside?
+    const bool frontFace = (dot(ray.direction, outwardNormal) < 0.0);
 
-        return true;
-    }
+    hit.frontFace = frontFace;
+    hit.t = hitTime;
+    hit.hitPt = hitPoint;
+    hit.normal = frontFace ? outwardNormal : flipVector(outwardNormal);
 
-    return false;
+    hit.u = u;
+    hit.v = v;
 }
 
 
@@ -101,5 +123,22 @@ bool Triangle::boundingBox(AABB *outputBox)
     outputBox->addPoint(v1);
     outputBox->addPoint(v2);
 
+    // Pad the box so that it is not flat for an axis-aligned triangle (AABB::hit misses boxes with zero thickness).
+    // NB: the padding is relative to the triangle's size so that the box stays tight at any scale.
+    const Vector3 extent = subtractVectors(outputBox->maxPt(), outputBox->minPt());
+    const Real delta = Real(1e-4) * std::max(extent.x, std::max(extent.y, extent.z));
+
+    outputBox->minPt() = subtractVectors(outputBox->minPt(), vector3(delta, delta, delta));
+    outputBox->maxPt() = addVectors(outputBox->maxPt(), vector3(delta, delta, delta));
+
     return true;
-}
\ No newline at end of file
+}
+
+
+void Triangle::compile(PrimitiveArrays &arrays)
+{
+    AABB box;
+    boundingBox(&box);
+
+    arrays.addTriangle(v0, v1, v2, normal, material, box);
+}
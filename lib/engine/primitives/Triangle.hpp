@@ -22,13 +22,22 @@ class Triangle : public Primitive
 {
 public:
     Triangle() = delete;
-    Triangle(Point3 v0_, Point3 v1_, Point3 v2_, std::shared_ptr<Material> material_);
-    ~Triangle() override = default;
+    Triangle(Point3 v0_, Point3 v1_, Point3 v2_, MaterialId material_);
 
     bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override;
 
     bool boundingBox(AABB *boundingBox) override;
 
+    void compile(PrimitiveArrays &arrays) override;
+
+    /* Intersection kernels shared with the compiled scene. NB: these do not set hit.material */
+    static bool intersect(Point3 v0, Point3 v1, Point3 v2, Vector3 normal, Ray &ray, Time tmin, Time tmax, Hit &hit);
+    static bool intersect(Point3 v0, Point3 v1, Point3 v2, Vector3 normal, Ray &ray, Time tmin, Time tmax,
+                          Time *hitTime, Real *u, Real *v);
+
+    /* Populates the hit (except the material) for a known hit time and barycentric coordinates (u, v) */
+    static void setHit(Vector3 normal, Ray &ray, Time hitTime, Real u, Real v, Hit &hit);
+
 protected:
     Point3 v0, v1, v2;
     Vector3 normal;
@@ -8,18 +8,19 @@
  */
 
 #include "CheckerTexture.hpp"
+#include "TextureTable.hpp"
 
-CheckerTexture::CheckerTexture(std::shared_ptr<Texture> odd_, std::shared_ptr<Texture> even_) : odd(odd_), even(even_)
+CheckerTexture::CheckerTexture(TextureId odd_, TextureId even_) : odd(odd_), even(even_)
 {
 }
 
 
-Color3 CheckerTexture::value(double u, double v, Point3 *hitPt)
+Color3 CheckerTexture::value(const TextureTable &textures, Real u, Real v, Point3 *hitPt) const
 {
-    const double sines = sin(10.0 * hitPt->x) * sin(10.0 * hitPt->y) * sin(10.0 * hitPt->z);
+    const Real sines = sin(10.0 * hitPt->x) * sin(10.0 * hitPt->y) * sin(10.0 * hitPt->z);
 
     if (sines < 0.0)
-        return odd->value(u, v, hitPt);
+        return textures.value(odd, u, v, hitPt);
     else
-        return even->value(u, v, hitPt);
+        return textures.value(even, u, v, hitPt);
 }
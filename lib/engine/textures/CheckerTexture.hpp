@@ -9,18 +9,32 @@
 
 #pragma once
 #include "Texture.hpp"
-#include <memory>
+
+class TextureTable;
 
 /* A chessboard of two repeating textures */
-class CheckerTexture : public Texture
+class CheckerTexture
 {
 public:
     CheckerTexture() = delete;
-    CheckerTexture(std::shared_ptr<Texture> odd, std::shared_ptr<Texture> even);
+    CheckerTexture(TextureId odd, TextureId even);
+
+    /* Returns the color at a given point. The odd and even textures are looked up in textures */
+    Color3 value(const TextureTable &textures, Real u, Real v, Point3 *hitPt) const;
+
+    /* Returns the odd texture */
+    TextureId oddTexture() const
+    {
+        return odd;
+    }
 
-    Color3 value(double u, double v, Point3 *hitPt) override;
+    /* Returns the even texture */
+    TextureId evenTexture() const
+    {
+        return even;
+    }
 
 protected:
-    std::shared_ptr<Texture> odd{nullptr};
-    std::shared_ptr<Texture> even{nullptr};
+    TextureId odd;
+    TextureId even;
 };
\ No newline at end of file
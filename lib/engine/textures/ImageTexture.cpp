@@ -25,7 +25,7 @@ ImageTexture::ImageTexture(uint8_t *bytes_, size_t pixelsWide_, size_t pixelsHig
 }
 
 
-Color3 ImageTexture::value(double u, double v, Point3 *hitPt)
+Color3 ImageTexture::value(Real u, Real v, Point3 *hitPt) const
 {
     if (!bytes) return color3(1, 1, 0);
 
@@ -38,7 +38,7 @@ Color3 ImageTexture::value(double u, double v, Point3 *hitPt)
     if (i >= pixelsWide) i = pixelsWide - 1;
     if (j >= pixelsHigh) j = pixelsHigh - 1;
 
-    const double invMaxByte = 1.0 / 255.0;
+    const Real invMaxByte = 1.0 / 255.0;
 
     uint8_t *pixels = bytes + (j * bytesPerRow + i * bytesPerPixel);
 
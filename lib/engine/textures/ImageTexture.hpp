@@ -11,13 +11,14 @@
 #include "Texture.hpp"
 #include <cstdint>
 
-class ImageTexture : public Texture
+class ImageTexture
 {
 public:
     ImageTexture() = delete;
     ImageTexture(uint8_t *bytes, size_t pixelsWide, size_t pixelsHigh, size_t bitsPerPixel);
 
-    Color3 value(double u, double v, Point3 *hitPt) override;
+    /* Returns the color at a given point */
+    Color3 value(Real u, Real v, Point3 *hitPt) const;
 
 protected:
     uint8_t *bytes{nullptr};
@@ -30,9 +30,3 @@ SolidTexture::SolidTexture(PresetColor colorType)
             break;
     }
 }
-
-
-Color3 SolidTexture::value(double u, double v, Point3 *hitPt)
-{
-    return color;
-}
@@ -15,7 +15,7 @@ extern "C"
 #include "utility/Vector3.h"
 }
 
-class SolidTexture : public Texture
+class SolidTexture
 {
 public:
     SolidTexture() = delete;
@@ -30,8 +30,11 @@ public:
 
     SolidTexture(PresetColor colorType);
 
-    // TODO: - would be better if we could return a reference.
-    Color3 value(double u, double v, Point3 *hitPt) override;
+    /* Returns the color at a given point */
+    const Color3 &value(Real u, Real v, Point3 *hitPt) const
+    {
+        return color;
+    }
 
 protected:
     Color3 color;
@@ -8,20 +8,20 @@
  */
 
 #pragma once
+#include <cstdint>
 
 extern "C"
 {
 #include "utility/Vector3.h"
 }
 
-/* Base texture class. */
-class Texture
-{
-public:
-    /* Returns the color at a given point */
-    virtual Color3 value(double u, double v, Point3 *hitPt) = 0;
+/** Index of a texture in a TextureTable. */
+using TextureId = uint32_t;
 
-protected:
-    /* NB: protect to avoid default initialization. */
-    Texture() = default;
+/** Texture type tags used to look up texture values without virtual calls. */
+enum class TextureType : uint8_t
+{
+    Solid,
+    Checker,
+    Image
 };
\ No newline at end of file
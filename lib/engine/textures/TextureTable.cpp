@@ -0,0 +1,79 @@
+/**
+ * @file TextureTable.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "TextureTable.hpp"
+#include <stdexcept>
+
+
+TextureId TextureTable::addEntry(TextureType type, size_t index)
+{
+    if (entries.size() >= UINT32_MAX)
+    {
+        throw std::length_error("too many textures");
+    }
+
+    entries.push_back({.type = type, .index = (uint32_t)index});
+    return (TextureId)(entries.size() - 1);
+}
+
+
+TextureId TextureTable::addSolid(Color3 color)
+{
+    const TextureId id = addEntry(TextureType::Solid, solids.size());
+    solids.emplace_back(color);
+    return id;
+}
+
+
+TextureId TextureTable::addSolid(SolidTexture::PresetColor colorType)
+{
+    const TextureId id = addEntry(TextureType::Solid, solids.size());
+    solids.emplace_back(colorType);
+    return id;
+}
+
+
+TextureId TextureTable::addChecker(TextureId odd, TextureId even)
+{
+    // Checkers can only reference existing textures so the table cannot contain cycles.
+    if (odd >= entries.size() || even >= entries.size())
+    {
+        throw std::out_of_range("invalid checker texture id");
+    }
+
+    const TextureId id = addEntry(TextureType::Checker, checkers.size());
+    checkers.emplace_back(odd, even);
+    return id;
+}
+
+
+TextureId TextureTable::addImage(uint8_t *bytes, size_t pixelsWide, size_t pixelsHigh, size_t bitsPerPixel)
+{
+    const TextureId id = addEntry(TextureType::Image, images.size());
+    images.emplace_back(bytes, pixelsWide, pixelsHigh, bitsPerPixel);
+    return id;
+}
+
+
+Color3 TextureTable::value(TextureId id, Real u, Real v, Point3 *hitPt) const
+{
+    const Entry &entry = entries[id];
+
+    switch (entry.type)
+    {
+        case TextureType::Solid:
+            return solids[entry.index].value(u, v, hitPt);
+        case TextureType::Checker:
+            return checkers[entry.index].value(*this, u, v, hitPt);
+        case TextureType::Image:
+            return images[entry.index].value(u, v, hitPt);
+    }
+
+    return color3(0, 0, 0);
+}
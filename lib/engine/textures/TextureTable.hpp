@@ -0,0 +1,66 @@
+/**
+ * @file TextureTable.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "CheckerTexture.hpp"
+#include "ImageTexture.hpp"
+#include "SolidTexture.hpp"
+#include "Texture.hpp"
+#include <vector>
+
+/**
+ * Flat table of the textures used by a scene. Textures are referenced by index (TextureId) and stored by value in one
+ * array per type so that looking up a texture value is a switch on the type rather than a virtual call.
+ */
+class TextureTable
+{
+public:
+    TextureId addSolid(Color3 color);
+    TextureId addSolid(SolidTexture::PresetColor colorType);
+
+    /** NB: odd and even must already be in the table. */
+    TextureId addChecker(TextureId odd, TextureId even);
+
+    /** NB: the image bytes are not copied and must outlive the table. */
+    TextureId addImage(uint8_t *bytes, size_t pixelsWide, size_t pixelsHigh, size_t bitsPerPixel);
+
+    /** Returns the color of texture id at a given point. */
+    Color3 value(TextureId id, Real u, Real v, Point3 *hitPt) const;
+
+    /** Returns the type of texture id. */
+    TextureType type(TextureId id) const
+    {
+        return entries.at(id).type;
+    }
+
+    /** Returns the number of textures. */
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+protected:
+    friend class SceneCache;
+
+    struct Entry
+    {
+        TextureType type;
+
+        /* Index in the array for the type */
+        uint32_t index;
+    };
+
+    TextureId addEntry(TextureType type, size_t index);
+
+    std::vector<Entry> entries;
+
+    std::vector<SolidTexture> solids;
+    std::vector<CheckerTexture> checkers;
+    std::vector<ImageTexture> images;
+};
@@ -11,4 +11,5 @@
 #include "CheckerTexture.hpp"
 #include "ImageTexture.hpp"
 #include "SolidTexture.hpp"
-#include "Texture.hpp"
\ No newline at end of file
+#include "Texture.hpp"
+#include "TextureTable.hpp"
\ No newline at end of file
@@ -8,55 +8,368 @@
  */
 
 #include "logger/Logger.h"
+#include <pthread.h>
 #include <stdarg.h>
-#include <stdio.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
-static LogLevel gThresholdLogLevel = LogLevelInfo;
-static bool gSingleLineMode = false;
+/* Records in a thread's ring (a power of two) */
+#define kRingCapacity 128
+
+/* Writer thread's sleep between drains when busy and the maximum when idle */
+#define kMinWriterSleepNs 1000000
+#define kMaxWriterSleepNs 50000000
+
+typedef struct
+{
+    uint64_t sequence; /* Order of the messages across all threads */
+    LogLevel level;
+    bool singleLine;
+    char message[LOG_MAX_MESSAGE_SIZE];
+} LogRecord;
+
+/**
+ * Single-producer single-consumer ring of records. The owning thread writes records at head and the writer reads them
+ * at tail. Rings are never freed: they are released when their thread exits and reused once they are empty.
+ */
+typedef struct logRing_t
+{
+    _Alignas(64) _Atomic(uint64_t) head;
+    _Alignas(64) _Atomic(uint64_t) tail;
+    atomic_bool isOwned;
+    struct logRing_t *next; /* Set before the ring is added to the list */
+    LogRecord records[kRingCapacity];
+} LogRing;
+
+static void initLogger(void);
+static void *writeLoop(void *args);
+static void flushAtExit(void);
+static LogRing *acquireRing(void);
+static void releaseRing(void *ring);
+static int drainRings(void);
+static void writeDirect(const LogRecord *record);
+static void writeRecord(FILE *stream, const LogRecord *record);
+static void formatMessage(char *buffer, const char *format, va_list args);
+
+static atomic_int gThresholdLogLevel = LogLevelInfo;
+static atomic_bool gSingleLineMode = false;
+
+static _Atomic(LogRing *) gRings = NULL;
+static _Thread_local LogRing *tRing = NULL;
+
+static _Atomic(uint64_t) gSequence = 0;
+static _Atomic(uint64_t) gNumDropped = 0;
+
+static pthread_once_t gInitOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t gRingKey;
+
+/* Guards the consumer state: the rings' tails and the stream (never taken by the threads which log) */
+static pthread_mutex_t gDrainMutex = PTHREAD_MUTEX_INITIALIZER;
+static FILE *gStream = NULL;
+static bool gLastWasSingleLine = false;
+
+/* Set at exit once the writer has stopped (written with the drain mutex held) */
+static atomic_bool gIsStopped = false;
+
+static const char *nameForLevel[] = {"\033[33mDEBUG:\033[0m", "\033[32mINFO:\033[0m", "\033[35mWARNING:\033[0m",
+                                     "\033[31mERROR:\033[0m", "\033[31mFAILED:\033[0m"};
 
 void SetThresholdLogLevel(LogLevel newThresholdLevel)
 {
-    gThresholdLogLevel = newThresholdLevel;
+    atomic_store_explicit(&gThresholdLogLevel, newThresholdLevel, memory_order_relaxed);
 }
 
 void SetSingleLineLogMode(bool singleLineMode)
 {
-    gSingleLineMode = singleLineMode;
+    atomic_store_explicit(&gSingleLineMode, singleLineMode, memory_order_relaxed);
+}
+
+void SetLogOutput(FILE *stream)
+{
+    FlushLogger();
+
+    pthread_mutex_lock(&gDrainMutex);
+    gStream = stream;
+    gLastWasSingleLine = false;
+    pthread_mutex_unlock(&gDrainMutex);
 }
 
 void Logger(LogLevel level, const char *format, ...)
 {
-    if (level < gThresholdLogLevel) return;
+    if (level < atomic_load_explicit(&gThresholdLogLevel, memory_order_relaxed)) return;
 
-    static char *nameForLevel[] = {"\033[33mDEBUG:\033[0m", "\033[32mINFO:\033[0m", "\033[35mWARNING:\033[0m",
-                                   "\033[31mERROR:\033[0m", "\033[31mFAILED:\033[0m"};
+    pthread_once(&gInitOnce, initLogger);
 
-    const int kBufferSize = 256;
+    // NB: the sequence is taken before formatting but records from other threads may still be published first.
+    const uint64_t sequence = atomic_fetch_add_explicit(&gSequence, 1, memory_order_relaxed);
 
-    char buffer[kBufferSize];
+    LogRing *ring = atomic_load_explicit(&gIsStopped, memory_order_relaxed) ? NULL : acquireRing();
 
     va_list args;
     va_start(args, format);
-    int nwritten = vsnprintf(buffer, kBufferSize, format, args);
+
+    if (!ring) // Stopped or out of memory. Write directly.
+    {
+        LogRecord record = {.sequence = sequence, .level = level, .singleLine = false};
+        formatMessage(record.message, format, args);
+        va_end(args);
+
+        writeDirect(&record);
+        return;
+    }
+
+    // NB: only this thread writes the head.
+    const uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    LogRecord *record = &ring->records[head & (kRingCapacity - 1)];
+
+    while (head - atomic_load_explicit(&ring->tail, memory_order_acquire) >= kRingCapacity)
+    {
+        if (level < LogLevelError)
+        {
+            atomic_fetch_add_explicit(&gNumDropped, 1, memory_order_relaxed);
+            va_end(args);
+            return;
+        }
+
+        // Make space. If the logger has stopped, the ring is never drained so the error is written directly.
+        if (drainRings() < 0)
+        {
+            LogRecord direct = {.sequence = sequence, .level = level, .singleLine = false};
+            formatMessage(direct.message, format, args);
+            va_end(args);
+
+            writeDirect(&direct);
+            return;
+        }
+    }
+
+    formatMessage(record->message, format, args);
     va_end(args);
 
-    bool ok = (nwritten > 0 && nwritten < kBufferSize);
-    if (!ok)
+    record->level = level;
+    record->singleLine = atomic_load_explicit(&gSingleLineMode, memory_order_relaxed);
+    record->sequence = sequence;
+
+    // Publish the record to the writer.
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    // Errors are written before returning (e.g. in case of an abort). NB: a stopped logger does not drain the ring.
+    if (level >= LogLevelError && drainRings() < 0) writeDirect(record);
+}
+
+void FlushLogger(void)
+{
+    (void)drainRings();
+}
+
+static void initLogger(void)
+{
+    pthread_key_create(&gRingKey, releaseRing);
+
+    pthread_t writer;
+
+    if (pthread_create(&writer, NULL, writeLoop, NULL) == 0)
+    {
+        pthread_detach(writer);
+    }
+
+    atexit(flushAtExit);
+}
+
+static void *writeLoop(void *args)
+{
+    long sleepNs = kMinWriterSleepNs;
+
+    for (;;)
+    {
+        const int numWritten = drainRings();
+        if (numWritten < 0) return NULL; // Stopped.
+
+        // Back off while there is nothing to write.
+        if (numWritten > 0)
+            sleepNs = kMinWriterSleepNs;
+        else if (2 * sleepNs < kMaxWriterSleepNs)
+            sleepNs *= 2;
+        else
+            sleepNs = kMaxWriterSleepNs;
+
+        const struct timespec duration = {.tv_sec = 0, .tv_nsec = sleepNs};
+        nanosleep(&duration, NULL);
+    }
+}
+
+static void flushAtExit(void)
+{
+    FlushLogger();
+
+    // Stop the writer before the streams are closed.
+    pthread_mutex_lock(&gDrainMutex);
+
+    if (gLastWasSingleLine) fputc('\n', gStream ? gStream : stdout);
+    gLastWasSingleLine = false;
+
+    atomic_store_explicit(&gIsStopped, true, memory_order_relaxed);
+
+    pthread_mutex_unlock(&gDrainMutex);
+}
+
+static LogRing *acquireRing(void)
+{
+    if (tRing) return tRing;
+
+    // Reuse a ring released by a thread which has exited once the writer has emptied it.
+    for (LogRing *ring = atomic_load_explicit(&gRings, memory_order_acquire); ring; ring = ring->next)
     {
-        fprintf(stderr, "error: failed to write to log buffer\n");
-        fflush(stdout);
-        abort();
+        bool isOwned = false;
+
+        if (atomic_compare_exchange_strong_explicit(&ring->isOwned, &isOwned, true, memory_order_acquire,
+                                                    memory_order_relaxed))
+        {
+            if (atomic_load_explicit(&ring->tail, memory_order_acquire) ==
+                atomic_load_explicit(&ring->head, memory_order_relaxed))
+            {
+                tRing = ring;
+                break;
+            }
+
+            atomic_store_explicit(&ring->isOwned, false, memory_order_release);
+        }
     }
 
-    if (gSingleLineMode)
+    if (!tRing)
+    {
+        LogRing *ring = calloc(1, sizeof(LogRing));
+        if (!ring) return NULL;
+
+        atomic_init(&ring->head, 0);
+        atomic_init(&ring->tail, 0);
+        atomic_init(&ring->isOwned, true);
+
+        ring->next = atomic_load_explicit(&gRings, memory_order_relaxed);
+
+        while (!atomic_compare_exchange_weak_explicit(&gRings, &ring->next, ring, memory_order_release,
+                                                      memory_order_relaxed))
+            ;
+
+        tRing = ring;
+    }
+
+    // Release the ring when the thread exits.
+    pthread_setspecific(gRingKey, tRing);
+
+    return tRing;
+}
+
+static void releaseRing(void *ring)
+{
+    // NB: any records still in the ring are written by the writer as usual.
+    atomic_store_explicit(&((LogRing *)ring)->isOwned, false, memory_order_release);
+}
+
+/// Writes the records in the rings in order of their sequence. Returns the number written or -1 if stopped.
+static int drainRings(void)
+{
+    pthread_mutex_lock(&gDrainMutex);
+
+    if (atomic_load_explicit(&gIsStopped, memory_order_relaxed))
     {
-        fprintf(stdout, "\r%s %s", nameForLevel[level], buffer);
-        fflush(stdout);
+        pthread_mutex_unlock(&gDrainMutex);
+        return -1;
+    }
+
+    FILE *stream = gStream ? gStream : stdout;
+    int numWritten = 0;
+
+    const uint64_t numDropped = atomic_exchange_explicit(&gNumDropped, 0, memory_order_relaxed);
+
+    for (;;)
+    {
+        // Merge the rings: write the oldest of their next records.
+        LogRing *oldestRing = NULL;
+        const LogRecord *oldest = NULL;
+
+        for (LogRing *ring = atomic_load_explicit(&gRings, memory_order_acquire); ring; ring = ring->next)
+        {
+            const uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            if (tail == atomic_load_explicit(&ring->head, memory_order_acquire)) continue;
+
+            const LogRecord *record = &ring->records[tail & (kRingCapacity - 1)];
+
+            if (!oldest || record->sequence < oldest->sequence)
+            {
+                oldestRing = ring;
+                oldest = record;
+            }
+        }
+
+        if (!oldest) break;
+
+        writeRecord(stream, oldest);
+        ++numWritten;
+
+        // Return the record to its thread.
+        atomic_fetch_add_explicit(&oldestRing->tail, 1, memory_order_release);
+    }
+
+    if (numDropped > 0)
+    {
+        LogRecord record = {.sequence = 0, .level = LogLevelWarning, .singleLine = false};
+        snprintf(record.message, LOG_MAX_MESSAGE_SIZE, "%llu log messages dropped", (unsigned long long)numDropped);
+
+        writeRecord(stream, &record);
+        ++numWritten;
+    }
+
+    if (numWritten > 0) fflush(stream);
+
+    pthread_mutex_unlock(&gDrainMutex);
+    return numWritten;
+}
+
+/// Writes a record which is not in a ring.
+static void writeDirect(const LogRecord *record)
+{
+    pthread_mutex_lock(&gDrainMutex);
+
+    FILE *stream = gStream ? gStream : stdout;
+
+    writeRecord(stream, record);
+    fflush(stream);
+
+    pthread_mutex_unlock(&gDrainMutex);
+}
+
+static void writeRecord(FILE *stream, const LogRecord *record)
+{
+    if (record->singleLine)
+    {
+        fprintf(stream, "\r%s %s", nameForLevel[record->level], record->message);
     }
     else
     {
-        fprintf(stdout, "%s %s\n", nameForLevel[level], buffer);
+        // End any single line so that it is not overwritten.
+        if (gLastWasSingleLine) fputc('\n', stream);
+
+        fprintf(stream, "%s %s\n", nameForLevel[record->level], record->message);
+    }
+
+    gLastWasSingleLine = record->singleLine;
+}
+
+static void formatMessage(char *buffer, const char *format, va_list args)
+{
+    const int nwritten = vsnprintf(buffer, LOG_MAX_MESSAGE_SIZE, format, args);
+
+    if (nwritten < 0)
+    {
+        snprintf(buffer, LOG_MAX_MESSAGE_SIZE, "(invalid log message: '%s')", format);
     }
-}
\ No newline at end of file
+    else if (nwritten >= LOG_MAX_MESSAGE_SIZE)
+    {
+        // Truncated. Mark the end.
+        memcpy(buffer + LOG_MAX_MESSAGE_SIZE - 4, "...", 4);
+    }
+}
@@ -9,6 +9,7 @@
 
 #pragma once
 #include <stdbool.h>
+#include <stdio.h>
 
 typedef enum
 {
@@ -19,15 +20,43 @@ typedef enum
     LogLevelFailed
 } LogLevel;
 
+/* Messages are truncated (ending in "...") to fit this size including the terminating null */
+#define LOG_MAX_MESSAGE_SIZE 256
+
+/* Log levels below this are compiled out (debug messages are only kept in builds without NDEBUG) */
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL LogLevelInfo
+#else
+#define LOG_COMPILE_LEVEL LogLevelDebug
+#endif
+#endif
+
 
 void SetThresholdLogLevel(LogLevel level);
 void SetSingleLineLogMode(bool singleLineMode);
 
-// Writes log message to stdout in format: "[logLevel]: message"
-void Logger(LogLevel level, const char *format, ...);
+// Sets the stream which messages are written to (stdout if NULL). Any queued messages are written first.
+void SetLogOutput(FILE *stream);
+
+// Queues a log message which is written to stdout in format: "[logLevel]: message" by a background thread. Each thread
+// has its own lock-free queue. Messages from a thread are written in order while the order across threads is
+// best-effort (by the time of the call). If a thread's queue is full, messages below LogLevelError are dropped (and
+// counted) while errors wait for space and are written before returning. Once the logger has stopped at exit, messages
+// are written directly.
+void Logger(LogLevel level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+// Writes any queued messages and returns once they have been written.
+void FlushLogger(void);
+
+#define LOG_AT_LEVEL(level, ...)                                                                                       \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if ((level) >= LOG_COMPILE_LEVEL) Logger((level), __VA_ARGS__);                                                \
+    } while (0)
 
-#define LogDebug(...) Logger(LogLevelDebug, __VA_ARGS__)
-#define LogInfo(...) Logger(LogLevelInfo, __VA_ARGS__)
-#define LogWarning(...) Logger(LogLevelWarning, __VA_ARGS__)
-#define LogError(...) Logger(LogLevelError, __VA_ARGS__)
-#define LogFailed(...) Logger(LogLevelFailed, __VA_ARGS__)
+#define LogDebug(...) LOG_AT_LEVEL(LogLevelDebug, __VA_ARGS__)
+#define LogInfo(...) LOG_AT_LEVEL(LogLevelInfo, __VA_ARGS__)
+#define LogWarning(...) LOG_AT_LEVEL(LogLevelWarning, __VA_ARGS__)
+#define LogError(...) LOG_AT_LEVEL(LogLevelError, __VA_ARGS__)
+#define LogFailed(...) LOG_AT_LEVEL(LogLevelFailed, __VA_ARGS__)
@@ -0,0 +1,164 @@
+/**
+ * @file ExampleScenes.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "models/ExampleScenes.hpp"
+#include "engine/materials/MaterialTable.hpp"
+#include "engine/primitives/Primitives.hpp"
+#include "engine/textures/SolidTexture.hpp"
+#include <algorithm>
+#include <vector>
+
+static Primitive *makeDarkKnightRoom(Scene &scene, double length, double width, double height);
+static Camera makeRotatedCubesScene(Scene &scene, Real aspectRatio, CSGNode::CSGOperation type);
+
+
+Camera makeBatCaveScene(Scene &scene, Real aspectRatio)
+{
+    SceneArena &arena = scene.arena();
+    MaterialTable &materials = scene.materials();
+
+    Primitive *room = makeDarkKnightRoom(scene, 20, 16.0, 5);
+    scene.addObject(room);
+
+    // Monolith:
+    MaterialId monolithMaterial = materials.addMatte(color3(.01, .01, .01));
+
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 9; j++)
+        {
+            Primitive *cube = arena.make<Cube>(point3(0.5 * i, 0.25 + 0.5 * j, 0), nullptr, 0.5, monolithMaterial);
+            scene.addObject(cube);
+        }
+    }
+
+    return Camera(45.0, aspectRatio, 1, 0, point3(-2.5, 2, 10), point3(0, 2, 0));
+}
+
+
+Camera makeMengerCubeScene(Scene &scene, Real aspectRatio, int8_t maxLevel)
+{
+    SceneArena &arena = scene.arena();
+    MaterialTable &materials = scene.materials();
+
+    // Create the textures:
+    TextureId greyColor = materials.textures().addSolid(color3(0.20, 0.26, 0.35));
+    TextureId goldColor = materials.textures().addSolid(SolidTexture::Gold);
+
+    // Create the materials:
+    MaterialId greyMetal = materials.addMetal(greyColor, 0.2);
+    MaterialId goldLambertian = materials.addMatte(goldColor);
+
+    // Sponge centers by level.
+    const Point3 centers[5] = {point3(-1.5, 0.5, -1.5), point3(1.5, 0.5, -1.5), point3(1.5, 0.5, 1.5),
+                               point3(-1.5, 0.5, 1.5), point3(0, 0.5, 0)};
+
+    for (int8_t level = 0; level <= std::min<int8_t>(maxLevel, 4); ++level)
+    {
+        scene.addObject(arena.make<MengerSponge>(centers[level], 1.0, level, goldLambertian));
+    }
+
+    scene.addObject(arena.make<Plane>(point3(0, 0, 0), vector3(0, 1, 0), greyMetal));
+
+    return Camera(45.0, aspectRatio, 4, 0.0, point3(2, 5, 5), point3(0.2, 0.6, 1.0));
+}
+
+
+Camera makeCubeUnionScene(Scene &scene, Real aspectRatio)
+{
+    return makeRotatedCubesScene(scene, aspectRatio, CSGNode::CSGUnion);
+}
+
+
+Camera makeCubeDifferenceScene(Scene &scene, Real aspectRatio)
+{
+    return makeRotatedCubesScene(scene, aspectRatio, CSGNode::CSGDifference);
+}
+
+
+Camera makeCubeIntersectionScene(Scene &scene, Real aspectRatio)
+{
+    return makeRotatedCubesScene(scene, aspectRatio, CSGNode::CSGIntersection);
+}
+
+
+Camera makeCubeSphereDifferenceScene(Scene &scene, Real aspectRatio)
+{
+    SceneArena &arena = scene.arena();
+    MaterialTable &materials = scene.materials();
+
+    Primitive *cube1 = arena.make<Cube>(point3(0, 0.5, 0), nullptr, 1, materials.addMatte(color3(0, 1, 0)));
+    Primitive *cube2 = arena.make<Cube>(point3(0.5, 1, -0.5), nullptr, 1.0, materials.addMatte(color3(1, 0, 0)));
+
+    Primitive *plane = arena.make<Plane>(point3(0, 0, 0), point3(0, 1, 0), materials.addMatte(color3(0.1, 0.1, 0.1)));
+
+    scene.addObject(arena.make<CSGNode>(cube1, cube2, CSGNode::CSGDifference));
+    scene.addObject(plane);
+
+    return Camera(45.0, aspectRatio, 1, 0, point3(6, 3, 4), point3(0, 1, 0));
+}
+
+
+static Camera makeRotatedCubesScene(Scene &scene, Real aspectRatio, CSGNode::CSGOperation type)
+{
+    SceneArena &arena = scene.arena();
+    MaterialTable &materials = scene.materials();
+
+    Primitive *cube1 = arena.make<Cube>(point3(0.5, 1, 0), arena.makeRotation(vector3(22.5, 0, 0)), 1,
+                                        materials.addMetal(color3(0, 1, 0)));
+    Primitive *cube2 = arena.make<Cube>(point3(0, 1, 0), arena.makeRotation(vector3(-22.5, 0, 0)), 1,
+                                        materials.addMetal(color3(1, 0, 0)));
+
+    Primitive *plane = arena.make<Plane>(point3(0, 0, 0), point3(0, 1, 0), materials.addMatte(color3(0.1, 0.1, 0.1)));
+
+    scene.addObject(arena.make<CSGNode>(cube1, cube2, type));
+    scene.addObject(plane);
+
+    return Camera(45.0, aspectRatio, 1, 0, point3(-2, 3, 4), point3(0, 1, 0));
+}
+
+
+static Primitive *makeDarkKnightRoom(Scene &scene, double length, double width, double height)
+{
+    SceneArena &arena = scene.arena();
+    MaterialTable &materials = scene.materials();
+
+    const double halfRoomW = 0.5 * width;
+    const double halfRoomL = 0.5 * length;
+
+    MaterialId wallMaterial = materials.addMatte(color3(0.05, 0.05, 0.05));
+    MaterialId lightMaterial = materials.addEmitter(color3(.9, .9, .9));
+
+    std::vector<Primitive *> objects;
+
+    objects.push_back(arena.make<Plane>(point3(halfRoomW, 0, 0), vector3(-1, 0, 0), wallMaterial));
+    objects.push_back(arena.make<Plane>(point3(-halfRoomW, 0, 0), vector3(1, 0, 0), wallMaterial));
+    objects.push_back(arena.make<Plane>(point3(0, 0, -halfRoomL), vector3(0, 0, 1), wallMaterial));
+    objects.push_back(arena.make<Plane>(point3(0, 0, halfRoomL), vector3(0, 0, -1), wallMaterial));
+    objects.push_back(arena.make<Plane>(point3(0, height, 0), vector3(0, -1, 0), wallMaterial));
+    objects.push_back(arena.make<Plane>(point3(0, 0, 0), vector3(0, 1, 0), wallMaterial));
+
+    // Create all of the lights on the ceiling:
+    for (int i = -halfRoomW; i <= halfRoomW; i += 1)
+    {
+        for (int j = -halfRoomL; j <= halfRoomL; j += 1)
+        {
+            Primitive *floorPanel = arena.make<Cube>(point3(i + 0.495, -0.490, j + 0.495), nullptr, 0.99, wallMaterial);
+
+            Primitive *ceilingPanel =
+                arena.make<Cube>(point3(i + 0.495, height + .494, j + 0.495), nullptr, 0.99, lightMaterial);
+
+            objects.push_back(floorPanel);
+            objects.push_back(ceilingPanel);
+        }
+    }
+
+    objects.shrink_to_fit();
+    return arena.make<BVHNode>(arena, objects.data(), 0, objects.size());
+}
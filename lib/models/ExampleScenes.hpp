@@ -0,0 +1,31 @@
+/**
+ * @file ExampleScenes.hpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "engine/Camera.hpp"
+#include "engine/Scene.hpp"
+
+/**
+ * Canonical scenes rendered by the examples and the render benchmarks. Each adds its objects and materials to an empty
+ * scene and returns the scene's camera.
+ */
+
+/* Dark room with a ceiling of light panels and a monolith of cubes. */
+Camera makeBatCaveScene(Scene &scene, Real aspectRatio);
+
+/* Menger sponges of levels 0 to maxLevel (at most 4) on a metal floor. */
+Camera makeMengerCubeScene(Scene &scene, Real aspectRatio, int8_t maxLevel = 4);
+
+/* CSG of two rotated metal cubes. */
+Camera makeCubeUnionScene(Scene &scene, Real aspectRatio);
+Camera makeCubeDifferenceScene(Scene &scene, Real aspectRatio);
+Camera makeCubeIntersectionScene(Scene &scene, Real aspectRatio);
+
+/* Cube with a corner removed by a second cube. */
+Camera makeCubeSphereDifferenceScene(Scene &scene, Real aspectRatio);
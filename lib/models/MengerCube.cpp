@@ -11,7 +11,6 @@
 #include "engine/primitives/Cube.hpp"
 #include <cstdlib>
 #include <cstring>
-#include <memory>
 
 extern "C"
 {
@@ -27,7 +26,7 @@ extern "C"
 struct MengerCube
 {
     int8_t iteration;
-    double sideLen;
+    Real sideLen;
     Point3 center;
 };
 
@@ -45,12 +44,12 @@ static void freeCubeStack(CubeStack *stack);
 static MengerCube popCube(CubeStack *stack);
 static void pushCube(CubeStack *stack, MengerCube *cube);
 static bool subdivideCube(MengerCube *subCubes, MengerCube *parent);
-static MengerCube makeMengerCube(short int iter, double len, double x, double y, double z);
+static MengerCube makeMengerCube(short int iter, Real len, Real x, Real y, Real z);
 
 
-Primitive *makeMengerSponge(int8_t n, Point3 center, double sideLength, std::shared_ptr<Material> material)
+Primitive *makeMengerSponge(SceneArena &arena, int8_t n, Point3 center, Real sideLength, MaterialId material)
 {
-    if (n < 0 || n > 6 || sideLength <= 0.0 || !material) return NULL;
+    if (n < 0 || n > 6 || sideLength <= 0.0 || material == kNoMaterial) return NULL;
 
     const int numOutputCubes = pow(20, n);
 
@@ -65,7 +64,6 @@ Primitive *makeMengerSponge(int8_t n, Point3 center, double sideLength, std::sha
     }
 
     int numObjectsAdded = 0;
-    Vector3 noRotation = zeroVector();
 
     // Make initial cube for iteration 0 and add to stack:
     MengerCube initialCube = makeMengerCube(0, sideLength, 0, 0, 0);
@@ -81,7 +79,7 @@ Primitive *makeMengerSponge(int8_t n, Point3 center, double sideLength, std::sha
         if (poppedCube.iteration == n)
         {
             Point3 objectCenter = addVectors(poppedCube.center, center);
-            objects[numObjectsAdded++] = new Cube(objectCenter, noRotation, poppedCube.sideLen, material);
+            objects[numObjectsAdded++] = arena.make<Cube>(objectCenter, nullptr, poppedCube.sideLen, material);
             continue;
         }
 
@@ -97,7 +95,7 @@ Primitive *makeMengerSponge(int8_t n, Point3 center, double sideLength, std::sha
     }
 
     // Create BVHNode from primitives:
-    Primitive *node = new BVHNode(objects, 0, numObjectsAdded);
+    Primitive *node = arena.make<BVHNode>(arena, objects, 0, numObjectsAdded);
 
     // Cleanup:
     freeCubeStack(inputStack);
@@ -107,7 +105,7 @@ Primitive *makeMengerSponge(int8_t n, Point3 center, double sideLength, std::sha
 }
 
 
-static MengerCube makeMengerCube(short int iter, double len, double x, double y, double z)
+static MengerCube makeMengerCube(short int iter, Real len, Real x, Real y, Real z)
 {
     MengerCube cube = {.iteration = iter, .sideLen = len, .center = {x, y, z}};
 
@@ -183,7 +181,7 @@ static bool subdivideCube(MengerCube *subCubes, MengerCube *parent)
 
     // Add cubes for top-face excluding center hole:
     short int nextIter = parent->iteration + 1;
-    double sideLen = parent->sideLen / 3.0;
+    Real sideLen = parent->sideLen / 3.0;
 
     // Clockwise:
     enum
@@ -195,7 +193,7 @@ static bool subdivideCube(MengerCube *subCubes, MengerCube *parent)
 
     int nsubCubes = 0; // Should be 20!
 
-    double cubeCenterY;
+    Real cubeCenterY;
 
     for (int mode = kTopCubes; mode <= kBottomCubes; mode++)
     {
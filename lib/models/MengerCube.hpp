@@ -5,6 +5,7 @@
  */
 
 #pragma once
+#include "engine/SceneArena.hpp"
 #include "engine/primitives/BVHNode.hpp"
 #include "engine/primitives/Primitive.hpp"
 
@@ -13,4 +14,8 @@ extern "C"
 #include "utility/Vector3.h"
 }
 
-Primitive *makeMengerSponge(int8_t n, Point3 center, double sideLength, std::shared_ptr<Material> material);
+/*
+ * Returns a BVH of the cubes in a level-n Menger sponge (n <= 6). The cubes and nodes are allocated from the arena.
+ * NB: this materialises 20^n cubes. Use the MengerSponge primitive which is intersected implicitly to render sponges.
+ */
+Primitive *makeMengerSponge(SceneArena &arena, int8_t n, Point3 center, Real sideLength, MaterialId material);
@@ -9,10 +9,13 @@
 
 #include "threadpool/ThreadPool.h"
 #include "logger/Logger.h"
+#include "threadpool/ThreadUtils.h"
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+/* ID of the calling worker thread (0 for threads which are not workers) */
+static _Thread_local int gWorkerID = 0;
 
 void execute(void *args)
 {
@@ -20,6 +23,10 @@ void execute(void *args)
     ThreadPool *threadPool = threadInfo->threadPool;
     pthread_mutex_t *mutex = threadInfo->mutex;
 
+    gWorkerID = threadInfo->threadID;
+
+    if (shouldPinWorkers()) (void)pinThreadToCore(threadInfo->threadID - 1);
+
     while (true)
     {
         pthread_mutex_lock(mutex);
@@ -33,14 +40,14 @@ void execute(void *args)
         Task *task = threadPool->task;
         threadPool->task = threadPool->task->next;
 
-        if (threadPool->nTasksCompleted++ % 1000 == 0)
-        {
-            const double percentage = 100.0 * (double)threadPool->nTasksCompleted / (double)threadPool->nTasks;
-            LogInfo("Progress: %.1lf %%", percentage);
-        }
+        const bool logProgress = (threadPool->nTasksCompleted++ % 1000 == 0);
+        const double percentage = 100.0 * (double)threadPool->nTasksCompleted / (double)threadPool->nTasks;
 
         pthread_mutex_unlock(mutex);
 
+        // NB: logged outside of the lock so that other workers are not blocked by the write.
+        if (logProgress) LogInfo("Progress: %.1lf %%", percentage);
+
         task->func(task->args); // Execute function.
 
         // Task completed. Dealloc memory.
@@ -143,4 +150,11 @@ void executeTasks(ThreadPool *threadPool)
 
     // Tasks executed and deallocted.
     threadPool->task = threadPool->base = NULL;
+    threadPool->nTasks = 0;
+}
+
+
+int currentWorkerID(void)
+{
+    return gWorkerID;
 }
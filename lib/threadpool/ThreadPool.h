@@ -41,4 +41,7 @@ void deallocThreadPool(ThreadPool *threadPool);
 void addTask(ThreadPool *threadPool, TaskFunc func, TaskArgs args, size_t argsSize);
 
 // Execute all tasks in thread pool. Once completed, tasks will be removed. The thread pool can then be reused.
-void executeTasks(ThreadPool *threadPool);
\ No newline at end of file
+void executeTasks(ThreadPool *threadPool);
+
+// Returns the ID (1 to nthreads) of the calling worker thread or 0 if it is not a thread pool worker.
+int currentWorkerID(void);
\ No newline at end of file
@@ -8,11 +8,196 @@
  */
 
 #include "threadpool/ThreadUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
 #include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+static std::atomic<unsigned int> theNumWorkers{0};
+static std::atomic<bool> thePinWorkers{false};
+
+/* Maximum workers from the environment */
+static const long kMaxEnvWorkers = 4096;
+
+#ifdef __linux__
+static std::vector<int> availableCores();
+static void sortCoresByTopology(std::vector<int> &cores);
+static int readTopology(int cpu, const char *name);
+#endif
+
 
 extern "C" unsigned int computeNumWorkers(void)
 {
-    unsigned int nthreads = std::thread::hardware_concurrency(); // NB: may return zero.
+    const unsigned int numWorkers = theNumWorkers.load(std::memory_order_relaxed);
+    if (numWorkers > 0) return numWorkers;
+
+    const char *envValue = getenv("CPHOTON_THREADS");
+
+    if (envValue && *envValue)
+    {
+        char *end = nullptr;
+        const long value = strtol(envValue, &end, 10);
+
+        // NB: invalid values are ignored.
+        if (*end == '\0' && value > 0 && value <= kMaxEnvWorkers) return (unsigned int)value;
+    }
+
+    return numAvailableCores();
+}
+
+
+extern "C" void setNumWorkers(unsigned int numWorkers)
+{
+    theNumWorkers.store(numWorkers, std::memory_order_relaxed);
+}
+
+
+extern "C" unsigned int numAvailableCores(void)
+{
+#ifdef __linux__
+    // NB: respects taskset and cgroup cpusets unlike hardware_concurrency.
+    const size_t numCores = availableCores().size();
+    if (numCores > 0) return (unsigned int)numCores;
+#endif
+
+    const unsigned int nthreads = std::thread::hardware_concurrency(); // NB: may return zero.
+
+    return (nthreads > 0 ? nthreads : 1);
+}
+
+
+extern "C" void setPinWorkers(bool pinWorkers)
+{
+    thePinWorkers.store(pinWorkers, std::memory_order_relaxed);
+}
+
+
+extern "C" bool shouldPinWorkers(void)
+{
+    return thePinWorkers.load(std::memory_order_relaxed);
+}
+
+
+extern "C" int coreForWorker(unsigned int index)
+{
+#ifdef __linux__
+    std::vector<int> cores = availableCores();
+    if (cores.empty()) return -1;
+
+    sortCoresByTopology(cores);
+
+    return cores[index % cores.size()];
+#else
+    (void)index;
+    return -1; // NB: macOS has no API to pin threads to cores.
+#endif
+}
+
+
+extern "C" bool pinThreadToCore(unsigned int index)
+{
+#ifdef __linux__
+    const int core = coreForWorker(index);
+    if (core < 0) return false;
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(core, &cpuSet);
+
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) == 0);
+#else
+    (void)index;
+    return false;
+#endif
+}
+
+
+#ifdef __linux__
+/// Returns the cores in the process's CPU affinity mask (empty if unavailable).
+static std::vector<int> availableCores()
+{
+    std::vector<int> cores;
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+
+    // NB: the main thread's mask rather than the calling thread's (which may already be pinned).
+    if (sched_getaffinity(getpid(), sizeof(cpu_set_t), &cpuSet) != 0) return cores;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &cpuSet)) cores.push_back(cpu);
+    }
+
+    return cores;
+}
+
+
+/**
+ * Orders the cores so that workers fill the physical cores of the first socket, then those of the next socket, and
+ * only then the SMT siblings (hyperthreads) of cores which are already in use.
+ */
+static void sortCoresByTopology(std::vector<int> &cores)
+{
+    struct Core
+    {
+        int cpu;
+        int package;
+        int coreID;
+        int siblingRank; /* Number of earlier cores on the same physical core */
+    };
+
+    std::vector<Core> topology;
+
+    for (int cpu : cores)
+    {
+        Core core = {cpu, readTopology(cpu, "physical_package_id"), readTopology(cpu, "core_id"), 0};
+
+        // NB: without a core id each CPU is treated as its own physical core.
+        if (core.coreID < 0) core.coreID = cpu;
+
+        for (const Core &other : topology)
+        {
+            if (other.package == core.package && other.coreID == core.coreID) ++core.siblingRank;
+        }
+
+        topology.push_back(core);
+    }
+
+    std::stable_sort(topology.begin(), topology.end(), [](const Core &left, const Core &right) {
+        if (left.siblingRank != right.siblingRank) return left.siblingRank < right.siblingRank;
+        if (left.package != right.package) return left.package < right.package;
+        return left.coreID < right.coreID;
+    });
+
+    for (size_t i = 0; i < cores.size(); ++i)
+    {
+        cores[i] = topology[i].cpu;
+    }
+}
+
+
+/// Returns a value from /sys/devices/system/cpu/cpu<n>/topology (-1 if unavailable).
+static int readTopology(int cpu, const char *name)
+{
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    int value = -1;
+    if (fscanf(fp, "%d", &value) != 1) value = -1;
 
-    return (nthreads > 0 ? 8 : nthreads);
-}
\ No newline at end of file
+    fclose(fp);
+    return value;
+}
+#endif
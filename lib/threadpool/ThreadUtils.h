@@ -8,11 +8,43 @@
  */
 
 #pragma once
+#include <stdbool.h>
 
 // clang-format off
 #ifdef __cplusplus
-extern "C"
+extern "C" {
 #endif
 
+/**
+ * Returns the number of worker threads: the number set with setNumWorkers, otherwise the CPHOTON_THREADS environment
+ * variable, otherwise the number of cores which the process may run on (at least one).
+ */
 unsigned int computeNumWorkers(void);
-// clang-format on
\ No newline at end of file
+
+/* Overrides the number of worker threads (zero restores the default) */
+void setNumWorkers(unsigned int numWorkers);
+
+/* Returns the number of cores which the process may run on (its CPU affinity where available) */
+unsigned int numAvailableCores(void);
+
+/* Enables pinning each thread pool worker to its own core (disabled by default) */
+void setPinWorkers(bool pinWorkers);
+bool shouldPinWorkers(void);
+
+/**
+ * Returns the core for the index-th worker (wrapping around) or -1 if pinning is not supported (e.g. macOS). The cores
+ * which the process may run on are ordered by topology: the physical cores of each socket in turn, then their SMT
+ * siblings.
+ *
+ * NB: placement is not NUMA-aware beyond this order. The scene and image buffers are shared by all workers and are
+ * not replicated per socket or allocated on each worker's node.
+ */
+int coreForWorker(unsigned int index);
+
+/* Pins the calling thread to the core for the index-th worker. Returns false if pinning is not supported or fails */
+bool pinThreadToCore(unsigned int index);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
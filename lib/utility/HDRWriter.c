@@ -0,0 +1,402 @@
+//
+//  HDRWriter.c
+//  CPhoton
+//
+//  Created by Edward on 18/10/2026.
+//
+
+#include "utility/HDRWriter.h"
+#include "logger/Logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* OpenEXR constants (see "OpenEXR File Layout") */
+#define EXR_MAGIC 20000630
+#define EXR_VERSION 2
+#define EXR_PIXEL_TYPE_HALF 1
+#define EXR_NO_COMPRESSION 0
+#define EXR_INCREASING_Y 0
+
+/* Bytes of a scanline block: y coordinate, data size, then a row of halfs for each channel */
+#define EXR_BLOCK_SIZE(stream) (8 + (size_t)(stream)->width * (stream)->numChannels * 2)
+
+static bool writeEXRHeader(HDRStream *stream, const char *const *channelNames);
+static bool writeEXRRows(HDRStream *stream, const float *values, int numRows);
+static bool writePFMRows(HDRStream *stream, const float *values, int numRows);
+static bool writeImage(PPMImage *image, const char *fpath, HDRFormat format);
+static void writeAttribute(FILE *fp, const char *name, const char *type, const void *value, int32_t size);
+static inline void storeInt32(uint8_t *bytes, int32_t value);
+static inline void storeUInt64(uint8_t *bytes, uint64_t value);
+
+
+HDRStream *openHDRStream(const char *fpath, HDRFormat format, int width, int height, const char *const *channelNames,
+                         int numChannels)
+{
+    if (!fpath || !channelNames || width < 1 || height < 1 || numChannels < 1) return NULL;
+
+    if (format == HDRFormatPFM && numChannels != 1 && numChannels != 3) return NULL;
+
+    HDRStream *stream = calloc(1, sizeof(HDRStream));
+    if (!stream) return NULL;
+
+    stream->format = format;
+    stream->width = width;
+    stream->height = height;
+    stream->numChannels = numChannels;
+
+    stream->fp = fopen(fpath, "wb");
+    if (!stream->fp)
+    {
+        Logger(LogLevelError, "Could not write to file '%s'", fpath);
+        free(stream);
+        return NULL;
+    }
+
+    bool success;
+
+    if (format == HDRFormatPFM)
+    {
+        // NB: a negative scale indicates little-endian values.
+        success = (fprintf(stream->fp, "%s\n%d %d\n-1.0\n", (numChannels == 3) ? "PF" : "Pf", width, height) > 0);
+    }
+    else
+    {
+        success = writeEXRHeader(stream, channelNames);
+    }
+
+    stream->dataOffset = ftell(stream->fp);
+
+    if (!success || stream->dataOffset < 0)
+    {
+        stream->failed = true;
+        closeHDRStream(stream);
+        return NULL;
+    }
+
+    return stream;
+}
+
+
+bool writeHDRStreamRows(HDRStream *stream, const float *values, int numRows)
+{
+    if (!stream || !values || numRows < 0 || stream->rowsWritten + numRows > stream->height)
+    {
+        if (stream) stream->failed = true;
+        return false;
+    }
+
+    if (numRows == 0 || stream->failed) return !stream->failed;
+
+    if (stream->format == HDRFormatPFM)
+        stream->failed = !writePFMRows(stream, values, numRows);
+    else
+        stream->failed = !writeEXRRows(stream, values, numRows);
+
+    if (!stream->failed) stream->rowsWritten += numRows;
+
+    return !stream->failed;
+}
+
+
+bool closeHDRStream(HDRStream *stream)
+{
+    if (!stream) return false;
+
+    bool success = !stream->failed && (stream->rowsWritten == stream->height);
+
+    if (fclose(stream->fp) != 0) success = false;
+
+    free(stream->channelOrder);
+    free(stream);
+
+    return success;
+}
+
+
+bool writePFMImage(PPMImage *image, const char *fpath)
+{
+    return writeImage(image, fpath, HDRFormatPFM);
+}
+
+
+bool writeEXRImage(PPMImage *image, const char *fpath)
+{
+    return writeImage(image, fpath, HDRFormatEXR);
+}
+
+
+uint16_t floatToHalf(float value)
+{
+    // Based on Fabian Giesen's public domain float_to_half_fast3_rtne.
+    static const uint32_t kInfinity = 255 << 23;
+    static const uint32_t kHalfMax = (127 + 16) << 23; // NB: larger values overflow.
+    static const uint32_t kMinNormal = 113 << 23;      // 2^-14
+    static const uint32_t kDenormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint16_t half;
+
+    if (bits >= kHalfMax)
+    {
+        half = (bits > kInfinity) ? 0x7e00 : 0x7c00; // NaN or infinity.
+    }
+    else if (bits < kMinNormal)
+    {
+        // Denormal (or zero). Adding the magic number shifts the mantissa into place and rounds it.
+        float magic, denorm;
+        memcpy(&magic, &kDenormMagic, sizeof(magic));
+        memcpy(&denorm, &bits, sizeof(denorm));
+
+        denorm += magic;
+        memcpy(&bits, &denorm, sizeof(bits));
+
+        half = (uint16_t)(bits - kDenormMagic);
+    }
+    else
+    {
+        const uint32_t mantissaOdd = (bits >> 13) & 1;
+
+        // Rebias the exponent and round to nearest even.
+        bits += ((uint32_t)(15 - 127) << 23) + 0xfff;
+        bits += mantissaOdd;
+
+        half = (uint16_t)(bits >> 13);
+    }
+
+    return half | (uint16_t)(sign >> 16);
+}
+
+
+/// Writes the magic number, version, header attributes and the offset table. The channels are sorted by name.
+static bool writeEXRHeader(HDRStream *stream, const char *const *channelNames)
+{
+    const int numChannels = stream->numChannels;
+
+    stream->channelOrder = malloc(sizeof(int) * numChannels);
+    if (!stream->channelOrder) return false;
+
+    // Insertion sort the channels by name.
+    for (int i = 0; i < numChannels; ++i)
+    {
+        int j = i;
+
+        for (; j > 0 && strcmp(channelNames[stream->channelOrder[j - 1]], channelNames[i]) > 0; --j)
+        {
+            stream->channelOrder[j] = stream->channelOrder[j - 1];
+        }
+
+        stream->channelOrder[j] = i;
+
+        if (j > 0 && strcmp(channelNames[stream->channelOrder[j - 1]], channelNames[i]) == 0) return false;
+    }
+
+    FILE *fp = stream->fp;
+
+    uint8_t bytes[16];
+    storeInt32(bytes, EXR_MAGIC);
+    storeInt32(bytes + 4, EXR_VERSION); // NB: single-part scanline file (no flags).
+    fwrite(bytes, 1, 8, fp);
+
+    // Channel list: name, pixel type, pLinear + 3 reserved bytes, x and y sampling. Terminated by a null byte.
+    int32_t channelsSize = 1;
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        channelsSize += (int32_t)strlen(channelNames[i]) + 1 + 16;
+    }
+
+    fputs("channels", fp);
+    fputc('\0', fp);
+    fputs("chlist", fp);
+    fputc('\0', fp);
+    storeInt32(bytes, channelsSize);
+    fwrite(bytes, 1, 4, fp);
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        const char *name = channelNames[stream->channelOrder[i]];
+        fwrite(name, 1, strlen(name) + 1, fp);
+
+        memset(bytes, 0, sizeof(bytes));
+        storeInt32(bytes, EXR_PIXEL_TYPE_HALF);
+        storeInt32(bytes + 8, 1);
+        storeInt32(bytes + 12, 1);
+        fwrite(bytes, 1, 16, fp);
+    }
+
+    fputc('\0', fp);
+
+    const uint8_t compression = EXR_NO_COMPRESSION;
+    writeAttribute(fp, "compression", "compression", &compression, 1);
+
+    uint8_t window[16];
+    storeInt32(window, 0);
+    storeInt32(window + 4, 0);
+    storeInt32(window + 8, stream->width - 1);
+    storeInt32(window + 12, stream->height - 1);
+    writeAttribute(fp, "dataWindow", "box2i", window, 16);
+    writeAttribute(fp, "displayWindow", "box2i", window, 16);
+
+    const uint8_t lineOrder = EXR_INCREASING_Y;
+    writeAttribute(fp, "lineOrder", "lineOrder", &lineOrder, 1);
+
+    const float one = 1.0f;
+    const float center[2] = {0.0f, 0.0f};
+    writeAttribute(fp, "pixelAspectRatio", "float", &one, 4);
+    writeAttribute(fp, "screenWindowCenter", "v2f", center, 8);
+    writeAttribute(fp, "screenWindowWidth", "float", &one, 4);
+
+    fputc('\0', fp); // End of header.
+
+    // Offset table. The blocks are uncompressed (one scanline each) so every offset is known in advance.
+    const long tableOffset = ftell(fp);
+    if (tableOffset < 0) return false;
+
+    const uint64_t firstBlock = (uint64_t)tableOffset + 8 * (uint64_t)stream->height;
+
+    for (int y = 0; y < stream->height; ++y)
+    {
+        storeUInt64(bytes, firstBlock + y * EXR_BLOCK_SIZE(stream));
+        fwrite(bytes, 1, 8, fp);
+    }
+
+    return !ferror(fp);
+}
+
+
+/// Writes a scanline block for each row.
+static bool writeEXRRows(HDRStream *stream, const float *values, int numRows)
+{
+    const size_t blockSize = EXR_BLOCK_SIZE(stream);
+    const int width = stream->width;
+    const int numChannels = stream->numChannels;
+
+    uint8_t *blocks = malloc(blockSize * numRows);
+    if (!blocks) return false;
+
+    for (int iRow = 0; iRow < numRows; ++iRow)
+    {
+        uint8_t *block = blocks + iRow * blockSize;
+        const float *row = values + (size_t)iRow * width * numChannels;
+
+        storeInt32(block, stream->rowsWritten + iRow);
+        storeInt32(block + 4, (int32_t)(blockSize - 8));
+
+        uint8_t *output = block + 8;
+
+        for (int iChannel = 0; iChannel < numChannels; ++iChannel)
+        {
+            const float *input = row + stream->channelOrder[iChannel];
+
+            for (int iCol = 0; iCol < width; ++iCol, input += numChannels, output += 2)
+            {
+                const uint16_t half = floatToHalf(*input);
+
+                output[0] = (uint8_t)(half & 0xff);
+                output[1] = (uint8_t)(half >> 8);
+            }
+        }
+    }
+
+    const bool success = (fwrite(blocks, 1, blockSize * numRows, stream->fp) == blockSize * numRows);
+
+    free(blocks);
+    return success;
+}
+
+
+/// Writes rows to their positions in the file (PFM stores the bottom row first). NB: assumes a little-endian host.
+static bool writePFMRows(HDRStream *stream, const float *values, int numRows)
+{
+    const size_t rowSize = (size_t)stream->width * stream->numChannels;
+
+    float *rows = malloc(sizeof(float) * rowSize * numRows);
+    if (!rows) return false;
+
+    // Reverse the order of the rows.
+    for (int iRow = 0; iRow < numRows; ++iRow)
+    {
+        memcpy(rows + (numRows - 1 - iRow) * rowSize, values + iRow * rowSize, sizeof(float) * rowSize);
+    }
+
+    const int bottomRow = stream->height - (stream->rowsWritten + numRows);
+    const long offset = stream->dataOffset + (long)(bottomRow * rowSize * sizeof(float));
+
+    const bool success = (fseek(stream->fp, offset, SEEK_SET) == 0) &&
+                         (fwrite(rows, sizeof(float) * rowSize, numRows, stream->fp) == (size_t)numRows);
+
+    free(rows);
+    return success;
+}
+
+
+static bool writeImage(PPMImage *image, const char *fpath, HDRFormat format)
+{
+    static const char *const kChannelNames[3] = {"R", "G", "B"};
+
+    if (!image || !image->pixels || image->width < 1 || image->height < 1) return false;
+
+    HDRStream *stream = openHDRStream(fpath, format, image->width, image->height, kChannelNames, 3);
+    if (!stream) return false;
+
+    float *row = malloc(sizeof(float) * 3 * image->width);
+    if (!row)
+    {
+        closeHDRStream(stream);
+        return false;
+    }
+
+    // NB: the image's first row is the bottom row.
+    for (int i = image->height - 1; i >= 0; i--)
+    {
+        for (int j = 0; j < image->width; j++)
+        {
+            row[3 * j + 0] = (float)image->pixelValue[i][j].r;
+            row[3 * j + 1] = (float)image->pixelValue[i][j].g;
+            row[3 * j + 2] = (float)image->pixelValue[i][j].b;
+        }
+
+        if (!writeHDRStreamRows(stream, row, 1)) break;
+    }
+
+    free(row);
+    return closeHDRStream(stream);
+}
+
+
+/// Writes a header attribute: name, type, size and value.
+static void writeAttribute(FILE *fp, const char *name, const char *type, const void *value, int32_t size)
+{
+    uint8_t bytes[4];
+    storeInt32(bytes, size);
+
+    fwrite(name, 1, strlen(name) + 1, fp);
+    fwrite(type, 1, strlen(type) + 1, fp);
+    fwrite(bytes, 1, 4, fp);
+    fwrite(value, 1, size, fp); // NB: float values assume a little-endian host.
+}
+
+
+static inline void storeInt32(uint8_t *bytes, int32_t value)
+{
+    const uint32_t u = (uint32_t)value;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        bytes[i] = (uint8_t)(u >> (8 * i));
+    }
+}
+
+
+static inline void storeUInt64(uint8_t *bytes, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+}
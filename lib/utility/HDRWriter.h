@@ -0,0 +1,54 @@
+//
+//  HDRWriter.h
+//  CPhoton
+//
+//  Created by Edward on 18/10/2026.
+//
+
+#ifndef HDRWriter_h
+#define HDRWriter_h
+
+#include "utility/PPMWriter.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Linear (not gamma corrected or clamped) HDR image formats.
+typedef enum
+{
+    HDRFormatPFM, // Portable float map (32-bit float). 1 or 3 channels.
+    HDRFormatEXR  // Scanline OpenEXR with uncompressed 16-bit half float channels.
+} HDRFormat;
+
+// Writes an HDR image incrementally. Rows are written in file order (top row first) with numChannels interleaved
+// float values per pixel. NB: the whole file layout is fixed when it is opened so no buffering is required.
+typedef struct
+{
+    FILE *fp;
+    HDRFormat format;
+    int width;
+    int height;
+    int numChannels;
+    int rowsWritten;
+    bool failed;
+    long dataOffset;
+    int *channelOrder; // EXR only: input channel for each channel in the file (sorted by name).
+} HDRStream;
+
+// Opens a stream for a width x height image. The channel names are used by EXR (e.g. "R", "G", "B", "albedo.R") and
+// must be unique. Returns NULL on failure.
+HDRStream *openHDRStream(const char *fpath, HDRFormat format, int width, int height, const char *const *channelNames,
+                         int numChannels);
+bool writeHDRStreamRows(HDRStream *stream, const float *values, int numRows);
+
+// Closes the stream. Returns false if a write failed or not all rows were written.
+bool closeHDRStream(HDRStream *stream);
+
+// Writes an image's RGB values.
+bool writePFMImage(PPMImage *image, const char *fpath);
+bool writeEXRImage(PPMImage *image, const char *fpath);
+
+// Converts to half float (round to nearest even). Out of range values are converted to infinity.
+uint16_t floatToHalf(float value);
+
+#endif /* HDRWriter_h */
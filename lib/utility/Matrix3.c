@@ -9,7 +9,7 @@
 #include "utility/MathMacros.h"
 #include <stdlib.h>
 
-typedef double Matrix3[3][3];
+typedef Real Matrix3[3][3];
 
 struct rotate3_t
 {
@@ -20,7 +20,7 @@ struct rotate3_t
 
 static inline Vector3 transformVector(Vector3 v, Matrix3 mat);
 static inline void setRotationMatrices(Matrix3 matRot, Matrix3 matInvRot, Vector3 rotAngles);
-static inline void rotationMatrix(Matrix3 matRot, double alpha, double beta, double gamma);
+static inline void rotationMatrix(Matrix3 matRot, Real alpha, Real beta, Real gamma);
 static inline void transposeMatrix(Matrix3 matT, Matrix3 mat);
 
 
@@ -33,6 +33,20 @@ Rotate3 *makeRotate3(Vector3 rotationAngles)
     Rotate3 *rotation = malloc(sizeof(Rotate3));
     if (!rotation) return NULL;
 
+    return initRotate3(rotation, rotationAngles);
+}
+
+
+size_t sizeOfRotate3(void)
+{
+    return sizeof(Rotate3);
+}
+
+
+Rotate3 *initRotate3(void *memory, Vector3 rotationAngles)
+{
+    Rotate3 *rotation = memory;
+
     setRotationMatrices(rotation->rotate, rotation->inverse, rotationAngles);
     return rotation;
 }
@@ -68,10 +82,10 @@ static inline void transposeMatrix(Matrix3 matT, Matrix3 mat)
 }
 
 
-static inline void rotationMatrix(Matrix3 matRot, double alpha, double beta, double gamma)
+static inline void rotationMatrix(Matrix3 matRot, Real alpha, Real beta, Real gamma)
 {
-    double cosAlpha = cosd(alpha), cosBeta = cosd(beta), cosGamma = cosd(gamma);
-    double sinAlpha = sind(alpha), sinBeta = sind(beta), sinGamma = sind(gamma);
+    Real cosAlpha = cosd(alpha), cosBeta = cosd(beta), cosGamma = cosd(gamma);
+    Real sinAlpha = sind(alpha), sinBeta = sind(beta), sinGamma = sind(gamma);
 
     matRot[0][0] = cosBeta * cosGamma;
     matRot[0][1] = sinAlpha * sinBeta * cosGamma - cosAlpha * sinGamma;
@@ -89,9 +103,9 @@ static inline void rotationMatrix(Matrix3 matRot, double alpha, double beta, dou
 
 static inline Vector3 transformVector(Vector3 v, Matrix3 mat)
 {
-    const double xPrime = v.x * mat[0][0] + v.y * mat[0][1] + v.z * mat[0][2];
-    const double yPrime = v.x * mat[1][0] + v.y * mat[1][1] + v.z * mat[1][2];
-    const double zPrime = v.x * mat[2][0] + v.y * mat[2][1] + v.z * mat[2][2];
+    const Real xPrime = v.x * mat[0][0] + v.y * mat[0][1] + v.z * mat[0][2];
+    const Real yPrime = v.x * mat[1][0] + v.y * mat[1][1] + v.z * mat[1][2];
+    const Real zPrime = v.x * mat[2][0] + v.y * mat[2][1] + v.z * mat[2][2];
 
     return vector3(xPrime, yPrime, zPrime);
 }
@@ -14,8 +14,16 @@ struct rotate3_t;
 
 typedef struct rotate3_t Rotate3;
 
+#include <stddef.h>
+
 Rotate3 *makeRotate3(Vector3 rotationAngles);
 
+/* Size in bytes of a Rotate3 (for callers which allocate their own memory) */
+size_t sizeOfRotate3(void);
+
+/* Initializes a Rotate3 in memory of at least sizeOfRotate3() bytes */
+Rotate3 *initRotate3(void *memory, Vector3 rotationAngles);
+
 Vector3 rotation(Vector3 v, Rotate3 *matrices);
 Vector3 inverseRotation(Vector3, Rotate3 *matrices);
 
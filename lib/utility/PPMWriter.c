@@ -7,7 +7,9 @@
 
 #include "utility/PPMWriter.h"
 #include "logger/Logger.h"
+#include "threadpool/ThreadUtils.h"
 #include "utility/MathMacros.h"
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -19,10 +21,49 @@
 #define MASK_RIGHT_BYTE (MAX_2BYTES - MAX_BYTE)
 #define FLIP_BYTES(bytes) (((bytes) >> 8) | (((bytes) << 8) & MASK_RIGHT_BYTE))
 
+/* Minimum rows quantized by each thread. */
+#define MIN_ROWS_PER_THREAD 16
+
+/*
+ * Gamma correction table. v^(1/2.2) = m^(1/2.2) * 2^(e/2.2) for v = m * 2^e, 1 <= m < 2. The first term is linearly
+ * interpolated from GAMMA_SEGMENTS segments (relative error < 2e-9) and the second is looked up by exponent. Values
+ * below 2^GAMMA_MIN_EXPONENT quantize to zero.
+ */
+#define GAMMA_SEGMENT_BITS 12
+#define GAMMA_SEGMENTS (1 << GAMMA_SEGMENT_BITS)
+#define GAMMA_MIN_EXPONENT (-40)
+#define GAMMA_MIN_VALUE 0x1p-40
+
+/* Quantized values closer than this to an integer are recomputed with pow() so results match exactly. */
+#define GAMMA_TOLERANCE 1e-3
+
+/* Rows of an image (Color3 rows, bottom row first) or packed float RGB rows (top row first) to quantize. */
+typedef struct
+{
+    PPMImage *image;
+    const float *rgb;
+    int width;
+    int height;
+    int bitDepth;
+    int firstRow; /* First and last output rows (top row first) */
+    int lastRow;
+    void *output;
+} QuantizeJob;
+
 static bool isValidPPMImage(PPMImage *image);
+static bool writeBinaryImage(PPMImage *image, const char *fpath, int bitDepth);
+static void quantizeRows(const QuantizeJob *job);
+static void *quantizeRowsThread(void *job);
+static void parallelQuantizeRows(const QuantizeJob *job);
 static inline void writePixelToFile(FILE *fp, Color3 *pixel);
-static inline void writeBinaryPixelToFile(FILE *fp, Color3 *pixel);
-static inline void writeBinary16BitPixelToFile(FILE *fp, Color3 *pixel);
+static void initGammaTables(void);
+static inline uint32_t quantizeGamma(double value, double scale, uint32_t maxValue);
+static inline uint8_t quantize8Bit(double value);
+static inline uint16_t quantize16Bit(double value);
+
+static double gammaMantissa[GAMMA_SEGMENTS + 1];
+static double gammaExponent[-GAMMA_MIN_EXPONENT];
+static pthread_once_t gammaTablesOnce = PTHREAD_ONCE_INIT;
 
 
 static bool isValidPPMImage(PPMImage *image)
@@ -46,7 +87,8 @@ PPMImage *makePPMImage(int width, int height)
     newImage->width = width;
     newImage->height = height;
 
-    newImage->pixels = malloc(sizeof(Color3) * width * height);
+    /* NB: Color3 is over-aligned in SIMD builds. */
+    newImage->pixels = aligned_alloc(_Alignof(Color3), sizeof(Color3) * width * height);
     if (!newImage->pixels)
     {
         free(newImage);
@@ -135,6 +177,8 @@ bool writePPMImage(PPMImage *image, const char *fpath)
     // 3. Write the header.
     fprintf(fp, "P3\n%d %d\n255\n", image->width, image->height);
 
+    pthread_once(&gammaTablesOnce, initGammaTables);
+
     // 4. Write the individual pixels.
     for (int i = image->height - 1; i >= 0; i--)
     {
@@ -152,126 +196,313 @@ bool writePPMImage(PPMImage *image, const char *fpath)
 
 
 bool writeBinaryPPMImage(PPMImage *image, const char *fpath)
+{
+    return writeBinaryImage(image, fpath, 8);
+}
+
+
+bool writeBinary16BitPPMImage(PPMImage *image, const char *fpath)
+{
+    return writeBinaryImage(image, fpath, 16);
+}
+
+
+/// Quantizes the whole image into a buffer across threads and writes it with a single call.
+static bool writeBinaryImage(PPMImage *image, const char *fpath, int bitDepth)
 {
     // 1. Check image structure and fpath.
     if (!isValidPPMImage(image) || !fpath) return false;
 
-    // 2. Open file.
+    // 2. Quantize the pixels.
+    const size_t numBytes = (size_t)image->width * image->height * 3 * (bitDepth / 8);
+
+    void *buffer = malloc(numBytes);
+    if (!buffer) return false;
+
+    QuantizeJob job = {.image = image,
+                       .rgb = NULL,
+                       .width = image->width,
+                       .height = image->height,
+                       .bitDepth = bitDepth,
+                       .firstRow = 0,
+                       .lastRow = image->height,
+                       .output = buffer};
+
+    parallelQuantizeRows(&job);
+
+    // 3. Open file.
     FILE *fp = fopen(fpath, "wb");
     if (!fp)
     {
-        fprintf(stderr, "The file could not be opened!\n");
+        Logger(LogLevelError, "Could not write to file '%s'", fpath);
+        free(buffer);
         return false;
     }
 
-    // 3. Write the header.
-    fprintf(fp, "P6\n%d %d\n255\n", image->width, image->height);
+    // 4. Write the header and pixels.
+    fprintf(fp, "P6\n%d %d\n%d\n", image->width, image->height, (bitDepth == 8) ? MAX_BYTE : MAX_2BYTES);
 
-    // 4. Write the individual pixels.
-    for (int i = image->height - 1; i >= 0; i--)
-    {
-        for (int j = 0; j < image->width; j++)
-        {
-            writeBinaryPixelToFile(fp, &image->pixelValue[i][j]);
-        }
-    }
+    bool success = (fwrite(buffer, 1, numBytes, fp) == numBytes);
 
     // 5. Close the file.
-    fclose(fp);
+    if (fclose(fp) != 0) success = false;
 
-    return true;
+    free(buffer);
+    return success;
 }
 
 
-bool writeBinary16BitPPMImage(PPMImage *image, const char *fpath)
+PPMStream *openPPMStream(const char *fpath, int width, int height, int bitDepth)
 {
-    // 1. Check image structure and fpath.
-    if (!isValidPPMImage(image) || !fpath) return false;
+    if (!fpath || width < 1 || height < 1 || (bitDepth != 8 && bitDepth != 16)) return NULL;
 
-    // 2. Open file.
-    FILE *fp = fopen(fpath, "wb");
-    if (!fp)
+    PPMStream *stream = malloc(sizeof(PPMStream));
+    if (!stream) return NULL;
+
+    stream->width = width;
+    stream->height = height;
+    stream->bitDepth = bitDepth;
+    stream->rowsWritten = 0;
+    stream->failed = false;
+
+    stream->fp = fopen(fpath, "wb");
+    if (!stream->fp)
     {
         Logger(LogLevelError, "Could not write to file '%s'", fpath);
+        free(stream);
+        return NULL;
+    }
+
+    fprintf(stream->fp, "P6\n%d %d\n%d\n", width, height, (bitDepth == 8) ? MAX_BYTE : MAX_2BYTES);
+
+    return stream;
+}
+
+
+bool writePPMStreamRows(PPMStream *stream, const float *rgb, int numRows)
+{
+    if (!stream || !rgb || numRows < 0 || stream->rowsWritten + numRows > stream->height)
+    {
+        if (stream) stream->failed = true;
         return false;
     }
 
-    // 3. Write the header.
-    fprintf(fp, "P6\n%d %d\n65535\n", image->width, image->height);
+    if (numRows == 0) return !stream->failed;
 
-    // 4. Write the individual pixels.
-    for (int i = image->height - 1; i >= 0; i--)
+    const size_t numBytes = (size_t)stream->width * numRows * 3 * (stream->bitDepth / 8);
+
+    void *buffer = malloc(numBytes);
+    if (!buffer)
     {
-        for (int j = 0; j < image->width; j++)
-        {
-            writeBinary16BitPixelToFile(fp, &image->pixelValue[i][j]);
-        }
+        stream->failed = true;
+        return false;
     }
 
-    // 5. Close the file.
-    fclose(fp);
+    QuantizeJob job = {.image = NULL,
+                       .rgb = rgb,
+                       .width = stream->width,
+                       .height = numRows,
+                       .bitDepth = stream->bitDepth,
+                       .firstRow = 0,
+                       .lastRow = numRows,
+                       .output = buffer};
 
-    return true;
+    parallelQuantizeRows(&job);
+
+    if (fwrite(buffer, 1, numBytes, stream->fp) == numBytes)
+        stream->rowsWritten += numRows;
+    else
+        stream->failed = true;
+
+    free(buffer);
+    return !stream->failed;
 }
 
 
-static inline void writePixelToFile(FILE *fp, Color3 *pixel)
+bool closePPMStream(PPMStream *stream)
 {
-    if (!fp || !pixel) return;
+    if (!stream) return false;
 
-    // Gamma correct. The pixel input values should be in the range [0, 1].
-    static const double invGamma = (1.0 / 2.2);
+    bool success = !stream->failed && (stream->rowsWritten == stream->height);
+
+    if (fclose(stream->fp) != 0) success = false;
 
-    double r = pow(pixel->r, invGamma);
-    double g = pow(pixel->g, invGamma);
-    double b = pow(pixel->b, invGamma);
+    free(stream);
 
-    // Write translated [0, 255] value for each color component.
-    fprintf(fp, "%d %d %d\n", (int)(256 * clamp(r, 0.0, 0.999)), (int)(256 * clamp(g, 0.0, 0.999)),
-            (int)(256 * clamp(b, 0.0, 0.999)));
+    return success;
 }
 
 
-static inline void writeBinaryPixelToFile(FILE *fp, Color3 *pixel)
+/// Splits the rows of a job between threads.
+static void parallelQuantizeRows(const QuantizeJob *job)
 {
-    if (!fp || !pixel) return;
+    pthread_once(&gammaTablesOnce, initGammaTables);
 
-    // Gamma correct. The pixel input values should be in the range [0, 1].
-    static const double invGamma = (1.0 / 2.2);
+    const int numRows = job->lastRow - job->firstRow;
+
+    int numThreads = min((int)computeNumWorkers(), numRows / MIN_ROWS_PER_THREAD);
+    if (numThreads < 2)
+    {
+        quantizeRows(job);
+        return;
+    }
 
-    double r = pow(pixel->r, invGamma);
-    double g = pow(pixel->g, invGamma);
-    double b = pow(pixel->b, invGamma);
+    pthread_t threads[numThreads];
+    bool started[numThreads];
+    QuantizeJob threadJobs[numThreads];
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        threadJobs[i] = *job;
+        threadJobs[i].firstRow = job->firstRow + (int)((int64_t)numRows * i / numThreads);
+        threadJobs[i].lastRow = job->firstRow + (int)((int64_t)numRows * (i + 1) / numThreads);
 
-    // Write translated [0, 255] value for each color component.
-    uint8_t bytes[3];
+        started[i] = (pthread_create(&threads[i], NULL, quantizeRowsThread, &threadJobs[i]) == 0);
 
-    bytes[0] = (int)(256 * clamp(r, 0.0, 0.999));
-    bytes[1] = (int)(256 * clamp(g, 0.0, 0.999));
-    bytes[2] = (int)(256 * clamp(b, 0.0, 0.999));
+        if (!started[i]) quantizeRows(&threadJobs[i]); // NB: the rows must still be quantized.
+    }
 
-    fwrite(bytes, 1, 3, fp);
+    for (int i = 0; i < numThreads; ++i)
+    {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
 }
 
 
-static inline void writeBinary16BitPixelToFile(FILE *fp, Color3 *pixel)
+static void *quantizeRowsThread(void *job)
 {
-    if (!fp || !pixel) return;
+    quantizeRows((const QuantizeJob *)job);
+    return NULL;
+}
+
+
+/// Gamma corrects and quantizes rows [firstRow, lastRow) of a job into its output buffer. 16-bit values are stored
+/// big-endian.
+static void quantizeRows(const QuantizeJob *job)
+{
+    const size_t numValues = (size_t)job->width * 3;
 
-    // Gamma correct. The pixel input values should be in the range [0, 1].
+    for (int iRow = job->firstRow; iRow < job->lastRow; ++iRow)
+    {
+        const Color3 *pixels = job->image ? job->image->pixelValue[job->height - 1 - iRow] : NULL;
+        const float *rgb = job->rgb ? job->rgb + iRow * numValues : NULL;
+
+        if (job->bitDepth == 8)
+        {
+            uint8_t *output = (uint8_t *)job->output + iRow * numValues;
+
+            if (pixels)
+            {
+                for (int iCol = 0; iCol < job->width; ++iCol, output += 3)
+                {
+                    output[0] = quantize8Bit(pixels[iCol].r);
+                    output[1] = quantize8Bit(pixels[iCol].g);
+                    output[2] = quantize8Bit(pixels[iCol].b);
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < numValues; ++i)
+                {
+                    output[i] = quantize8Bit(rgb[i]);
+                }
+            }
+        }
+        else
+        {
+            uint16_t *output = (uint16_t *)job->output + iRow * numValues;
+
+            if (pixels)
+            {
+                for (int iCol = 0; iCol < job->width; ++iCol, output += 3)
+                {
+                    output[0] = FLIP_BYTES(quantize16Bit(pixels[iCol].r));
+                    output[1] = FLIP_BYTES(quantize16Bit(pixels[iCol].g));
+                    output[2] = FLIP_BYTES(quantize16Bit(pixels[iCol].b));
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < numValues; ++i)
+                {
+                    output[i] = FLIP_BYTES(quantize16Bit(rgb[i]));
+                }
+            }
+        }
+    }
+}
+
+
+static void initGammaTables(void)
+{
     static const double invGamma = (1.0 / 2.2);
 
-    double r = pow(pixel->r, invGamma);
-    double g = pow(pixel->g, invGamma);
-    double b = pow(pixel->b, invGamma);
+    for (int i = 0; i <= GAMMA_SEGMENTS; ++i)
+    {
+        gammaMantissa[i] = pow(1.0 + (double)i / GAMMA_SEGMENTS, invGamma);
+    }
+
+    for (int e = GAMMA_MIN_EXPONENT; e < 0; ++e)
+    {
+        gammaExponent[e - GAMMA_MIN_EXPONENT] = pow(2.0, e * invGamma);
+    }
+}
+
+
+/// Returns min(floor(scale * value^(1/2.2)), maxValue) (zero for values <= 0). NB: the gamma tables must be set.
+static inline uint32_t quantizeGamma(double value, double scale, uint32_t maxValue)
+{
+    if (!(value >= GAMMA_MIN_VALUE)) return 0; // NB: includes NaN.
+    if (value >= 1.0) return maxValue;
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const int exponent = (int)((bits >> 52) & 0x7ff) - 1023;
+    const uint64_t mantissa = bits & ((1ULL << 52) - 1);
+
+    // Interpolate between the segment's end points.
+    const int shift = 52 - GAMMA_SEGMENT_BITS;
+    const uint64_t iSegment = mantissa >> shift;
+    const double t = (double)(mantissa & ((1ULL << shift) - 1)) / (double)(1ULL << shift);
 
-    // Write translated [0, 65535] value for each color component and flip
-    // byte ordering.
-    uint16_t bytes[3];
+    const double m0 = gammaMantissa[iSegment];
+    const double m1 = gammaMantissa[iSegment + 1];
+    const double corrected = (m0 + (m1 - m0) * t) * gammaExponent[exponent - GAMMA_MIN_EXPONENT];
 
-    bytes[0] = FLIP_BYTES((uint16_t)(65536 * clamp(r, 0.0, 0.999)));
-    bytes[1] = FLIP_BYTES((uint16_t)(65536 * clamp(g, 0.0, 0.999)));
-    bytes[2] = FLIP_BYTES((uint16_t)(65536 * clamp(b, 0.0, 0.999)));
+    const double scaled = scale * corrected;
+    const uint32_t quantized = (uint32_t)scaled;
+    const double fraction = scaled - quantized;
+
+    if (fraction < GAMMA_TOLERANCE || fraction > 1.0 - GAMMA_TOLERANCE)
+    {
+        const double exact = pow(value, 1.0 / 2.2);
+
+        return min((uint32_t)(scale * exact), maxValue);
+    }
+
+    return min(quantized, maxValue);
+}
+
+
+/// Gamma corrects a value in the range [0, 1] and translates it to [0, 255].
+static inline uint8_t quantize8Bit(double value)
+{
+    return (uint8_t)quantizeGamma(value, 256.0, 255);
+}
+
+
+/// Gamma corrects a value in the range [0, 1] and translates it to [0, 65535].
+static inline uint16_t quantize16Bit(double value)
+{
+    return (uint16_t)quantizeGamma(value, 65536.0, 65470);
+}
+
+
+static inline void writePixelToFile(FILE *fp, Color3 *pixel)
+{
+    if (!fp || !pixel) return;
 
-    fwrite(bytes, sizeof(uint16_t), 3, fp);
+    // Write gamma corrected [0, 255] value for each color component.
+    fprintf(fp, "%d %d %d\n", quantize8Bit(pixel->r), quantize8Bit(pixel->g), quantize8Bit(pixel->b));
 }
@@ -10,6 +10,7 @@
 
 #include "utility/Vector3.h"
 #include <stdbool.h>
+#include <stdio.h>
 
 #define NUM_PIXELS(image) (image)->width *(image)->height
 
@@ -29,6 +30,27 @@ bool writeBinaryPPMImage(PPMImage *image, const char *fpath);
 bool writeBinary16BitPPMImage(PPMImage *image, const char *fpath);
 // bool writeTo32BitARGBBuffer(PPMImage *image, void *basePtr, size_t bytesPerRow);
 
+// The binary writers gamma correct and quantize rows in parallel into a buffer which is written with a single call.
+
+// Writes a binary PPM image incrementally so that the whole image never needs to be in memory. Rows are written in
+// file order (top row first) as packed float RGB values in the range [0, 1].
+typedef struct
+{
+    FILE *fp;
+    int width;
+    int height;
+    int bitDepth;
+    int rowsWritten;
+    bool failed;
+} PPMStream;
+
+// Opens a stream for a width x height image with 8 or 16 bits per channel. Returns NULL on failure.
+PPMStream *openPPMStream(const char *fpath, int width, int height, int bitDepth);
+bool writePPMStreamRows(PPMStream *stream, const float *rgb, int numRows);
+
+// Closes the stream. Returns false if a write failed or not all rows were written.
+bool closePPMStream(PPMStream *stream);
+
 void clearImage(PPMImage *image);
 void fadeImage(PPMImage *image, double fadeFactor);
 void copyImage(PPMImage *imageDst, PPMImage *imageSrc);
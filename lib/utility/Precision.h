@@ -0,0 +1,26 @@
+/**
+ * @file Precision.h
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+/*
+ * Scalar type used by the math core and the render path. Double precision is the default. Build with
+ * -DCPHOTON_FLOAT32 (bazel build --config=float32) for a single-precision render path which halves the size of
+ * Vector3 (24 --> 12 bytes) and everything built from it.
+ */
+#ifdef CPHOTON_FLOAT32
+typedef float Real;
+
+/* Relative offset applied to spawned ray origins to avoid self-intersection (see Hit::spawnRay). */
+#define kRayOffsetEpsilon 1e-4f
+#else
+typedef double Real;
+
+#define kRayOffsetEpsilon 1e-7
+#endif
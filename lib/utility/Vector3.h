@@ -8,47 +8,315 @@
 #ifndef Vector3_h
 #define Vector3_h
 
+#include "utility/Precision.h"
 #include <math.h>
 #include <stdbool.h>
 
 #define kZeroTolerance 1e-8
 
-typedef struct
+/*
+ * The arithmetic operations are defined inline in this header so that they can be inlined into the C++ engine's hot
+ * loops without LTO. In C++ they are constexpr where possible.
+ *
+ * Building with -DCPHOTON_SIMD (bazel build --config=simd) pads Vector3 to 4 lanes and backs the arithmetic with SSE
+ * (float, 4 x 32-bit lanes) or AVX (double, 4 x 64-bit lanes). If the instruction set is unavailable the scalar
+ * implementation is used.
+ */
+#if defined(CPHOTON_SIMD) && defined(CPHOTON_FLOAT32) && defined(__SSE__)
+#define VECTOR3_SSE
+#include <immintrin.h>
+#elif defined(CPHOTON_SIMD) && !defined(CPHOTON_FLOAT32) && defined(__AVX__)
+#define VECTOR3_AVX
+#include <immintrin.h>
+#endif
+
+#if defined(VECTOR3_SSE) || defined(VECTOR3_AVX)
+#define VECTOR3_SIMD
+#endif
+
+// clang-format off
+#ifdef VECTOR3_SIMD
+#define VECTOR3_ALIGNED __attribute__((aligned(4 * sizeof(Real))))
+#else
+#define VECTOR3_ALIGNED
+#endif
+
+#ifdef __cplusplus
+#define VECTOR3_INLINE inline
+#ifdef VECTOR3_SIMD
+#define VECTOR3_CONSTEXPR inline
+#else
+#define VECTOR3_CONSTEXPR constexpr inline
+#endif
+#else
+#define VECTOR3_INLINE static inline
+#define VECTOR3_CONSTEXPR static inline
+#endif
+// clang-format on
+
+/* NB: x, y, z are the first union members so that they are the active members in a constant expression. */
+typedef struct VECTOR3_ALIGNED
 {
     union
     {
-        double r, x;
+        Real x, r;
     };
     union
     {
-        double g, y;
+        Real y, g;
     };
     union
     {
-        double b, z;
+        Real z, b;
     };
+#ifdef VECTOR3_SIMD
+    Real w; /* Padding lane */
+#endif
 } Vector3, Point3, Color3;
 
-double lengthSquared(Vector3 v);
-double vectorLength(Vector3 v);
-double dot(Vector3 u, Vector3 v);
-
-Vector3 flipVector(Vector3 v);
-Vector3 scaleVector(Vector3 v, const double scalar);
-Vector3 unitVector(Vector3 v);
-Vector3 cross(Vector3 u, Vector3 v);
-Vector3 subtractVectors(Vector3 u, Vector3 v);
-Vector3 addVectors(Vector3 u, Vector3 v);
-Vector3 vector3(double x, double y, double z);
-Vector3 makeVectorFromPoints(Point3 ptA, Point3 ptB);
-Point3 point3(double x, double y, double z);
-Color3 color3(double r, double g, double b);
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+VECTOR3_CONSTEXPR Vector3 vector3(Real x, Real y, Real z)
+{
+    Vector3 v = {x, y, z};
+
+    return v;
+}
+
+
+VECTOR3_CONSTEXPR Point3 point3(Real x, Real y, Real z)
+{
+    return vector3(x, y, z);
+}
+
+
+VECTOR3_CONSTEXPR Color3 color3(Real r, Real g, Real b)
+{
+    return vector3(r, g, b);
+}
+
+
+VECTOR3_CONSTEXPR Vector3 zeroVector(void)
+{
+    return vector3(0, 0, 0);
+}
+
+
+#if defined(VECTOR3_SSE)
+
+VECTOR3_INLINE __m128 loadVector3(Vector3 v)
+{
+    return _mm_load_ps(&v.x);
+}
+
+
+VECTOR3_INLINE Vector3 storeVector3(__m128 lanes)
+{
+    Vector3 v;
+    _mm_store_ps(&v.x, lanes);
+    return v;
+}
+
+
+VECTOR3_INLINE Vector3 addVectors(Vector3 u, Vector3 v)
+{
+    return storeVector3(_mm_add_ps(loadVector3(u), loadVector3(v)));
+}
+
+
+VECTOR3_INLINE Vector3 subtractVectors(Vector3 u, Vector3 v)
+{
+    return storeVector3(_mm_sub_ps(loadVector3(u), loadVector3(v)));
+}
+
+
+VECTOR3_INLINE Vector3 scaleVector(Vector3 v, const Real scalar)
+{
+    return storeVector3(_mm_mul_ps(loadVector3(v), _mm_set1_ps(scalar)));
+}
+
+
+VECTOR3_INLINE Color3 multiplyColors(Color3 color1, Color3 color2)
+{
+    return storeVector3(_mm_mul_ps(loadVector3(color1), loadVector3(color2)));
+}
+
+
+VECTOR3_INLINE Real dot(Vector3 u, Vector3 v)
+{
+    Vector3 product = storeVector3(_mm_mul_ps(loadVector3(u), loadVector3(v)));
+
+    return (product.x + product.y + product.z);
+}
+
+
+/* Rotates the lanes (x, y, z, w) -> (y, z, x, w). */
+VECTOR3_INLINE __m128 rotateLanes(__m128 lanes)
+{
+    return _mm_shuffle_ps(lanes, lanes, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+#elif defined(VECTOR3_AVX)
+
+VECTOR3_INLINE __m256d loadVector3(Vector3 v)
+{
+    return _mm256_load_pd(&v.x);
+}
+
+
+VECTOR3_INLINE Vector3 storeVector3(__m256d lanes)
+{
+    Vector3 v;
+    _mm256_store_pd(&v.x, lanes);
+    return v;
+}
+
+
+VECTOR3_INLINE Vector3 addVectors(Vector3 u, Vector3 v)
+{
+    return storeVector3(_mm256_add_pd(loadVector3(u), loadVector3(v)));
+}
+
+
+VECTOR3_INLINE Vector3 subtractVectors(Vector3 u, Vector3 v)
+{
+    return storeVector3(_mm256_sub_pd(loadVector3(u), loadVector3(v)));
+}
+
+
+VECTOR3_INLINE Vector3 scaleVector(Vector3 v, const Real scalar)
+{
+    return storeVector3(_mm256_mul_pd(loadVector3(v), _mm256_set1_pd(scalar)));
+}
+
+
+VECTOR3_INLINE Color3 multiplyColors(Color3 color1, Color3 color2)
+{
+    return storeVector3(_mm256_mul_pd(loadVector3(color1), loadVector3(color2)));
+}
+
+
+VECTOR3_INLINE Real dot(Vector3 u, Vector3 v)
+{
+    Vector3 product = storeVector3(_mm256_mul_pd(loadVector3(u), loadVector3(v)));
+
+    return (product.x + product.y + product.z);
+}
+
+
+/* Rotates the lanes (x, y, z, w) -> (y, z, x, w). AVX has no cross-lane permute so this swaps the 128-bit halves. */
+VECTOR3_INLINE __m256d rotateLanes(__m256d lanes)
+{
+    const __m256d swapped = _mm256_permute2f128_pd(lanes, lanes, 0x01);
+
+    return _mm256_blend_pd(_mm256_shuffle_pd(lanes, swapped, 0x1), _mm256_shuffle_pd(swapped, lanes, 0x8), 0xC);
+}
+
+#endif
+
+#ifdef VECTOR3_SIMD
+
+/* u x v = rotate(u * rotate(v) - rotate(u) * v) */
+VECTOR3_INLINE Vector3 cross(Vector3 u, Vector3 v)
+{
+#ifdef VECTOR3_SSE
+    const __m128 a = loadVector3(u), b = loadVector3(v);
+    const __m128 c = _mm_sub_ps(_mm_mul_ps(a, rotateLanes(b)), _mm_mul_ps(rotateLanes(a), b));
+#else
+    const __m256d a = loadVector3(u), b = loadVector3(v);
+    const __m256d c = _mm256_sub_pd(_mm256_mul_pd(a, rotateLanes(b)), _mm256_mul_pd(rotateLanes(a), b));
+#endif
+    return storeVector3(rotateLanes(c));
+}
+
+#else
+
+VECTOR3_CONSTEXPR Vector3 addVectors(Vector3 u, Vector3 v)
+{
+    return vector3(u.x + v.x, u.y + v.y, u.z + v.z);
+}
+
+
+VECTOR3_CONSTEXPR Vector3 subtractVectors(Vector3 u, Vector3 v)
+{
+    return vector3(u.x - v.x, u.y - v.y, u.z - v.z);
+}
+
+
+VECTOR3_CONSTEXPR Vector3 scaleVector(Vector3 v, const Real scalar)
+{
+    return vector3(v.x * scalar, v.y * scalar, v.z * scalar);
+}
+
+
+VECTOR3_CONSTEXPR Color3 multiplyColors(Color3 color1, Color3 color2)
+{
+    return vector3(color1.x * color2.x, color1.y * color2.y, color1.z * color2.z);
+}
+
+
+VECTOR3_CONSTEXPR Real dot(Vector3 u, Vector3 v)
+{
+    return (u.x * v.x + u.y * v.y + u.z * v.z);
+}
+
+
+VECTOR3_CONSTEXPR Vector3 cross(Vector3 u, Vector3 v)
+{
+    return vector3(u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x);
+}
+
+#endif
+
+
+VECTOR3_CONSTEXPR Vector3 makeVectorFromPoints(Point3 ptA, Point3 ptB)
+{
+    return subtractVectors(ptA, ptB);
+}
+
+
+VECTOR3_CONSTEXPR Vector3 flipVector(Vector3 v)
+{
+    return vector3(-v.x, -v.y, -v.z);
+}
+
+
+VECTOR3_CONSTEXPR Real lengthSquared(Vector3 v)
+{
+    return dot(v, v);
+}
+
+
+VECTOR3_INLINE Real vectorLength(Vector3 v)
+{
+    return sqrt(lengthSquared(v));
+}
+
+
+VECTOR3_INLINE Vector3 unitVector(Vector3 v)
+{
+    const Real vLength = vectorLength(v);
+
+    return (vLength > 0.0) ? scaleVector(v, 1.0 / vLength) : v;
+}
+
+
+VECTOR3_INLINE bool isNearlyZero(Vector3 v)
+{
+    return (fabs(v.x) < kZeroTolerance && fabs(v.y) < kZeroTolerance && fabs(v.z) < kZeroTolerance);
+}
+
+
 Vector3 randomUnitSphereVector(void);
 Vector3 randomUnitVector(void);
 Vector3 randomInUnitDisk(void);
-bool isNearlyZero(Vector3 v);
-Color3 multiplyColors(Color3 color1, Color3 color2);
 int randomInt(int min, int max);
-Vector3 zeroVector(void);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* Vector3_h */
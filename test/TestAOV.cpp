@@ -0,0 +1,128 @@
+/**
+ * @file TestAOV.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/AOV.hpp"
+#include "engine/PhotonEngineImpl.hpp"
+#include "engine/SceneLoader.hpp"
+#include <cmath>
+#include <cstring>
+#include <gtest/gtest.h>
+
+
+TEST(AOV, TestParse)
+{
+    AOVMask aovs;
+
+    ASSERT_TRUE(parseAOVs("depth", aovs));
+    EXPECT_EQ(aovs, aovBit(AOV::Depth));
+
+    ASSERT_TRUE(parseAOVs("variance,normal,depth", aovs));
+    EXPECT_EQ(aovs, aovBit(AOV::Depth) | aovBit(AOV::Normal) | aovBit(AOV::Variance));
+
+    ASSERT_TRUE(parseAOVs("time,rays,samples", aovs));
+    EXPECT_EQ(aovs, aovBit(AOV::Time) | aovBit(AOV::RayCount) | aovBit(AOV::SampleCount));
+    EXPECT_STREQ(aovName(AOV::RayCount), "rays");
+
+    ASSERT_TRUE(parseAOVs("all", aovs));
+    EXPECT_EQ(aovs, kAllAOVs);
+
+    EXPECT_FALSE(parseAOVs("", aovs));
+    EXPECT_FALSE(parseAOVs("depths", aovs));
+    EXPECT_FALSE(parseAOVs("depth,,normal", aovs));
+    EXPECT_FALSE(parseAOVs("depth,bogus", aovs));
+}
+
+
+TEST(AOV, TestChannels)
+{
+    const AOVMask aovs = aovBit(AOV::MaterialId) | aovBit(AOV::Normal) | aovBit(AOV::Depth);
+
+    const char *names[16];
+    ASSERT_EQ(numAOVChannels(aovs), 5);
+    ASSERT_EQ(aovChannelNames(aovs, names), 5);
+
+    const char *expected[5] = {"Z", "N.X", "N.Y", "N.Z", "materialId"};
+
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_STREQ(names[i], expected[i]);
+    }
+
+    EXPECT_EQ(numAOVChannels(kAllAOVs), 13);
+
+    // Values are stored in the same order.
+    PixelAOVs pixel = {.depth = 2.0,
+                       .normal = vector3(0, 1, 0),
+                       .albedo = color3(0.5, 0.5, 0.5),
+                       .material = 3,
+                       .numSamples = 64,
+                       .variance = 0.25};
+
+    float values[5];
+    pixel.store(aovs, values);
+
+    const float expectedValues[5] = {2.0f, 0.0f, 1.0f, 0.0f, 3.0f};
+    EXPECT_EQ(memcmp(values, expectedValues, sizeof(values)), 0);
+}
+
+
+TEST(AOV, TestSamplePixel)
+{
+    Scene scene;
+    SceneLoader loader(scene);
+
+    loader.loadString("material light emitter 2 2 2\n"
+                      "material red matte 1 0 0\n"
+                      "plane red 0 0 -2  0 0 1\n");
+
+    CompiledScene *compiled = scene.compiledScene();
+    ASSERT_TRUE(compiled != nullptr);
+
+    // Narrow field of view looking at the plane.
+    Camera camera(1.0, 1.0, 1.0, 0.0, point3(0, 0, 0), point3(0, 0, -1));
+
+    PixelAOVs aovs;
+    (void)samplePixel(1, 1, 3, 3, &camera, compiled, 1000, &aovs);
+
+    EXPECT_NEAR(aovs.depth, 2.0, 1e-3);
+    EXPECT_NEAR(aovs.normal.z, 1.0, 1e-6);
+    EXPECT_NEAR(aovs.albedo.r, 1.0, 1e-6);
+    EXPECT_NEAR(aovs.albedo.g, 0.0, 1e-6);
+    EXPECT_EQ(aovs.material, 1);
+    EXPECT_GT(aovs.numSamples, 0);
+    EXPECT_GE(aovs.variance, 0.0);
+    EXPECT_GE(aovs.numRays, aovs.numSamples); // Every sample traces a camera ray.
+    EXPECT_GE(aovs.time, 0.0);
+
+    EXPECT_EQ(aovs.cost, 0.0); // The thread is not counting traversals.
+
+    // Convergence is not tested until the minimum samples are taken.
+    (void)samplePixel(1, 1, 3, 3, &camera, compiled, 16, &aovs);
+    EXPECT_EQ(aovs.numSamples, 16);
+
+    // The plane is the only primitive and there are no BVH nodes.
+    TraversalCounters counters;
+    CompiledScene::setThreadCounters(&counters);
+    (void)samplePixel(1, 1, 3, 3, &camera, compiled, 16, &aovs);
+    CompiledScene::setThreadCounters(nullptr);
+
+    EXPECT_EQ(aovs.cost, 1.0);
+    EXPECT_EQ(counters.numNodesVisited, 0);
+    EXPECT_EQ(counters.numPrimitivesTested, counters.numTraversals);
+
+    // Looking away from the plane every sample misses.
+    Camera away(1.0, 1.0, 1.0, 0.0, point3(0, 0, 0), point3(0, 0, 1));
+
+    (void)samplePixel(1, 1, 3, 3, &away, compiled, 1000, &aovs);
+
+    EXPECT_TRUE(std::isinf(aovs.depth));
+    EXPECT_EQ(aovs.normal.z, 0.0);
+    EXPECT_EQ(aovs.material, -1);
+    EXPECT_GT(aovs.albedo.b, 0.0); // Background.
+}
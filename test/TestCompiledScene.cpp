@@ -0,0 +1,344 @@
+/**
+ * @file TestCompiledScene.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/CompiledScene.hpp"
+#include "engine/Scene.hpp"
+#include "engine/materials/MaterialTable.hpp"
+#include "engine/primitives/Primitives.hpp"
+#include "test/TestHelpers.hpp"
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <random>
+
+/* Generic primitive which is only hit once: a square in the plane z = 0 facing +z */
+class HitOncePrimitive : public Primitive
+{
+public:
+    HitOncePrimitive(MaterialId material_) : Primitive(material_) {}
+
+    bool hit(Ray &ray, Time tmin, Time tmax, Hit &hit) override
+    {
+        if (numHits++ > 0 || ray.direction.z == 0.0) return false;
+
+        const Real t = -ray.origin.z / ray.direction.z;
+        if (!Hit::isValid(t, tmin, tmax)) return false;
+
+        hit.t = t;
+        hit.hitPt = ray.pointAtTime(t);
+        hit.normal = vector3(0, 0, 1);
+        hit.frontFace = true;
+        hit.u = hit.v = 0.0;
+        hit.material = material;
+        return true;
+    }
+
+    bool boundingBox(AABB *box) override
+    {
+        *box = AABB(point3(-1, -1, -0.01), point3(1, 1, 0.01));
+        return true;
+    }
+
+    int numHits{0};
+};
+
+static void BuildMixedScene(std::mt19937 &generator, Scene &scene);
+
+
+TEST(CompiledScene, TestMatchesBVH)
+{
+    std::mt19937 generator(2026);
+
+    Scene scene;
+    BuildMixedScene(generator, scene);
+
+    // NB: the legacy BVH can still be built after the scene is compiled.
+    CompiledScene *compiled = scene.compiledScene();
+    BVHNode *bvh = scene.BVH();
+    ASSERT_TRUE(bvh != nullptr);
+    ASSERT_TRUE(compiled != nullptr);
+    EXPECT_GT(compiled->numNodes(), 1);
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        Ray ray(RandomPoint(generator, 12.0), RandomUnitVector(generator));
+
+        Hit expected, result;
+        const bool expectedHit = bvh->hit(ray, 0.0, INFINITY, expected);
+        const bool resultHit = compiled->hit(ray, 0.0, INFINITY, result);
+
+        ASSERT_EQ(resultHit, expectedHit);
+
+        if (resultHit)
+        {
+            EXPECT_NEAR(result.t, expected.t, kTolerance);
+            EXPECT_NEAR(result.normal.x, expected.normal.x, kTolerance);
+            EXPECT_NEAR(result.normal.y, expected.normal.y, kTolerance);
+            EXPECT_NEAR(result.normal.z, expected.normal.z, kTolerance);
+            EXPECT_EQ(result.material, expected.material);
+        }
+    }
+}
+
+
+/* Compiling does not build the legacy BVH (which draws random split axes) */
+TEST(CompiledScene, TestCompileWithoutBVH)
+{
+    std::mt19937 generator(2026);
+
+    Scene scene;
+    BuildMixedScene(generator, scene);
+
+    srand(7);
+    const int expected = rand();
+
+    srand(7);
+    ASSERT_TRUE(scene.compiledScene() != nullptr);
+    EXPECT_EQ(rand(), expected);
+
+    Scene empty;
+    EXPECT_EQ(empty.compiledScene(), nullptr);
+}
+
+
+/* The hit of a generic primitive is kept if it cannot be recomputed */
+TEST(CompiledScene, TestGenericHitNotRecomputed)
+{
+    Scene scene;
+    const MaterialId material = scene.materials().addMatte(color3(1, 1, 1));
+
+    HitOncePrimitive *primitive = scene.arena().make<HitOncePrimitive>(material);
+    scene.addObject(primitive);
+
+    Ray ray(point3(0, 0, 2), vector3(0, 0, -1));
+    Hit hit;
+
+    ASSERT_TRUE(scene.compiledScene()->hit(ray, 0.0, INFINITY, hit));
+    EXPECT_EQ(primitive->numHits, 2);
+    EXPECT_DOUBLE_EQ(hit.t, 2.0);
+    EXPECT_DOUBLE_EQ(hit.hitPt.z, 0.0);
+    EXPECT_DOUBLE_EQ(hit.normal.z, 1.0);
+    EXPECT_TRUE(hit.frontFace);
+    EXPECT_EQ(hit.material, material);
+}
+
+
+TEST(CompiledScene, TestUnboundedOnly)
+{
+    Scene scene;
+    SceneArena &arena = scene.arena();
+    MaterialTable &materials = scene.materials();
+    scene.addObject(arena.make<Plane>(point3(0, 0, 0), vector3(0, 1, 0), materials.addMatte(color3(1, 1, 1))));
+
+    CompiledScene *compiled = scene.compiledScene();
+    ASSERT_TRUE(compiled != nullptr);
+    EXPECT_EQ(compiled->numNodes(), 0);
+
+    Ray ray(point3(0, 1, 0), vector3(0, -1, 0));
+    Hit hit;
+
+    ASSERT_TRUE(compiled->hit(ray, 0.0, INFINITY, hit));
+    EXPECT_DOUBLE_EQ(hit.t, 1.0);
+}
+
+
+TEST(CompiledScene, TestCubeExitNormal)
+{
+    Scene scene;
+    SceneArena &arena = scene.arena();
+    MaterialTable &materials = scene.materials();
+    scene.addObject(arena.make<Cube>(point3(0, 0, 0), nullptr, 2.0, materials.addMatte(color3(1, 1, 1))));
+
+    // Ray starts inside the cube so the hit is the exit through the +x face.
+    Ray ray(point3(0, 0.5, 0.25), vector3(1, 0, 0));
+    Hit hit;
+
+    ASSERT_TRUE(scene.compiledScene()->hit(ray, 0.0, INFINITY, hit));
+    EXPECT_DOUBLE_EQ(hit.t, 1.0);
+    EXPECT_FALSE(hit.frontFace);
+    EXPECT_DOUBLE_EQ(hit.normal.x, -1.0);
+    EXPECT_DOUBLE_EQ(hit.normal.y, 0.0);
+    EXPECT_DOUBLE_EQ(hit.normal.z, 0.0);
+}
+
+
+TEST(CompiledScene, TestBVHStats)
+{
+    std::mt19937 generator(2026);
+
+    Scene scene;
+    BuildMixedScene(generator, scene);
+
+    CompiledScene *compiled = scene.compiledScene();
+    ASSERT_TRUE(compiled != nullptr);
+
+    const BVHStats stats = compiled->bvhStats();
+
+    EXPECT_EQ(stats.numNodes, compiled->numNodes());
+    EXPECT_EQ(stats.numNodes, 2 * stats.numLeaves - 1); // Binary tree.
+    EXPECT_EQ(stats.numPrimitives + stats.numUnbounded, compiled->numPrimitives());
+    EXPECT_EQ(stats.numUnbounded, 1);
+
+    size_t numLeaves = 0, numPrimitives = 0;
+
+    for (size_t depth = 0; depth < stats.leavesAtDepth.size(); ++depth)
+    {
+        numLeaves += stats.leavesAtDepth[depth];
+    }
+
+    for (size_t count = 0; count < stats.leavesWithCount.size(); ++count)
+    {
+        numPrimitives += count * stats.leavesWithCount[count];
+    }
+
+    EXPECT_EQ(numLeaves, stats.numLeaves);
+    EXPECT_EQ(numPrimitives, stats.numPrimitives);
+    EXPECT_EQ(stats.leavesAtDepth.size(), stats.maxDepth + 1);
+
+    // The root is always tested and every primitive is tested at most once.
+    EXPECT_GE(stats.sahCost, CompiledScene::kNodeCost);
+    EXPECT_LE(stats.sahCost, stats.numNodes * CompiledScene::kNodeCost + stats.numPrimitives);
+}
+
+
+TEST(CompiledScene, TestTraversalCounters)
+{
+    std::mt19937 generator(2026);
+
+    Scene scene;
+    BuildMixedScene(generator, scene);
+
+    CompiledScene *compiled = scene.compiledScene();
+    ASSERT_TRUE(compiled != nullptr);
+    ASSERT_EQ(CompiledScene::threadCounters(), nullptr);
+
+    const int kNumRays = 1000;
+    TraversalCounters counters;
+
+    for (int i = 0; i < kNumRays; ++i)
+    {
+        Ray ray(RandomPoint(generator, 12.0), RandomUnitVector(generator));
+
+        // Counting does not change the hits.
+        Hit expected, result;
+        const bool expectedHit = compiled->hit(ray, 0.0, INFINITY, expected);
+
+        CompiledScene::setThreadCounters(&counters);
+        const bool resultHit = compiled->hit(ray, 0.0, INFINITY, result);
+        CompiledScene::setThreadCounters(nullptr);
+
+        ASSERT_EQ(resultHit, expectedHit);
+        if (resultHit)
+        {
+            EXPECT_EQ(result.t, expected.t);
+        }
+    }
+
+    EXPECT_EQ(counters.numTraversals, kNumRays);
+    EXPECT_GE(counters.numNodesVisited, kNumRays); // The root is always visited.
+    EXPECT_LE(counters.numNodesVisited, kNumRays * compiled->numNodes());
+    EXPECT_GE(counters.numPrimitivesTested, kNumRays); // The plane is always tested.
+    EXPECT_LE(counters.numPrimitivesTested, kNumRays * compiled->numPrimitives());
+}
+
+
+TEST(CompiledScene, TestPackedSpheresMatchScalar)
+{
+    const int kNumSpheres = 11; // Not a multiple of the lane width.
+
+    std::mt19937 generator(2026);
+    std::uniform_real_distribution<Real> position(-2.0, 2.0), size(0.1, 1.0);
+
+    Real centerX[kNumSpheres], centerY[kNumSpheres], centerZ[kNumSpheres], radius[kNumSpheres];
+
+    for (int i = 0; i < kNumSpheres; ++i)
+    {
+        centerX[i] = position(generator);
+        centerY[i] = position(generator);
+        centerZ[i] = position(generator);
+        radius[i] = size(generator);
+    }
+
+    for (int iRay = 0; iRay < 1000; ++iRay)
+    {
+        Ray ray(RandomPoint(generator, 3.0), RandomUnitVector(generator));
+
+        // Closest hit from testing each sphere in turn.
+        int iExpected = -1;
+        Hit expected;
+
+        for (int i = 0; i < kNumSpheres; ++i)
+        {
+            const Real tmax = (iExpected >= 0) ? expected.t : INFINITY;
+
+            if (Sphere::intersect(point3(centerX[i], centerY[i], centerZ[i]), radius[i], ray, 0.0, tmax, expected))
+            {
+                iExpected = i;
+            }
+        }
+
+        Real hitTime;
+        const int iResult =
+            Sphere::intersectPacked(centerX, centerY, centerZ, radius, kNumSpheres, ray, 0.0, INFINITY, &hitTime);
+
+        ASSERT_EQ(iResult, iExpected);
+
+        if (iResult >= 0)
+        {
+            EXPECT_NEAR(hitTime, expected.t, kTolerance);
+        }
+    }
+}
+
+
+static void BuildMixedScene(std::mt19937 &generator, Scene &scene)
+{
+    SceneArena &arena = scene.arena();
+    MaterialTable &materials = scene.materials();
+
+    MaterialId materialIds[] = {materials.addMatte(color3(1, 0, 0)), materials.addMatte(color3(0, 1, 0)),
+                                materials.addMatte(color3(0, 0, 1))};
+
+    for (int i = 0; i < 40; ++i)
+    {
+        MaterialId material = materialIds[i % 3];
+        Point3 center = RandomPoint(generator, 10.0);
+
+        switch (i % 7)
+        {
+            case 0:
+                scene.addObject(arena.make<Sphere>(center, 0.5, material));
+                break;
+            case 1:
+                scene.addObject(arena.make<Cube>(center, arena.makeRotation(vector3(10 * i, 0, 5 * i)), 1.0, material));
+                break;
+            case 2:
+                scene.addObject(arena.make<Triangle>(center, addVectors(center, vector3(1, 0, 0)),
+                                                     addVectors(center, vector3(0, 1, 0)), material));
+                break;
+            case 3:
+                scene.addObject(arena.make<Disc>(center, vector3(0, 0, 1), 0.75, material));
+                break;
+            case 4:
+                scene.addObject(
+                    arena.make<Cylinder>(center, arena.makeRotation(vector3(0, 0, 15 * i)), 0.5, 1.0, material));
+                break;
+            case 5:
+                scene.addObject(arena.make<Cone>(center, nullptr, 1.0, material));
+                break;
+            case 6:
+                scene.addObject(
+                    arena.make<CSGNode>(arena.make<Sphere>(center, 0.75, material),
+                                        arena.make<Sphere>(addVectors(center, vector3(0.5, 0, 0)), 0.5, material),
+                                        CSGNode::CSGDifference));
+                break;
+        }
+    }
+
+    scene.addObject(arena.make<Plane>(point3(0, -11, 0), vector3(0, 1, 0), materialIds[0]));
+}
@@ -0,0 +1,266 @@
+/**
+ * @file TestCylinderCone.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/SceneArena.hpp"
+#include "engine/primitives/CSGNode.hpp"
+#include "engine/primitives/Cone.hpp"
+#include "engine/primitives/Cube.hpp"
+#include "engine/primitives/Cylinder.hpp"
+#include "test/TestHelpers.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+static bool InsideCylinder(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Point3 point);
+static bool InsideCone(Point3 center, Rotate3 *rotationMatrix, Real height, Point3 point);
+
+
+TEST(CylinderCone, TestCylinderThroughSide)
+{
+    Cylinder cylinder(point3(0, 0, 0), nullptr, 1.0, 2.0, 0);
+
+    Ray ray(point3(-5, 0.5, 0), vector3(1, 0, 0));
+
+    Hit entry, exit;
+    ASSERT_TRUE(cylinder.hit(ray, entry, Primitive::Entry));
+    ASSERT_TRUE(cylinder.hit(ray, exit, Primitive::Exit));
+
+    EXPECT_NEAR(entry.t, 4.0, kTolerance);
+    EXPECT_NEAR(exit.t, 6.0, kTolerance);
+
+    EXPECT_TRUE(entry.frontFace);
+    EXPECT_FALSE(exit.frontFace);
+    EXPECT_NEAR(entry.normal.x, -1.0, kTolerance);
+    EXPECT_NEAR(exit.normal.x, -1.0, kTolerance); // Flipped to face the ray.
+}
+
+
+TEST(CylinderCone, TestCylinderThroughCaps)
+{
+    Cylinder cylinder(point3(0, 1, 0), nullptr, 1.0, 2.0, 0);
+
+    Ray ray(point3(0.25, 10, 0.25), vector3(0, -1, 0));
+
+    Hit hit;
+    ASSERT_TRUE(cylinder.hit(ray, 0.0, INFINITY, hit));
+
+    EXPECT_NEAR(hit.t, 8.0, kTolerance);
+    EXPECT_NEAR(hit.normal.y, 1.0, kTolerance);
+
+    // Inside: hit the bottom cap from within.
+    Ray inside(point3(0.25, 1, 0.25), vector3(0, -1, 0));
+
+    ASSERT_TRUE(cylinder.hit(inside, 0.0, INFINITY, hit));
+    EXPECT_NEAR(hit.t, 1.0, kTolerance);
+    EXPECT_FALSE(hit.frontFace);
+    EXPECT_NEAR(hit.normal.y, 1.0, kTolerance);
+
+    // Parallel to the axis outside of the cylinder.
+    Ray outside(point3(1.5, 10, 0), vector3(0, -1, 0));
+    EXPECT_FALSE(cylinder.hit(outside, 0.0, INFINITY, hit));
+
+    // Parallel to the caps above the cylinder.
+    Ray above(point3(-5, 2.5, 0), vector3(1, 0, 0));
+    EXPECT_FALSE(cylinder.hit(above, 0.0, INFINITY, hit));
+}
+
+
+TEST(CylinderCone, TestConeThroughBaseAndSide)
+{
+    Cone cone(point3(0, 0, 0), nullptr, 1.0, 0);
+
+    // Down the axis: base at y = 1, apex at y = 0.
+    Ray axial(point3(0, 5, 0), vector3(0, -1, 0));
+
+    Hit entry, exit;
+    ASSERT_TRUE(cone.hit(axial, entry, Primitive::Entry));
+    ASSERT_TRUE(cone.hit(axial, exit, Primitive::Exit));
+
+    EXPECT_NEAR(entry.t, 4.0, kTolerance);
+    EXPECT_NEAR(exit.t, 5.0, kTolerance);
+    EXPECT_NEAR(entry.normal.y, 1.0, kTolerance);
+
+    // Through the side at y = 0.5 where the radius is 0.5.
+    Ray side(point3(-5, 0.5, 0), vector3(1, 0, 0));
+
+    ASSERT_TRUE(cone.hit(side, 0.0, INFINITY, entry));
+    EXPECT_NEAR(entry.t, 4.5, kTolerance);
+    EXPECT_NEAR(entry.normal.x, -M_SQRT1_2, kTolerance);
+    EXPECT_NEAR(entry.normal.y, -M_SQRT1_2, kTolerance);
+
+    // Crosses the lower half of the double cone only.
+    Ray below(point3(-5, -0.5, 0), vector3(1, 0, 0));
+    EXPECT_FALSE(cone.hit(below, 0.0, INFINITY, entry));
+
+    // Crosses both halves of the double cone: enters the upper cone through the side and leaves through the base.
+    Ray steep(point3(0.2, -1, 0), unitVector(vector3(0, 1, 0.1)));
+
+    ASSERT_TRUE(cone.hit(steep, entry, Primitive::Entry));
+    ASSERT_TRUE(cone.hit(steep, exit, Primitive::Exit));
+    EXPECT_GT(entry.hitPt.y, 0.0);
+    EXPECT_NEAR(exit.hitPt.y, 1.0, kTolerance);
+}
+
+
+/* The entry and exit times bound the points inside of the solid */
+TEST(CylinderCone, TestRandomRaysAgainstInside)
+{
+    SceneArena arena;
+
+    const Point3 center = point3(0.5, -0.5, 1);
+    Rotate3 *rotations[2] = {nullptr, arena.makeRotation(vector3(0.3, -0.7, 1.1))};
+
+    // NB: the times of grazing rays lose about half of the digits in the solve.
+    const Real kOffset = (sizeof(Real) == sizeof(double)) ? 1e-6 : 1e-2;
+
+    for (Rotate3 *rotationMatrix : rotations)
+    {
+        std::mt19937 generator(2026);
+        int numCylinderHits = 0, numConeHits = 0;
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            Ray ray = RandomRayTowards(generator, center, 4.0, 4.0, 1.5);
+            Real tEnter, tExit;
+
+            if (Cylinder::hitTimes(center, rotationMatrix, 1.0, 1.5, ray, &tEnter, &tExit))
+            {
+                ++numCylinderHits;
+
+                EXPECT_TRUE(InsideCylinder(center, rotationMatrix, 1.0, 1.5, ray.pointAtTime(0.5 * (tEnter + tExit))));
+                EXPECT_FALSE(InsideCylinder(center, rotationMatrix, 1.0, 1.5, ray.pointAtTime(tEnter - kOffset)));
+                EXPECT_FALSE(InsideCylinder(center, rotationMatrix, 1.0, 1.5, ray.pointAtTime(tExit + kOffset)));
+            }
+            else
+            {
+                for (Real t = 0.0; t < 10.0; t += 0.01)
+                    ASSERT_FALSE(InsideCylinder(center, rotationMatrix, 1.0, 1.5, ray.pointAtTime(t)));
+            }
+
+            if (Cone::hitTimes(center, rotationMatrix, 1.5, ray, &tEnter, &tExit))
+            {
+                ++numConeHits;
+
+                EXPECT_TRUE(InsideCone(center, rotationMatrix, 1.5, ray.pointAtTime(0.5 * (tEnter + tExit))));
+                EXPECT_FALSE(InsideCone(center, rotationMatrix, 1.5, ray.pointAtTime(tEnter - kOffset)));
+                EXPECT_FALSE(InsideCone(center, rotationMatrix, 1.5, ray.pointAtTime(tExit + kOffset)));
+            }
+            else
+            {
+                for (Real t = 0.0; t < 10.0; t += 0.01)
+                    ASSERT_FALSE(InsideCone(center, rotationMatrix, 1.5, ray.pointAtTime(t)));
+            }
+        }
+
+        EXPECT_GT(numCylinderHits, 200);
+        EXPECT_GT(numConeHits, 200);
+    }
+}
+
+
+/* The span query matches the entry and exit hits and keeps spans which overlap the range */
+TEST(CylinderCone, TestSpans)
+{
+    SceneArena arena;
+
+    const Point3 center = point3(0.5, -0.5, 1);
+    Cylinder cylinder(center, arena.makeRotation(vector3(0.3, -0.7, 1.1)), 1.0, 1.5, 3);
+    Cone cone(center, arena.makeRotation(vector3(-0.2, 0.4, 0.9)), 1.5, 4);
+
+    for (Primitive *primitive : {(Primitive *)&cylinder, (Primitive *)&cone})
+    {
+        std::mt19937 generator(2026);
+        int numHits = 0;
+
+        for (int i = 0; i < 500; ++i)
+        {
+            Ray ray = RandomRayTowards(generator, center, 4.0, 4.0, 1.5);
+
+            Hit entry, exit;
+            Span::SpanList spans;
+
+            const bool isHit = primitive->hit(ray, entry, Primitive::Entry);
+            ASSERT_EQ(primitive->hit(ray, 0.0, INFINITY, spans), isHit);
+            if (!isHit) continue;
+
+            ++numHits;
+            ASSERT_TRUE(primitive->hit(ray, exit, Primitive::Exit));
+            ASSERT_EQ(spans.size(), 1);
+
+            EXPECT_EQ(spans[0].entry.t, entry.t);
+            EXPECT_EQ(spans[0].exit.t, exit.t);
+            EXPECT_EQ(spans[0].entry.normal.x, entry.normal.x);
+            EXPECT_EQ(spans[0].exit.normal.y, exit.normal.y);
+            EXPECT_EQ(spans[0].entry.material, entry.material);
+            EXPECT_EQ(spans[0].exit.material, exit.material);
+
+            // From inside the solid the span covers the start of the range.
+            spans.clear();
+            EXPECT_TRUE(primitive->hit(ray, 0.5 * (entry.t + exit.t), INFINITY, spans));
+
+            // Beyond the exit there is no span.
+            spans.clear();
+            EXPECT_FALSE(primitive->hit(ray, exit.t + 1.0, INFINITY, spans));
+            EXPECT_TRUE(spans.empty());
+        }
+
+        EXPECT_GT(numHits, 100);
+    }
+}
+
+
+/* The caps are part of the solid's span so a cylinder can be subtracted */
+TEST(CylinderCone, TestCylinderInCSG)
+{
+    SceneArena arena;
+
+    // A cube with a vertical hole of radius 0.25 through it.
+    Primitive *cube = arena.make<Cube>(point3(0, 0, 0), nullptr, 1.0, 0);
+    Primitive *hole = arena.make<Cylinder>(point3(0, 0, 0), nullptr, 0.25, 2.0, 0);
+    CSGNode difference(cube, hole, CSGNode::CSGDifference);
+
+    Hit hit;
+
+    // Down the hole.
+    Ray axial(point3(0, 5, 0), vector3(0, -1, 0));
+    EXPECT_FALSE(difference.hit(axial, 0.0, INFINITY, hit));
+
+    // Down beside the hole.
+    Ray beside(point3(0.4, 5, 0), vector3(0, -1, 0));
+    ASSERT_TRUE(difference.hit(beside, 0.0, INFINITY, hit));
+    EXPECT_NEAR(hit.t, 4.5, kTolerance);
+
+    // Across through the hole: two spans either side of it.
+    Ray across(point3(-5, 0, 0), vector3(1, 0, 0));
+    ASSERT_TRUE(difference.hit(across, 0.0, INFINITY, hit));
+    EXPECT_NEAR(hit.t, 4.5, kTolerance);
+
+    Span::SpanList spans;
+    ASSERT_TRUE(difference.hit(across, 0.0, INFINITY, spans));
+    ASSERT_EQ(spans.size(), 2);
+    EXPECT_NEAR(spans.front().entry.t, 4.5, kTolerance);
+    EXPECT_NEAR(spans.front().exit.t, 4.75, kTolerance);
+    EXPECT_NEAR(spans.back().entry.t, 5.25, kTolerance);
+    EXPECT_NEAR(spans.back().exit.t, 5.5, kTolerance);
+}
+
+
+static bool InsideCylinder(Point3 center, Rotate3 *rotationMatrix, Real radius, Real height, Point3 point)
+{
+    const Point3 local = inverseRotation(subtractVectors(point, center), rotationMatrix);
+
+    return (local.x * local.x + local.z * local.z <= radius * radius) && (fabs(local.y) <= 0.5 * height);
+}
+
+
+static bool InsideCone(Point3 center, Rotate3 *rotationMatrix, Real height, Point3 point)
+{
+    const Point3 local = inverseRotation(subtractVectors(point, center), rotationMatrix);
+
+    return (local.x * local.x + local.z * local.z <= local.y * local.y) && (local.y >= 0.0) && (local.y <= height);
+}
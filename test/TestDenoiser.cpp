@@ -0,0 +1,99 @@
+/**
+ * @file TestDenoiser.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/Denoiser.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+extern "C"
+{
+#include "utility/Randomizer.h"
+}
+
+static double Variance(const std::vector<float> &rgb, int iStart, int iEnd, int width);
+
+
+TEST(Denoiser, TestConstantImage)
+{
+    const int width = 8, height = 8;
+
+    std::vector<float> rgb(width * height * 3, 0.5f);
+    std::vector<float> albedo(width * height * 3, 0.8f);
+    std::vector<float> normal(width * height * 3, 0.0f);
+
+    Denoiser().denoise(rgb.data(), albedo.data(), normal.data(), width, height, 2);
+
+    for (float value : rgb)
+    {
+        EXPECT_NEAR(value, 0.5f, 1e-5f);
+    }
+}
+
+
+TEST(Denoiser, TestNoiseAndEdges)
+{
+    // Left half is a dark surface and right half a bright surface with a different albedo. Both are noisy.
+    const int width = 32, height = 32;
+
+    std::vector<float> rgb(width * height * 3), albedo(width * height * 3), normal(width * height * 3, 0.0f);
+
+    for (int iRow = 0; iRow < height; ++iRow)
+    {
+        for (int iCol = 0; iCol < width; ++iCol)
+        {
+            const bool isLeft = (iCol < width / 2);
+            const float surfaceAlbedo = isLeft ? 0.2f : 0.9f;
+            const float noise = (float)randomDoubleRange(-0.05, 0.05);
+
+            for (int k = 0; k < 3; ++k)
+            {
+                const int i = (iRow * width + iCol) * 3 + k;
+
+                albedo[i] = surfaceAlbedo;
+                rgb[i] = surfaceAlbedo * (0.5f + noise);
+            }
+
+            normal[(iRow * width + iCol) * 3 + 2] = 1.0f;
+        }
+    }
+
+    const double varianceBefore = Variance(rgb, width / 2, width, width);
+
+    Denoiser().denoise(rgb.data(), albedo.data(), normal.data(), width, height, 3);
+
+    EXPECT_LT(Variance(rgb, width / 2, width, width), 0.1 * varianceBefore);
+
+    // The edge is preserved.
+    for (int iRow = 0; iRow < height; ++iRow)
+    {
+        EXPECT_NEAR(rgb[(iRow * width + width / 2 - 1) * 3], 0.2f * 0.5f, 0.01f);
+        EXPECT_NEAR(rgb[(iRow * width + width / 2) * 3], 0.9f * 0.5f, 0.03f);
+    }
+}
+
+
+/// Returns the variance of the red channel for columns [iStart, iEnd).
+static double Variance(const std::vector<float> &rgb, int iStart, int iEnd, int width)
+{
+    double s1 = 0.0, s2 = 0.0;
+    int n = 0;
+
+    for (size_t iPixel = 0; iPixel < rgb.size() / 3; ++iPixel)
+    {
+        const int iCol = (int)(iPixel % width);
+        if (iCol < iStart || iCol >= iEnd) continue;
+
+        s1 += rgb[iPixel * 3];
+        s2 += rgb[iPixel * 3] * rgb[iPixel * 3];
+        ++n;
+    }
+
+    return (s2 - s1 * s1 / n) / n;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file TestHDRWriter.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "test/TestHelpers.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+
+extern "C"
+{
+#include "utility/HDRWriter.h"
+}
+
+static uint32_t LoadUInt32(const std::string &bytes, size_t offset);
+
+
+TEST(HDRWriter, TestFloatToHalf)
+{
+    EXPECT_EQ(floatToHalf(0.0f), 0x0000);
+    EXPECT_EQ(floatToHalf(-0.0f), 0x8000);
+    EXPECT_EQ(floatToHalf(1.0f), 0x3c00);
+    EXPECT_EQ(floatToHalf(-2.0f), 0xc000);
+    EXPECT_EQ(floatToHalf(0.5f), 0x3800);
+    EXPECT_EQ(floatToHalf(65504.0f), 0x7bff); // Largest half.
+    EXPECT_EQ(floatToHalf(1e6f), 0x7c00);     // Overflows to infinity.
+    EXPECT_EQ(floatToHalf(INFINITY), 0x7c00);
+    EXPECT_EQ(floatToHalf(ldexpf(1.0f, -24)), 0x0001); // Smallest denormal.
+    EXPECT_EQ(floatToHalf(ldexpf(1.0f, -26)), 0x0000);
+    EXPECT_EQ(floatToHalf(1.0f + ldexpf(1.0f, -11)), 0x3c00); // Ties round to even.
+    EXPECT_EQ(floatToHalf(1.0f + 3 * ldexpf(1.0f, -11)), 0x3c02);
+    EXPECT_EQ(floatToHalf(NAN) & 0x7c00, 0x7c00);
+    EXPECT_NE(floatToHalf(NAN) & 0x03ff, 0);
+}
+
+
+TEST(HDRWriter, TestPFM)
+{
+    const std::string path = testing::TempDir() + "stream.pfm";
+    const char *channels[3] = {"R", "G", "B"};
+
+    // Top row then bottom row.
+    const float rows[2][3] = {{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}};
+
+    HDRStream *stream = openHDRStream(path.c_str(), HDRFormatPFM, 1, 2, channels, 3);
+    ASSERT_TRUE(stream != nullptr);
+    EXPECT_TRUE(writeHDRStreamRows(stream, rows[0], 1));
+    EXPECT_TRUE(writeHDRStreamRows(stream, rows[1], 1));
+    EXPECT_TRUE(closeHDRStream(stream));
+
+    const std::string header = "PF\n1 2\n-1.0\n";
+    const std::string contents = ReadFile(path);
+    ASSERT_EQ(contents.size(), header.size() + 6 * sizeof(float));
+    EXPECT_EQ(contents.substr(0, header.size()), header);
+
+    // The bottom row is stored first.
+    float values[6];
+    memcpy(values, contents.data() + header.size(), sizeof(values));
+
+    const float expected[6] = {4.0f, 5.0f, 6.0f, 1.0f, 2.0f, 3.0f};
+
+    for (int i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(values[i], expected[i]);
+    }
+
+    EXPECT_TRUE(openHDRStream(path.c_str(), HDRFormatPFM, 1, 2, channels, 2) == nullptr);
+}
+
+
+TEST(HDRWriter, TestEXR)
+{
+    const std::string path = testing::TempDir() + "stream.exr";
+    const char *channels[4] = {"R", "G", "B", "A"};
+
+    // 2 x 1 image.
+    const float row[8] = {1.0f, 2.0f, 0.5f, 1.0f, -1.0f, 0.0f, 65504.0f, 0.25f};
+
+    HDRStream *stream = openHDRStream(path.c_str(), HDRFormatEXR, 2, 1, channels, 4);
+    ASSERT_TRUE(stream != nullptr);
+    EXPECT_TRUE(writeHDRStreamRows(stream, row, 1));
+    EXPECT_TRUE(closeHDRStream(stream));
+
+    const std::string contents = ReadFile(path);
+    ASSERT_GT(contents.size(), 8u);
+
+    EXPECT_EQ(LoadUInt32(contents, 0), 20000630u); // Magic number.
+    EXPECT_EQ(LoadUInt32(contents, 4), 2u);        // Version.
+
+    // Channels are sorted by name.
+    const size_t chlist = contents.find(std::string("channels\0chlist\0", 16));
+    ASSERT_NE(chlist, std::string::npos);
+    EXPECT_EQ(contents[chlist + 20], 'A');
+    EXPECT_EQ(contents[chlist + 20 + 18], 'B');
+
+    // A single scanline block (y, size, then A, B, G and R for each pixel) ends the file.
+    const size_t blockSize = 8 + 2 * 4 * 2;
+    ASSERT_GT(contents.size(), blockSize + 8);
+
+    const size_t block = contents.size() - blockSize;
+    uint64_t offset;
+    memcpy(&offset, contents.data() + block - 8, sizeof(offset));
+
+    EXPECT_EQ(offset, block);
+    EXPECT_EQ(LoadUInt32(contents, block), 0u);
+    EXPECT_EQ(LoadUInt32(contents, block + 4), blockSize - 8);
+
+    const uint16_t expected[8] = {0x3c00, 0x3400, 0x3800, 0x7bff, 0x4000, 0x0000, 0x3c00, 0xbc00};
+
+    for (int i = 0; i < 8; ++i)
+    {
+        uint16_t half;
+        memcpy(&half, contents.data() + block + 8 + 2 * i, sizeof(half));
+
+        EXPECT_EQ(half, expected[i]);
+    }
+
+    // Channel names must be unique.
+    const char *duplicates[2] = {"R", "R"};
+    EXPECT_TRUE(openHDRStream(path.c_str(), HDRFormatEXR, 2, 1, duplicates, 2) == nullptr);
+}
+
+
+static uint32_t LoadUInt32(const std::string &bytes, size_t offset)
+{
+    uint32_t value;
+    memcpy(&value, bytes.data() + offset, sizeof(value));
+
+    return value;
+}
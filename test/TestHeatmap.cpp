@@ -0,0 +1,115 @@
+/**
+ * @file TestHeatmap.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/Heatmap.hpp"
+#include "engine/PhotonEngine.hpp"
+#include "engine/SceneLoader.hpp"
+#include "test/TestHelpers.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+
+TEST(Heatmap, TestScale)
+{
+    // A single outlier is above the 99th percentile.
+    std::vector<float> values(200);
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = (float)(i % 10);
+    }
+
+    values[17] = 1000.0f;
+    values[18] = INFINITY;
+    values[19] = NAN;
+
+    EXPECT_EQ(Heatmap::scale(values.data(), values.size()), 9.0f);
+
+    // Mostly zero: the maximum is used instead.
+    std::vector<float> sparse(1000, 0.0f);
+    sparse[500] = 3.0f;
+
+    EXPECT_EQ(Heatmap::scale(sparse.data(), sparse.size()), 3.0f);
+    EXPECT_EQ(Heatmap::scale(nullptr, 0), 0.0f);
+}
+
+
+TEST(Heatmap, TestColor)
+{
+    float rgb[3];
+
+    Heatmap::color(0.0f, rgb);
+    EXPECT_EQ(rgb[0] + rgb[1] + rgb[2], 0.0f);
+
+    Heatmap::color(NAN, rgb);
+    EXPECT_EQ(rgb[0] + rgb[1] + rgb[2], 0.0f);
+
+    Heatmap::color(1.0f, rgb);
+    EXPECT_NEAR(rgb[0], 1.0f, 1e-6f);
+    EXPECT_NEAR(rgb[1], 1.0f, 1e-6f);
+    EXPECT_NEAR(rgb[2], 1.0f, 1e-6f);
+
+    // Clamped above the scale.
+    float clamped[3];
+    Heatmap::color(5.0f, clamped);
+    EXPECT_EQ(clamped[0], rgb[0]);
+
+    // Brighter up the scale.
+    float previous = -1.0f;
+
+    for (int i = 0; i <= 20; ++i)
+    {
+        Heatmap::color(0.05f * i, rgb);
+
+        const float luminance = 0.21f * rgb[0] + 0.72f * rgb[1] + 0.07f * rgb[2];
+        EXPECT_GT(luminance, previous);
+        previous = luminance;
+    }
+}
+
+
+/* The heatmaps are written alongside the render */
+TEST(Heatmap, TestRender)
+{
+    Scene scene;
+    SceneLoader loader(scene);
+
+    loader.loadString("camera 40 1 0  0 0 4  0 0 0\n"
+                      "material red matte 1 0 0\n"
+                      "sphere red 0 0 0 1\n");
+
+    Camera camera = loader.camera(1.0);
+
+    PhotonEngine engine(8, 8);
+    engine.setMaxSamples(4);
+
+    EXPECT_FALSE(engine.setHeatmaps(aovBit(AOV::Normal)));
+    ASSERT_TRUE(engine.setHeatmaps(aovBit(AOV::Time) | aovBit(AOV::RayCount)));
+
+    const std::string path = testing::TempDir() + "heatmap.ppm";
+    ASSERT_TRUE(engine.render(scene, camera, path.c_str()));
+
+    const std::string header = "P6\n8 8\n255\n";
+
+    for (const char *name : {"time", "rays"})
+    {
+        const std::string contents = ReadFile(testing::TempDir() + "heatmap." + name + ".heatmap.ppm");
+
+        ASSERT_EQ(contents.size(), header.size() + 8 * 8 * 3) << name;
+        EXPECT_EQ(contents.substr(0, header.size()), header);
+    }
+
+    // The rays which hit the sphere bounce so the center is hotter than the corner.
+    const std::string rays = ReadFile(testing::TempDir() + "heatmap.rays.heatmap.ppm");
+    const size_t iCorner = header.size(), iCenter = header.size() + (4 * 8 + 4) * 3;
+
+    EXPECT_GT((unsigned char)rays[iCenter], (unsigned char)rays[iCorner]);
+}
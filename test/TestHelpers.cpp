@@ -0,0 +1,89 @@
+/**
+ * @file TestHelpers.cpp
+ * @author Edward Palmer
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "test/TestHelpers.hpp"
+#include <cmath>
+
+
+Vector3 RandomUnitVector(std::mt19937 &generator)
+{
+    std::normal_distribution<Real> normal(0.0, 1.0);
+
+    for (;;)
+    {
+        const Real x = normal(generator);
+        const Real y = normal(generator);
+        const Real z = normal(generator);
+
+        const Vector3 v = vector3(x, y, z);
+        if (vectorLength(v) > 1e-6) return unitVector(v);
+    }
+}
+
+
+Point3 RandomPoint(std::mt19937 &generator, Real range)
+{
+    std::uniform_real_distribution<Real> coordinate(-range, range);
+
+    const Real x = coordinate(generator);
+    const Real y = coordinate(generator);
+    const Real z = coordinate(generator);
+
+    return point3(x, y, z);
+}
+
+
+Ray RandomRayTowards(std::mt19937 &generator, Point3 target, Real minDistance, Real maxDistance, Real spread)
+{
+    std::uniform_real_distribution<Real> distance(minDistance, maxDistance), unit(0.0, 1.0);
+
+    const Point3 origin = addVectors(target, scaleVector(RandomUnitVector(generator), distance(generator)));
+
+    // NB: the cube root makes the aim uniform in the ball.
+    const Point3 aim = addVectors(target, scaleVector(RandomUnitVector(generator), spread * cbrt(unit(generator))));
+
+    return Ray(origin, unitVector(subtractVectors(aim, origin)));
+}
+
+
+std::string ReadFile(const std::string &path)
+{
+    std::string contents;
+
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp) return contents;
+
+    char buffer[4096];
+    size_t n;
+
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        contents.append(buffer, n);
+
+    fclose(fp);
+    return contents;
+}
+
+
+std::vector<std::string> ReadLines(FILE *stream)
+{
+    std::vector<std::string> lines;
+    char buffer[4096];
+
+    rewind(stream);
+
+    while (fgets(buffer, sizeof(buffer), stream))
+    {
+        std::string line(buffer);
+        if (!line.empty() && line.back() == '\n') line.pop_back();
+
+        lines.push_back(line);
+    }
+
+    return lines;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file TestHelpers.hpp
+ * @author Edward Palmer
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+#include "engine/Ray.hpp"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+/* Tolerance for hit times and normals which holds in both the double and float (CPHOTON_FLOAT32) builds */
+static constexpr Real kTolerance = (sizeof(Real) == sizeof(double)) ? 1e-9 : 1e-4;
+
+/* Returns a random unit vector */
+Vector3 RandomUnitVector(std::mt19937 &generator);
+
+/* Returns a random point in the cube [-range, range]^3 */
+Point3 RandomPoint(std::mt19937 &generator, Real range);
+
+/**
+ * Returns a ray with a unit direction from a random point between minDistance and maxDistance from target which is
+ * aimed at a random point within spread of the target.
+ */
+Ray RandomRayTowards(std::mt19937 &generator, Point3 target, Real minDistance, Real maxDistance, Real spread);
+
+/* Returns the contents of a file (empty if it cannot be read) */
+std::string ReadFile(const std::string &path);
+
+/* Returns the lines of a stream from its start without their newlines */
+std::vector<std::string> ReadLines(FILE *stream);
@@ -0,0 +1,125 @@
+/**
+ * @file TestLogger.cpp
+ * @author Edward Palmer
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "test/TestHelpers.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+#include "logger/Logger.h"
+}
+
+static void LogErrorsAfterStop(void);
+
+
+/* Each thread's messages are written in order */
+TEST(Logger, TestThreads)
+{
+    FILE *stream = tmpfile();
+    ASSERT_NE(stream, nullptr);
+
+    SetLogOutput(stream);
+
+    // NB: fewer messages than fit in a thread's queue so that none are dropped.
+    const int kNumThreads = 4, kMessagesPerThread = 100;
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < kNumThreads; ++i)
+    {
+        threads.emplace_back([i]() {
+            for (int iMessage = 0; iMessage < kMessagesPerThread; ++iMessage)
+                LogInfo("thread %d message %d", i, iMessage);
+        });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    FlushLogger();
+    SetLogOutput(nullptr);
+
+    const std::vector<std::string> lines = ReadLines(stream);
+    ASSERT_EQ(lines.size(), kNumThreads * kMessagesPerThread);
+
+    int nextMessage[kNumThreads] = {0};
+
+    for (const std::string &line : lines)
+    {
+        int iThread, iMessage;
+        ASSERT_EQ(sscanf(strstr(line.c_str(), "thread"), "thread %d message %d", &iThread, &iMessage), 2) << line;
+        ASSERT_TRUE(iThread >= 0 && iThread < kNumThreads);
+
+        EXPECT_EQ(iMessage, nextMessage[iThread]++);
+    }
+
+    fclose(stream);
+}
+
+
+/* Long messages are truncated and messages below the threshold are skipped */
+TEST(Logger, TestTruncateAndThreshold)
+{
+    FILE *stream = tmpfile();
+    ASSERT_NE(stream, nullptr);
+
+    SetLogOutput(stream);
+
+    const std::string longMessage(4 * LOG_MAX_MESSAGE_SIZE, 'x');
+    LogWarning("%s", longMessage.c_str());
+
+    SetThresholdLogLevel(LogLevelError);
+    LogWarning("skipped");
+    SetThresholdLogLevel(LogLevelInfo);
+
+    LogError("written");
+
+    SetLogOutput(nullptr);
+
+    const std::vector<std::string> lines = ReadLines(stream);
+    ASSERT_EQ(lines.size(), 2);
+
+    const std::string expected = std::string(LOG_MAX_MESSAGE_SIZE - 4, 'x') + "...";
+    EXPECT_EQ(lines[0].substr(lines[0].size() - expected.size()), expected);
+    EXPECT_NE(lines[1].find("written"), std::string::npos);
+
+    fclose(stream);
+}
+
+
+/* Messages logged after the logger stops at exit are written directly (more than fit in a queue) */
+TEST(Logger, TestLogAfterStop)
+{
+    // NB: the test is run in a new process so that the handler is registered before the logger's.
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+
+    EXPECT_EXIT(
+        {
+            SetLogOutput(stderr);
+            atexit(LogErrorsAfterStop);
+
+            LogInfo("before exit");
+            exit(0);
+        },
+        testing::ExitedWithCode(0), "before exit(.|\n)*error 299");
+}
+
+
+static void LogErrorsAfterStop(void)
+{
+    for (int i = 0; i < 300; ++i)
+    {
+        LogError("error %d", i);
+    }
+}
@@ -0,0 +1,154 @@
+/**
+ * @file TestMaterialTable.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/Scene.hpp"
+#include "engine/materials/MaterialTable.hpp"
+#include "engine/primitives/Primitives.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+
+TEST(MaterialTable, TestIdsAndTypes)
+{
+    MaterialTable materials;
+
+    MaterialId matte = materials.addMatte(color3(1, 0, 0));
+    MaterialId metal = materials.addMetal(color3(0, 1, 0), 0.5);
+    MaterialId glass = materials.addDielectric(1.5);
+    MaterialId light = materials.addEmitter(color3(2, 2, 2));
+
+    EXPECT_EQ(matte, 0);
+    EXPECT_EQ(metal, 1);
+    EXPECT_EQ(glass, 2);
+    EXPECT_EQ(light, 3);
+    EXPECT_EQ(materials.size(), 4);
+
+    EXPECT_EQ(materials.type(matte), MaterialType::Matte);
+    EXPECT_EQ(materials.type(metal), MaterialType::Metal);
+    EXPECT_EQ(materials.type(glass), MaterialType::Dielectric);
+    EXPECT_EQ(materials.type(light), MaterialType::Emitter);
+
+    // The color overloads register a solid texture for each material.
+    EXPECT_EQ(materials.textures().size(), 2);
+}
+
+
+TEST(MaterialTable, TestEmitter)
+{
+    MaterialTable materials;
+
+    MaterialId matte = materials.addMatte(color3(1, 0, 0));
+    MaterialId light = materials.addEmitter(color3(2, 3, 4));
+
+    Color3 emitted = materials.emitted(light);
+    EXPECT_DOUBLE_EQ(emitted.x, 2.0);
+    EXPECT_DOUBLE_EQ(emitted.y, 3.0);
+    EXPECT_DOUBLE_EQ(emitted.z, 4.0);
+
+    emitted = materials.emitted(matte);
+    EXPECT_DOUBLE_EQ(emitted.x, 0.0);
+    EXPECT_DOUBLE_EQ(emitted.y, 0.0);
+    EXPECT_DOUBLE_EQ(emitted.z, 0.0);
+
+    // Emitters absorb incident rays.
+    Ray ray(point3(0, 1, 0), vector3(0, -1, 0)), scatteredRay;
+    Hit hit;
+    hit.t = 1.0;
+    hit.hitPt = point3(0, 0, 0);
+    hit.normal = vector3(0, 1, 0);
+    hit.frontFace = true;
+    hit.u = hit.v = 0.0;
+    hit.material = light;
+
+    Color3 attenuation;
+    EXPECT_FALSE(materials.scatter(light, ray, hit, scatteredRay, attenuation));
+}
+
+
+TEST(MaterialTable, TestTextureLookup)
+{
+    MaterialTable materials;
+    TextureTable &textures = materials.textures();
+
+    TextureId odd = textures.addSolid(color3(1, 0, 0));
+    TextureId even = textures.addSolid(color3(0, 0, 1));
+    TextureId checker = textures.addChecker(odd, even);
+
+    EXPECT_EQ(textures.type(checker), TextureType::Checker);
+    EXPECT_THROW(textures.addChecker(checker, checker + 1), std::out_of_range);
+
+    // sin(10x) * sin(10y) * sin(10z) is negative at (-0.1, 0.1, 0.1) and positive at (0.1, 0.1, 0.1).
+    Point3 oddPt = point3(-0.1, 0.1, 0.1), evenPt = point3(0.1, 0.1, 0.1);
+
+    EXPECT_DOUBLE_EQ(textures.value(checker, 0, 0, &oddPt).x, 1.0);
+    EXPECT_DOUBLE_EQ(textures.value(checker, 0, 0, &evenPt).z, 1.0);
+
+    // Matte materials attenuate by their texture.
+    MaterialId matte = materials.addMatte(checker);
+
+    Ray ray(point3(-0.1, 1, 0.1), vector3(0, -1, 0)), scatteredRay;
+    Hit hit;
+    hit.t = 0.9;
+    hit.hitPt = oddPt;
+    hit.normal = vector3(0, 1, 0);
+    hit.frontFace = true;
+    hit.u = hit.v = 0.0;
+    hit.material = matte;
+
+    Color3 attenuation;
+    ASSERT_TRUE(materials.scatter(matte, ray, hit, scatteredRay, attenuation));
+    EXPECT_DOUBLE_EQ(attenuation.x, 1.0);
+    EXPECT_DOUBLE_EQ(attenuation.z, 0.0);
+}
+
+
+TEST(MaterialTable, TestTooManyMaterials)
+{
+    MaterialTable materials;
+
+    for (size_t i = 0; i < kNoMaterial; ++i)
+    {
+        (void)materials.addDielectric(1.5);
+    }
+
+    EXPECT_THROW(materials.addDielectric(1.5), std::length_error);
+}
+
+
+TEST(MaterialTable, TestCompiledSceneMaterials)
+{
+    Scene scene;
+    SceneArena &arena = scene.arena();
+    MaterialTable &materials = scene.materials();
+
+    MaterialId red = materials.addMatte(color3(1, 0, 0));
+    MaterialId blue = materials.addMatte(color3(0, 0, 1));
+
+    // Two spheres share a leaf so the nearer one is found by the packed kernel (if enabled).
+    scene.addObject(arena.make<Sphere>(point3(0, 0, -2), 0.5, red));
+    scene.addObject(arena.make<Sphere>(point3(0, 0, -4), 0.5, blue));
+    scene.addObject(arena.make<Plane>(point3(0, -1, 0), vector3(0, 1, 0), blue));
+
+    CompiledScene *compiled = scene.compiledScene();
+    ASSERT_TRUE(compiled != nullptr);
+    EXPECT_EQ(&compiled->materials(), &materials);
+
+    Ray ray(point3(0, 0, 0), vector3(0, 0, -1));
+    Hit hit;
+
+    ASSERT_TRUE(compiled->hit(ray, 0.0, INFINITY, hit));
+    EXPECT_EQ(hit.material, red);
+
+    ray = Ray(point3(0, 0, 0), vector3(0, -1, 0));
+    ASSERT_TRUE(compiled->hit(ray, 0.0, INFINITY, hit));
+    EXPECT_EQ(hit.material, blue);
+
+    // The material fits in the padding of the primitive reference.
+    static_assert(sizeof(PrimitiveRef) == 8, "unexpected primitive reference size");
+}
@@ -0,0 +1,133 @@
+/**
+ * @file TestMengerSponge.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/primitives/MengerSponge.hpp"
+#include "engine/primitives/PrimitiveArrays.hpp"
+#include "models/MengerCube.hpp"
+#include "test/TestHelpers.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+
+/* The implicit sponge has the same hits as the sponge made from 20^n cubes */
+TEST(MengerSponge, TestMatchesCubes)
+{
+    const Point3 center = point3(0.5, -1, 2);
+    const Real length = 2.0;
+
+    for (int level = 0; level <= 3; ++level)
+    {
+        SceneArena arena;
+        Primitive *cubes = makeMengerSponge(arena, (int8_t)level, center, length, 0);
+        MengerSponge sponge(center, length, level, 0);
+
+        std::mt19937 generator(2026);
+        int numHits = 0;
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            Ray ray = RandomRayTowards(generator, center, 4.0, 6.0, 1.0);
+
+            Hit expected, result;
+            const bool isHit = cubes->hit(ray, 0.0, 100.0, expected);
+
+            ASSERT_EQ(sponge.hit(ray, 0.0, 100.0, result), isHit) << "level " << level;
+            if (!isHit) continue;
+
+            ++numHits;
+            EXPECT_NEAR(result.t, expected.t, kTolerance);
+            EXPECT_TRUE(result.frontFace);
+
+            // NB: the normal is ambiguous where the ray hits an edge (two coordinates on the grid of the cubes).
+            const Vector3 p = addVectors(scaleVector(subtractVectors(result.hitPt, center), 27.0 / length),
+                                         vector3(13.5, 13.5, 13.5));
+            const int numOnGrid = (fabs(p.x - rint(p.x)) < kTolerance) + (fabs(p.y - rint(p.y)) < kTolerance) +
+                                  (fabs(p.z - rint(p.z)) < kTolerance);
+
+            if (numOnGrid < 2)
+            {
+                EXPECT_NEAR(dot(result.normal, expected.normal), 1.0, kTolerance);
+            }
+        }
+
+        EXPECT_GT(numHits, 200);
+    }
+}
+
+
+/* Deep levels are a subset of the shallower levels so they are hit later (or not at all) */
+TEST(MengerSponge, TestDeepLevels)
+{
+    MengerSponge shallow(point3(0, 0, 0), 1.0, 3, 0);
+    MengerSponge deep(point3(0, 0, 0), 1.0, 10, 0);
+
+    std::mt19937 generator(2026);
+    int numHits = 0;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        Ray ray = RandomRayTowards(generator, point3(0, 0, 0), 4.0, 6.0, 1.0);
+
+        Hit deepHit, shallowHit;
+        if (!deep.hit(ray, 0.0, 100.0, deepHit)) continue;
+
+        ++numHits;
+        ASSERT_TRUE(shallow.hit(ray, 0.0, 100.0, shallowHit));
+        EXPECT_GE(deepHit.t, shallowHit.t - kTolerance);
+    }
+
+    EXPECT_GT(numHits, 200);
+
+    // The central tunnels pass through every level.
+    Hit hit;
+    Ray tunnel(point3(0.01, -0.02, 5), vector3(0, 0, -1));
+    EXPECT_FALSE(deep.hit(tunnel, 0.0, 100.0, hit));
+
+    // The corners are solid at every level.
+    Ray corner(point3(0.5 - 1e-9, 0.5 - 1e-9, 5), vector3(0, 0, -1));
+    ASSERT_TRUE(deep.hit(corner, 0.0, 100.0, hit));
+    EXPECT_NEAR(hit.t, 4.5, kTolerance);
+    EXPECT_EQ(hit.normal.z, 1.0);
+}
+
+
+/* The compiled scene's record stores the face so that the hit matches the primitive's */
+TEST(MengerSponge, TestCompiled)
+{
+    MengerSponge sponge(point3(1, 2, 3), 3.0, 4, 7);
+
+    PrimitiveArrays arrays;
+    sponge.compile(arrays);
+
+    ASSERT_EQ(arrays.size(), 1);
+    EXPECT_EQ(arrays.refs[0].type, PrimitiveType::Menger);
+
+    std::mt19937 generator(2026);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        Ray ray = RandomRayTowards(generator, point3(1, 2, 3), 4.0, 6.0, 1.0);
+
+        Hit expected, result;
+        HitRecord record;
+
+        const bool isHit = sponge.hit(ray, 0.0, 100.0, expected);
+        ASSERT_EQ(arrays.intersect(arrays.refs.data(), 1, ray, 0.0, 100.0, record), isHit);
+        if (!isHit) continue;
+
+        arrays.surfaceInteraction(record, ray, 0.0, result);
+
+        EXPECT_EQ(result.t, expected.t);
+        EXPECT_EQ(result.normal.x, expected.normal.x);
+        EXPECT_EQ(result.normal.y, expected.normal.y);
+        EXPECT_EQ(result.normal.z, expected.normal.z);
+        EXPECT_EQ(result.material, 7);
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * @file TestPPMWriter.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "test/TestHelpers.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "utility/PPMWriter.h"
+#include "utility/Randomizer.h"
+}
+
+
+TEST(PPMWriter, TestStream)
+{
+    const std::string path = testing::TempDir() + "stream.ppm";
+    const float rows[2][6] = {{0.0f, 1.0f, 0.5f, 2.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f}};
+
+    PPMStream *stream = openPPMStream(path.c_str(), 2, 2, 8);
+    ASSERT_TRUE(stream != nullptr);
+
+    EXPECT_TRUE(writePPMStreamRows(stream, rows[0], 1));
+    EXPECT_TRUE(writePPMStreamRows(stream, rows[1], 1));
+    EXPECT_FALSE(writePPMStreamRows(stream, rows[1], 1)); // Too many rows.
+    EXPECT_FALSE(closePPMStream(stream));
+
+    stream = openPPMStream(path.c_str(), 2, 2, 8);
+    ASSERT_TRUE(stream != nullptr);
+
+    EXPECT_TRUE(writePPMStreamRows(stream, &rows[0][0], 2));
+    EXPECT_TRUE(closePPMStream(stream));
+
+    const std::string header = "P6\n2 2\n255\n";
+    const std::string contents = ReadFile(path);
+
+    ASSERT_EQ(contents.size(), header.size() + 12);
+    EXPECT_EQ(contents.substr(0, header.size()), header);
+
+    // Gamma corrected: 0.5 -> 186. Values are clamped to [0, 1].
+    const unsigned char expected[12] = {0, 255, 186, 255, 0, 0, 255, 255, 255, 0, 0, 0};
+
+    for (int i = 0; i < 12; ++i)
+    {
+        EXPECT_EQ((unsigned char)contents[header.size() + i], expected[i]);
+    }
+}
+
+
+TEST(PPMWriter, TestStream16Bit)
+{
+    const std::string path = testing::TempDir() + "stream16.ppm";
+    const float row[3] = {1.0f, 0.0f, 0.5f};
+
+    EXPECT_TRUE(openPPMStream(path.c_str(), 1, 1, 12) == nullptr);
+
+    PPMStream *stream = openPPMStream(path.c_str(), 1, 1, 16);
+    ASSERT_TRUE(stream != nullptr);
+
+    EXPECT_TRUE(writePPMStreamRows(stream, row, 1));
+    EXPECT_TRUE(closePPMStream(stream));
+
+    const std::string header = "P6\n1 1\n65535\n";
+    const std::string contents = ReadFile(path);
+
+    ASSERT_EQ(contents.size(), header.size() + 6);
+
+    // Big-endian.
+    EXPECT_EQ((unsigned char)contents[header.size() + 0], 0xff);
+    EXPECT_EQ((unsigned char)contents[header.size() + 1], 0xbe);
+    EXPECT_EQ((unsigned char)contents[header.size() + 2], 0x00);
+    EXPECT_EQ((unsigned char)contents[header.size() + 3], 0x00);
+    EXPECT_EQ((unsigned char)contents[header.size() + 4], 0xba);
+}
+
+
+TEST(PPMWriter, TestQuantization)
+{
+    const std::string path = testing::TempDir() + "quantization.ppm";
+    const int width = 100000;
+
+    // Random values (with some very small values) and values on 16-bit boundaries.
+    std::vector<float> row(width * 3);
+
+    for (size_t i = 0; i < row.size(); ++i)
+    {
+        if (i % 3 == 0)
+            row[i] = (float)randomDouble();
+        else if (i % 3 == 1)
+            row[i] = (float)pow(randomDouble(), 20.0);
+        else
+            row[i] = (float)pow((i % 65536) / 65536.0, 2.2);
+    }
+
+    PPMStream *stream = openPPMStream(path.c_str(), width, 1, 16);
+    ASSERT_TRUE(stream != nullptr);
+    EXPECT_TRUE(writePPMStreamRows(stream, row.data(), 1));
+    EXPECT_TRUE(closePPMStream(stream));
+
+    const std::string contents = ReadFile(path);
+    const size_t headerSize = std::string("P6\n100000 1\n65535\n").size();
+    ASSERT_EQ(contents.size(), headerSize + row.size() * 2);
+
+    // Matches the gamma correction computed with pow().
+    int numMismatches = 0;
+
+    for (size_t i = 0; i < row.size(); ++i)
+    {
+        const double corrected = std::min(std::max(pow((double)row[i], 1.0 / 2.2), 0.0), 0.999);
+        const unsigned int expected = (unsigned int)(65536 * corrected);
+
+        const unsigned char *bytes = (const unsigned char *)contents.data() + headerSize + 2 * i;
+        const unsigned int value = (bytes[0] << 8) | bytes[1];
+
+        if (value != expected) ++numMismatches;
+    }
+
+    EXPECT_EQ(numMismatches, 0);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file TestSceneArena.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/SceneArena.hpp"
+#include "engine/primitives/Primitives.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+
+namespace
+{
+struct Counted
+{
+    explicit Counted(int *counter_) : counter(counter_)
+    {
+    }
+
+    ~Counted()
+    {
+        ++(*counter);
+    }
+
+    int *counter;
+};
+
+struct alignas(64) OverAligned
+{
+    char data[64];
+};
+} // namespace
+
+
+TEST(SceneArena, TestDestructorsRun)
+{
+    int numDestroyed = 0;
+
+    {
+        SceneArena arena;
+
+        for (int i = 0; i < 10; ++i)
+        {
+            (void)arena.make<Counted>(&numDestroyed);
+        }
+
+        EXPECT_EQ(numDestroyed, 0);
+    }
+
+    EXPECT_EQ(numDestroyed, 10);
+}
+
+
+TEST(SceneArena, TestAlignment)
+{
+    SceneArena arena;
+
+    (void)arena.make<char>('a');
+    OverAligned *object = arena.make<OverAligned>();
+
+    EXPECT_EQ((uintptr_t)object % 64, 0);
+}
+
+
+TEST(SceneArena, TestLargeAllocations)
+{
+    SceneArena arena;
+
+    // Larger than a block. Must not overlap the next allocation.
+    const size_t kLargeSize = 1024 * 1024;
+
+    char *large = (char *)arena.allocate(kLargeSize, 1);
+    char *next = (char *)arena.allocate(16, 1);
+
+    EXPECT_TRUE(next >= large + kLargeSize || next + 16 <= large);
+    EXPECT_GE(arena.bytesUsed(), kLargeSize + 16);
+}
+
+
+TEST(SceneArena, TestPrimitivesAreTriviallyDestructible)
+{
+    // Scene teardown only frees the arena's blocks if no primitive destructors need to run.
+    EXPECT_TRUE(std::is_trivially_destructible<Sphere>::value);
+    EXPECT_TRUE(std::is_trivially_destructible<Cube>::value);
+    EXPECT_TRUE(std::is_trivially_destructible<Triangle>::value);
+    EXPECT_TRUE(std::is_trivially_destructible<Plane>::value);
+    EXPECT_TRUE(std::is_trivially_destructible<Disc>::value);
+    EXPECT_TRUE(std::is_trivially_destructible<Cylinder>::value);
+    EXPECT_TRUE(std::is_trivially_destructible<Cone>::value);
+    EXPECT_TRUE(std::is_trivially_destructible<BVHNode>::value);
+    EXPECT_TRUE(std::is_trivially_destructible<CSGNode>::value);
+}
+
+
+TEST(SceneArena, TestRotation)
+{
+    SceneArena arena;
+
+    EXPECT_EQ(arena.makeRotation(vector3(0, 0, 0)), nullptr);
+
+    Rotate3 *matrices = arena.makeRotation(vector3(0, 0, 90));
+    ASSERT_NE(matrices, nullptr);
+
+    Vector3 rotated = rotation(vector3(1, 0, 0), matrices);
+    EXPECT_NEAR(vectorLength(rotated), 1.0, 1e-6);
+    EXPECT_NEAR(rotated.x, 0.0, 1e-6);
+}
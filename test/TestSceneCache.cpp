@@ -0,0 +1,324 @@
+/**
+ * @file TestSceneCache.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/SceneCache.hpp"
+#include "engine/SceneLoader.hpp"
+#include "engine/primitives/Primitives.hpp"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+extern "C"
+{
+#include "utility/Randomizer.h"
+}
+
+static const char *kSceneText = "texture white solid 1 1 1\n"
+                                "texture black solid 0 0 0\n"
+                                "texture board checker black white\n"
+                                "material chess matte board\n"
+                                "material red matte 1 0 0\n"
+                                "material mirror metal 0.8 0.8 0.8 0.1\n"
+                                "material glass dielectric 1.5\n"
+                                "material light emitter 4 4 4\n"
+                                "plane chess 0 0 0  0 1 0\n"
+                                "sphere glass 0 1 0 0.5\n"
+                                "sphere mirror 1.5 1 0 0.5\n"
+                                "cube red 3 0.5 0 1 0 45 0\n"
+                                "cylinder red -2 0 0 0.5 1 90 0 0\n"
+                                "cone red -4 0 0 1\n"
+                                "triangle mirror 0 0 -3  1 0 -3  0 1 -3\n"
+                                "disc light 0 5 0  0 -1 0  1\n"
+                                "menger red 1 0 0 4 1\n"
+                                "sdf mirror mandelbulb -1 2.5 -1 0.75\n";
+
+static std::string CachePath(const char *name)
+{
+    const std::string path = testing::TempDir() + name;
+    remove(path.c_str());
+
+    return path;
+}
+
+
+/* Section indices and header sizes of the cache format (see SceneCache.cpp) */
+enum CacheSection
+{
+    NodesSection = 0,
+    MengersSection = 14,
+    SdfsSection = 15,
+    MaterialEntriesSection = 17,
+    CheckerTexturesSection = 24
+};
+
+static constexpr size_t kFileHeaderSize = 40;
+
+
+struct CacheSectionHeader
+{
+    uint64_t offset;
+    uint64_t count;
+    uint64_t elementSize;
+};
+
+
+static std::vector<uint8_t> ReadCache(const std::string &path)
+{
+    std::vector<uint8_t> bytes;
+
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp) return bytes;
+
+    uint8_t buffer[4096];
+    size_t numRead;
+
+    while ((numRead = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+    {
+        bytes.insert(bytes.end(), buffer, buffer + numRead);
+    }
+
+    fclose(fp);
+    return bytes;
+}
+
+
+static CacheSectionHeader SectionHeader(const std::vector<uint8_t> &bytes, CacheSection section)
+{
+    CacheSectionHeader header = {};
+    const size_t offset = kFileHeaderSize + section * sizeof(CacheSectionHeader);
+
+    if (offset + sizeof(header) <= bytes.size()) memcpy(&header, &bytes[offset], sizeof(header));
+
+    return header;
+}
+
+
+/* Overwrites a value in the i-th element of a section and returns whether the cache still loads */
+template <typename T>
+static bool LoadsWithPatch(const std::vector<uint8_t> &original, CacheSection section, size_t i, size_t offset, T value)
+{
+    std::vector<uint8_t> bytes = original;
+    const CacheSectionHeader header = SectionHeader(bytes, section);
+    if (i >= header.count || offset + sizeof(T) > header.elementSize) return false;
+
+    memcpy(bytes.data() + header.offset + i * header.elementSize + offset, &value, sizeof(T));
+
+    const std::string path = CachePath("patched.cache");
+    FILE *fp = fopen(path.c_str(), "wb");
+    if (!fp) return false;
+    fwrite(bytes.data(), 1, bytes.size(), fp);
+    fclose(fp);
+
+    Scene scene;
+    return SceneCache::load(path.c_str(), 1234, scene);
+}
+
+
+TEST(SceneCache, TestRoundTrip)
+{
+    const std::string path = CachePath("round_trip.cache");
+
+    Scene scene;
+    SceneLoader(scene).loadString(kSceneText);
+
+    ASSERT_TRUE(SceneCache::save(path.c_str(), 1234, scene));
+
+    Scene cachedScene;
+    ASSERT_TRUE(SceneCache::load(path.c_str(), 1234, cachedScene));
+
+    CompiledScene *compiled = scene.compiledScene();
+    CompiledScene *cachedCompiled = cachedScene.compiledScene();
+    ASSERT_TRUE(cachedCompiled != nullptr);
+
+    EXPECT_EQ(cachedCompiled->numPrimitives(), compiled->numPrimitives());
+    EXPECT_EQ(cachedScene.materials().size(), scene.materials().size());
+    EXPECT_EQ(cachedScene.materials().textures().size(), scene.materials().textures().size());
+
+    // The cached scene is complete.
+    EXPECT_FALSE(cachedScene.addObject(scene.arena().make<Sphere>(point3(0, 0, 0), 1, 0)));
+
+    int numHits = 0;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        const Vector3 direction = vector3(randomDoubleRange(-0.5, 0.5), randomDoubleRange(-0.5, 0.2), -1);
+        Ray ray(point3(0, 2, 10), unitVector(direction));
+
+        Hit hit, cachedHit;
+        const bool isHit = compiled->hit(ray, 0.001, INFINITY, hit);
+
+        ASSERT_EQ(cachedCompiled->hit(ray, 0.001, INFINITY, cachedHit), isHit);
+        if (!isHit) continue;
+
+        ++numHits;
+        EXPECT_EQ(cachedHit.t, hit.t);
+        EXPECT_EQ(cachedHit.material, hit.material);
+        EXPECT_EQ(cachedHit.normal.x, hit.normal.x);
+        EXPECT_EQ(cachedHit.normal.y, hit.normal.y);
+        EXPECT_EQ(cachedHit.normal.z, hit.normal.z);
+
+        const MaterialId material = hit.material;
+        EXPECT_EQ(cachedScene.materials().type(material), scene.materials().type(material));
+
+        const Color3 emitted = scene.materials().emitted(material);
+        const Color3 cachedEmitted = cachedScene.materials().emitted(material);
+        EXPECT_EQ(cachedEmitted.x, emitted.x);
+    }
+
+    EXPECT_GT(numHits, 500);
+}
+
+
+TEST(SceneCache, TestStaleOrInvalid)
+{
+    const std::string path = CachePath("stale.cache");
+
+    Scene scene;
+    SceneLoader(scene).loadString(kSceneText);
+
+    Scene emptyScene;
+    EXPECT_FALSE(SceneCache::load(path.c_str(), 1234, emptyScene)); // Missing.
+
+    ASSERT_TRUE(SceneCache::save(path.c_str(), 1234, scene));
+    EXPECT_FALSE(SceneCache::load(path.c_str(), 4321, emptyScene)); // Different hash.
+
+    // Truncated.
+    FILE *fp = fopen(path.c_str(), "r+b");
+    ASSERT_TRUE(fp != nullptr);
+    ASSERT_EQ(fseek(fp, 0, SEEK_END), 0);
+    const long size = ftell(fp);
+    fclose(fp);
+    ASSERT_EQ(truncate(path.c_str(), size / 2), 0);
+
+    EXPECT_FALSE(SceneCache::load(path.c_str(), 1234, emptyScene));
+    EXPECT_TRUE(emptyScene.compiledScene() == nullptr);
+
+    // Scenes with generic primitives (CSG) cannot be cached.
+    Scene csgScene;
+    SceneLoader(csgScene).loadString("material red matte 1 0 0\n"
+                                     "shape a sphere red 0 0 0 1\n"
+                                     "shape b sphere red 0.5 0 0 1\n"
+                                     "csg lens intersection a b\n"
+                                     "add lens\n");
+
+    EXPECT_FALSE(SceneCache::save(path.c_str(), 1234, csgScene));
+}
+
+
+TEST(SceneCache, TestSceneLoader)
+{
+    const std::string scenePath = CachePath("cached.scene");
+    const std::string path = CachePath("cached.scene.cache");
+
+    FILE *fp = fopen(scenePath.c_str(), "wb");
+    ASSERT_TRUE(fp != nullptr);
+    fputs(kSceneText, fp);
+    fputs("camera 45 1 0   -2 3 4   0 1 0\n", fp);
+    fclose(fp);
+
+    {
+        Scene scene;
+        SceneLoader loader(scene);
+        EXPECT_FALSE(loader.loadFile(scenePath.c_str(), path.c_str())); // Creates cache.
+    }
+
+    Scene scene;
+    SceneLoader loader(scene);
+    EXPECT_TRUE(loader.loadFile(scenePath.c_str(), path.c_str()));
+
+    (void)loader.camera(1.0);
+    EXPECT_EQ(scene.materials().size(), 5);
+    ASSERT_TRUE(scene.compiledScene() != nullptr);
+}
+
+
+TEST(SceneCache, TestCorruptIndices)
+{
+    const std::string path = CachePath("corrupt.cache");
+
+    Scene scene;
+    SceneLoader(scene).loadString(kSceneText);
+    ASSERT_TRUE(SceneCache::save(path.c_str(), 1234, scene));
+
+    const std::vector<uint8_t> bytes = ReadCache(path);
+    ASSERT_GT(bytes.size(), kFileHeaderSize);
+
+    // Any level up to kMaxLevel is valid.
+    EXPECT_TRUE(LoadsWithPatch(bytes, MengersSection, 0, offsetof(PrimitiveArrays::MengerRecord, level), (int32_t)0));
+
+    EXPECT_FALSE(LoadsWithPatch(bytes, MengersSection, 0, offsetof(PrimitiveArrays::MengerRecord, level),
+                                (int32_t)(MengerSponge::kMaxLevel + 1)));
+    EXPECT_FALSE(LoadsWithPatch(bytes, MengersSection, 0, offsetof(PrimitiveArrays::MengerRecord, level), (int32_t)-1));
+
+    // The distance estimator must be known.
+    EXPECT_TRUE(LoadsWithPatch(bytes, SdfsSection, 0, offsetof(PrimitiveArrays::SdfRecord, estimator),
+                               (int32_t)SdfPrimitive::QuaternionJulia));
+    EXPECT_FALSE(LoadsWithPatch(bytes, SdfsSection, 0, offsetof(PrimitiveArrays::SdfRecord, estimator), (int32_t)3));
+
+    // Material entries are {type, index}. The first material (chess) is a matte.
+    EXPECT_FALSE(LoadsWithPatch(bytes, MaterialEntriesSection, 0, sizeof(uint16_t), (uint16_t)100));
+    EXPECT_FALSE(LoadsWithPatch(bytes, MaterialEntriesSection, 0, 0, (uint8_t)200));
+
+    // The checker (texture 2) may only reference earlier textures.
+    EXPECT_FALSE(LoadsWithPatch(bytes, CheckerTexturesSection, 0, 0, (TextureId)2));
+    EXPECT_FALSE(LoadsWithPatch(bytes, CheckerTexturesSection, 0, sizeof(TextureId), (TextureId)100));
+}
+
+
+TEST(SceneCache, TestTreeDepth)
+{
+    const std::string path = CachePath("depth.cache");
+
+    std::string text = "material red matte 1 0 0\n";
+    for (int i = 0; i < 400; ++i)
+    {
+        text += "cube red " + std::to_string(3 * i) + " 0 0 1 0 0 0\n";
+    }
+
+    Scene scene;
+    SceneLoader(scene).loadString(text.c_str());
+    ASSERT_TRUE(SceneCache::save(path.c_str(), 1234, scene));
+
+    const std::vector<uint8_t> bytes = ReadCache(path);
+    const CacheSectionHeader nodes = SectionHeader(bytes, NodesSection);
+    ASSERT_GT(nodes.count, (uint64_t)100); // The traversal stack holds 64 nodes.
+
+    // Rewrite the tree as a chain of interior nodes (whose right child is the next node) ending in a leaf.
+    std::vector<uint8_t> chain = bytes;
+    const size_t offsetField = sizeof(AABB);
+    const size_t countField = offsetField + sizeof(uint32_t);
+
+    for (uint64_t i = 0; i < nodes.count; ++i)
+    {
+        uint8_t *node = chain.data() + nodes.offset + i * nodes.elementSize;
+        const uint32_t offset = (i + 1 < nodes.count) ? (uint32_t)(i + 1) : 0;
+        const uint16_t count = (i + 1 < nodes.count) ? 0 : 1;
+
+        memcpy(node + offsetField, &offset, sizeof(offset));
+        memcpy(node + countField, &count, sizeof(count));
+    }
+
+    // The chain is too deep for the traversal stack.
+    EXPECT_FALSE(LoadsWithPatch(chain, NodesSection, 0, countField, (uint16_t)0));
+
+    // Shorter chains (every 50th node a leaf) are accepted.
+    const uint16_t leafCount = 1;
+    const uint32_t leafOffset = 0;
+
+    for (uint64_t i = 49; i < nodes.count; i += 50)
+    {
+        memcpy(chain.data() + nodes.offset + i * nodes.elementSize + offsetField, &leafOffset, sizeof(leafOffset));
+        memcpy(chain.data() + nodes.offset + i * nodes.elementSize + countField, &leafCount, sizeof(leafCount));
+    }
+
+    EXPECT_TRUE(LoadsWithPatch(chain, NodesSection, 0, countField, (uint16_t)0));
+}
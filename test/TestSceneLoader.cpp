@@ -0,0 +1,166 @@
+/**
+ * @file TestSceneLoader.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/SceneLoader.hpp"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+static std::string LoadError(const char *text);
+
+
+TEST(SceneLoader, TestAllStatements)
+{
+    Scene scene;
+    SceneLoader loader(scene);
+
+    loader.loadString("# Comment line\n"
+                      "camera 45 1 0   -2 3 4   0 1 0\n"
+                      "\n"
+                      "texture white solid 1 1 1\n"
+                      "texture black solid 0 0 0\n"
+                      "texture board checker black white   # trailing comment\n"
+                      "texture gold preset gold\n"
+                      "material chess matte board\n"
+                      "material red matte 1 0 0\n"
+                      "material mirror metal gold 0.1\n"
+                      "material glass dielectric 1.5\n"
+                      "material light emitter 4 4 4\n"
+                      "sphere glass 0 1 0 0.5\n"
+                      "cube red 2 0.5 0 1 0 45 0\r\n"
+                      "triangle mirror 0 0 0  1 0 0  0 1 0\n"
+                      "disc light 0 5 0  0 -1 0  1\n"
+                      "plane chess 0 0 0  0 1 0\n"
+                      "cylinder red -2 0 0 0.5 1\n"
+                      "cone red -4 0 0 1 90 0 0\n"
+                      "menger red 1 4 0 0 1\n"
+                      "sdf red mandelbulb 0 2 0 0.5\n");
+
+    EXPECT_EQ(loader.numObjects(), 9);
+    EXPECT_EQ(scene.materials().size(), 5);
+    EXPECT_EQ(scene.materials().type(4), MaterialType::Emitter);
+
+    (void)loader.camera(1.0);
+
+    CompiledScene *compiled = scene.compiledScene();
+    ASSERT_TRUE(compiled != nullptr);
+    EXPECT_EQ(compiled->numPrimitives(), 9); // NB: the Menger sponge is one primitive.
+}
+
+
+TEST(SceneLoader, TestShapesAndInstances)
+{
+    Scene scene;
+    SceneLoader loader(scene);
+
+    loader.loadString("material red matte 1 0 0\n"
+                      "shape a sphere red 0 0 0 1\n"
+                      "shape b sphere red 0.5 0 0 1\n"
+                      "csg lens intersection a b\n"
+                      "add lens\n"
+                      "instance a 10 0 0\n"
+                      "instance lens 0 10 0\n");
+
+    EXPECT_EQ(loader.numObjects(), 3);
+
+    CompiledScene *compiled = scene.compiledScene();
+    ASSERT_TRUE(compiled != nullptr);
+
+    Hit hit;
+
+    // Instance of sphere a (radius 1) at (10, 0, 0).
+    Ray ray(point3(10, 0, 5), vector3(0, 0, -1));
+    ASSERT_TRUE(compiled->hit(ray, 0.0, INFINITY, hit));
+    EXPECT_NEAR(hit.t, 4.0, 1e-4);
+
+    // Lens (intersection of spheres a and b) at the origin and (0, 10, 0). Its surface crosses the x-axis at -0.5.
+    ray = Ray(point3(-5, 10, 0), vector3(1, 0, 0));
+    ASSERT_TRUE(compiled->hit(ray, 0.0, INFINITY, hit));
+    EXPECT_NEAR(hit.t, 4.5, 1e-4);
+
+    EXPECT_THROW(loader.camera(1.0), std::runtime_error);
+}
+
+
+TEST(SceneLoader, TestErrors)
+{
+    EXPECT_EQ(LoadError("sphere red 0 0 0 1\n"), "line 1: unknown material: red");
+    EXPECT_EQ(LoadError("\nmaterial red matte 1 0 0\nsphere red 0 0 0\n"), "line 3: expected radius");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\nsphere red 0 0 0 1 2\n"), "line 2: unexpected token: 2");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\nsphere red 0 0 0 1x\n"), "line 2: invalid number for radius");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\nsphere red 0 0 0 inf\n"), "line 2: non-finite number for radius");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\nsphere red nan 0 0 1\n"), "line 2: non-finite number for center");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\nsphere red 0 1e999 0 1\n"), "line 2: non-finite number for center");
+    EXPECT_EQ(LoadError("teapot\n"), "line 1: unknown statement: teapot");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\nmaterial red matte 1 0 0\n"), "line 2: duplicate material: red");
+    EXPECT_EQ(LoadError("add missing\n"), "line 1: unknown shape: missing");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\nmenger red 13 0 0 0 1\n"),
+              "line 2: invalid Menger sponge iterations: 13");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\nmenger red 2.5 0 0 0 1\n"),
+              "line 2: invalid integer for iterations");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\nmenger red 2 0 0 0 0\n"), "line 2: expected positive side length");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\nsphere red 0 0 0 -1\n"), "line 2: expected positive radius");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\ncube red 0 0 0 -1\n"), "line 2: expected positive length");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\ncylinder red 0 0 0 1 -2\n"), "line 2: expected positive height");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\ncone red 0 0 0 0\n"), "line 2: expected positive height");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\ndisc red 0 0 0 0 1 0 -1\n"), "line 2: expected positive radius");
+    EXPECT_EQ(LoadError("material red matte 1 0 0\nsdf red torus 0 0 0 1\n"),
+              "line 2: unknown distance estimator: torus");
+}
+
+
+/* Files are read to the end (and unreadable files are errors) */
+TEST(SceneLoader, TestLoadFile)
+{
+    const std::string path = testing::TempDir() + "loader.scene";
+
+    std::string text = "camera 40 1 0  0 0 4  0 0 0\nmaterial red matte 1 0 0\n";
+
+    // Longer than the read buffer.
+    for (int i = 0; i < 4000; ++i)
+    {
+        text += "sphere red " + std::to_string(i) + " 0 0 0.5  # padding to make the file longer\n";
+    }
+
+    FILE *fp = fopen(path.c_str(), "wb");
+    ASSERT_NE(fp, nullptr);
+    ASSERT_EQ(fwrite(text.data(), 1, text.size(), fp), text.size());
+    fclose(fp);
+
+    Scene scene;
+    SceneLoader loader(scene);
+    loader.loadFile(path.c_str());
+
+    ASSERT_NE(scene.compiledScene(), nullptr);
+    EXPECT_EQ(scene.compiledScene()->numPrimitives(), 4000);
+
+    // A directory can be opened but not read.
+    Scene other;
+    SceneLoader otherLoader(other);
+    EXPECT_THROW(otherLoader.loadFile(testing::TempDir().c_str()), std::runtime_error);
+}
+
+
+static std::string LoadError(const char *text)
+{
+    Scene scene;
+    SceneLoader loader(scene);
+
+    try
+    {
+        loader.loadString(text);
+    }
+    catch (const std::runtime_error &e)
+    {
+        return e.what();
+    }
+
+    return "";
+}
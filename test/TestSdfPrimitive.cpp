@@ -0,0 +1,273 @@
+/**
+ * @file TestSdfPrimitive.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/primitives/PrimitiveArrays.hpp"
+#include "engine/primitives/SdfPrimitive.hpp"
+#include "engine/primitives/Sphere.hpp"
+#include "test/TestHelpers.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+static Ray RandomRayTowards(std::mt19937 &generator, Point3 target, Real spread);
+static Real MandelbulbReference(Point3 c);
+
+
+/* Sphere tracing a sphere estimator finds the same hits as the analytic sphere */
+TEST(SdfPrimitive, TestMatchesSphere)
+{
+    const Point3 center = point3(1, 2, -3);
+    const Real radius = 0.5;
+
+    Sphere sphere(center, radius, 0);
+    SdfPrimitive sdf(SdfPrimitive::Sphere, center, radius, 0);
+
+    std::mt19937 generator(2026);
+    int numHits = 0;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        Ray ray = RandomRayTowards(generator, center, 0.6);
+
+        // Rays which graze the sphere stop further from the hit (epsilon / cos) and may take more steps than the cap.
+        // Rays which only just miss may come within epsilon of the surface. NB: cos < 0.2 for a distance > 0.98 r.
+        const Vector3 toCenter = subtractVectors(center, ray.origin);
+        const Vector3 direction = unitVector(ray.direction);
+        const Real closestDistance =
+            vectorLength(subtractVectors(toCenter, scaleVector(direction, dot(toCenter, direction))));
+
+        if (fabs(closestDistance - radius) < 0.02 * radius) continue;
+
+        Hit expected, result;
+        const bool isExpectedHit = sphere.hit(ray, 0.0, 1000.0, expected);
+
+        ASSERT_EQ(sdf.hit(ray, 0.0, 1000.0, result), isExpectedHit);
+        if (!isExpectedHit) continue;
+
+        ++numHits;
+
+        EXPECT_NEAR(result.t, expected.t, 1e-3);
+        EXPECT_NEAR(result.normal.x, expected.normal.x, 1e-3);
+        EXPECT_NEAR(result.normal.y, expected.normal.y, 1e-3);
+        EXPECT_NEAR(result.normal.z, expected.normal.z, 1e-3);
+        EXPECT_EQ(result.frontFace, expected.frontFace);
+    }
+
+    EXPECT_GT(numHits, 100);
+}
+
+
+/* A packet of rays finds the same hits as the rays marched one at a time */
+TEST(SdfPrimitive, TestPacketMatchesSingleRays)
+{
+    SdfPrimitive sdf(SdfPrimitive::Mandelbulb, point3(0, 0, 0), 1.0, 0);
+
+    std::mt19937 generator(2026);
+
+    for (int iPacket = 0; iPacket < 50; ++iPacket)
+    {
+        Ray rays[SdfPrimitive::kPacketSize];
+        Hit hits[SdfPrimitive::kPacketSize];
+
+        for (int i = 0; i < SdfPrimitive::kPacketSize; ++i)
+        {
+            rays[i] = RandomRayTowards(generator, point3(0, 0, 0), 1.0);
+        }
+
+        const uint32_t mask = sdf.hitPacket(rays, SdfPrimitive::kPacketSize, 0.0, 1000.0, hits);
+
+        for (int i = 0; i < SdfPrimitive::kPacketSize; ++i)
+        {
+            Hit hit;
+            const bool isHit = sdf.hit(rays[i], 0.0, 1000.0, hit);
+
+            ASSERT_EQ((mask >> i) & 1u, isHit ? 1u : 0u);
+            if (isHit)
+            {
+                EXPECT_NEAR(hits[i].t, hit.t, 1e-9);
+            }
+        }
+    }
+}
+
+
+/* The polynomial Mandelbulb iteration matches the trigonometric form */
+TEST(SdfPrimitive, TestMandelbulbEstimator)
+{
+    Real x[SdfPrimitive::kPacketSize], y[SdfPrimitive::kPacketSize], z[SdfPrimitive::kPacketSize];
+    Real distance[SdfPrimitive::kPacketSize];
+
+    std::mt19937 generator(2026);
+    std::uniform_real_distribution<Real> coordinate(-1.5, 1.5);
+
+    for (int iTrial = 0; iTrial < 100; ++iTrial)
+    {
+        for (int i = 0; i < SdfPrimitive::kPacketSize; ++i)
+        {
+            x[i] = coordinate(generator);
+            y[i] = coordinate(generator);
+            z[i] = coordinate(generator);
+        }
+
+        SdfPrimitive::distance(SdfPrimitive::Mandelbulb, x, y, z, distance, SdfPrimitive::kPacketSize);
+
+        for (int i = 0; i < SdfPrimitive::kPacketSize; ++i)
+        {
+            const Real expected = MandelbulbReference(point3(x[i], y[i], z[i]));
+            EXPECT_NEAR(distance[i], expected, 1e-6 * (1.0 + fabs(expected)));
+        }
+    }
+
+    // Points outside the bounding sphere are outside the shape.
+    x[0] = 1.3, y[0] = 0.0, z[0] = 0.0;
+    SdfPrimitive::distance(SdfPrimitive::Mandelbulb, x, y, z, distance, 1);
+    EXPECT_GT(distance[0], 0.0);
+}
+
+
+/* Over-relaxation (falling back when a step is unsafe) converges to the same hits */
+TEST(SdfPrimitive, TestRelaxation)
+{
+    SdfPrimitive::Settings relaxed;
+    relaxed.relaxation = 1.9;
+
+    SdfPrimitive::Settings unrelaxed;
+    unrelaxed.relaxation = 1.0;
+
+    SdfPrimitive::Settings underRelaxed;
+    underRelaxed.relaxation = 0.8;
+
+    SdfPrimitive sdf(SdfPrimitive::Sphere, point3(0, 0, 0), 1.0, 0, relaxed);
+    SdfPrimitive sdf1(SdfPrimitive::Sphere, point3(0, 0, 0), 1.0, 0, unrelaxed);
+    SdfPrimitive sdf2(SdfPrimitive::Sphere, point3(0, 0, 0), 1.0, 0, underRelaxed);
+
+    Ray ray(point3(0.3, 0.2, 5), vector3(0, 0, -2));
+
+    Hit hit, hit1, hit2;
+    ASSERT_TRUE(sdf.hit(ray, 0.0, 100.0, hit));
+    ASSERT_TRUE(sdf1.hit(ray, 0.0, 100.0, hit1));
+    ASSERT_TRUE(sdf2.hit(ray, 0.0, 100.0, hit2));
+
+    const Real expected = 0.5 * (5.0 - sqrt(1.0 - 0.3 * 0.3 - 0.2 * 0.2));
+
+    EXPECT_NEAR(hit.t, expected, 1e-4);
+    EXPECT_NEAR(hit1.t, expected, 1e-4);
+    EXPECT_NEAR(hit2.t, expected, 1e-4);
+}
+
+
+/* Rays which leave the surface do not hit it again. The iteration cap and range are respected */
+TEST(SdfPrimitive, TestLimits)
+{
+    SdfPrimitive sdf(SdfPrimitive::Sphere, point3(0, 0, 0), 1.0, 0);
+
+    Ray ray(point3(0, 0, 5), vector3(0, 0, -1));
+
+    Hit hit;
+    ASSERT_TRUE(sdf.hit(ray, 0.0, 100.0, hit));
+    EXPECT_NEAR(hit.t, 4.0, 1e-4);
+    EXPECT_TRUE(hit.frontFace);
+
+    Ray reflected = hit.spawnRay(vector3(0, 0, 1));
+    EXPECT_FALSE(sdf.hit(reflected, 0.0, 100.0, hit));
+
+    // Out of range.
+    EXPECT_FALSE(sdf.hit(ray, 0.0, 3.9, hit));
+
+    // Inside.
+    Ray inside(point3(0, 0, 0), vector3(1, 0, 0));
+    ASSERT_TRUE(sdf.hit(inside, 0.0, 100.0, hit));
+    EXPECT_NEAR(hit.t, 1.0, 1e-4);
+    EXPECT_FALSE(hit.frontFace);
+
+    // Too few iterations to reach the surface.
+    SdfPrimitive::Settings settings;
+    settings.maxIterations = 2;
+    settings.relaxation = 1.0;
+
+    SdfPrimitive capped(SdfPrimitive::Mandelbulb, point3(0, 0, 0), 1.0, 0, settings);
+    Ray grazing(point3(-5, 0.9, 0), vector3(1, 0, 0));
+    EXPECT_FALSE(capped.hit(grazing, 0.0, 100.0, hit));
+}
+
+
+
+/* The compiled scene's record keeps the estimator and settings so that the hit matches the primitive's */
+TEST(SdfPrimitive, TestCompiled)
+{
+    SdfPrimitive::Settings settings;
+    settings.maxIterations = 100;
+    settings.relaxation = 1.2;
+
+    SdfPrimitive sdf(SdfPrimitive::Mandelbulb, point3(1, 2, 3), 0.5, 7, settings);
+
+    PrimitiveArrays arrays;
+    sdf.compile(arrays);
+
+    ASSERT_EQ(arrays.size(), 1);
+    EXPECT_EQ(arrays.refs[0].type, PrimitiveType::Sdf);
+
+    std::mt19937 generator(2026);
+    int numHits = 0;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        Ray ray = RandomRayTowards(generator, point3(1, 2, 3), 0.5);
+
+        Hit expected, result;
+        HitRecord record;
+
+        const bool isHit = sdf.hit(ray, 0.0, 100.0, expected);
+        ASSERT_EQ(arrays.intersect(arrays.refs.data(), 1, ray, 0.0, 100.0, record), isHit);
+        if (!isHit) continue;
+
+        ++numHits;
+        arrays.surfaceInteraction(record, ray, 0.0, result);
+
+        EXPECT_EQ(result.t, expected.t);
+        EXPECT_EQ(result.normal.x, expected.normal.x);
+        EXPECT_EQ(result.normal.y, expected.normal.y);
+        EXPECT_EQ(result.normal.z, expected.normal.z);
+        EXPECT_EQ(result.material, 7);
+    }
+
+    EXPECT_GT(numHits, 50);
+}
+
+static Ray RandomRayTowards(std::mt19937 &generator, Point3 target, Real spread)
+{
+    std::uniform_real_distribution<Real> scale(0.5, 2.0);
+
+    Ray ray = RandomRayTowards(generator, target, 2.0, 5.0, spread);
+
+    // NB: the direction is not normalised.
+    ray.direction = scaleVector(ray.direction, scale(generator));
+    return ray;
+}
+
+
+static Real MandelbulbReference(Point3 c)
+{
+    Vector3 w = c;
+    Real m = dot(w, w), dr = 1.0;
+
+    for (int iter = 0; iter < 12 && m <= 256.0; ++iter)
+    {
+        const Real r = sqrt(m);
+        dr = 8.0 * pow(r, 7.0) * dr + 1.0;
+
+        const Real theta = 8.0 * acos(w.y / r);
+        const Real phi = 8.0 * atan2(w.x, w.z);
+
+        w = addVectors(c, scaleVector(vector3(sin(theta) * sin(phi), cos(theta), sin(theta) * cos(phi)), pow(r, 8.0)));
+        m = dot(w, w);
+    }
+
+    return 0.25 * log(m) * sqrt(m) / dr;
+}
@@ -86,8 +86,8 @@ TEST(Span, TestSubtractIntervals)
     subtract = Span(1.2, 1.8);
     EXPECT_TRUE(original.subtractIntervals(subtract, results) == 2);
     EXPECT_DOUBLE_EQ(results[0].entry.t, 1.0);
-    EXPECT_DOUBLE_EQ(results[0].exit.t, 1.2);
+    EXPECT_DOUBLE_EQ(results[0].exit.t, Real(1.2));
 
-    EXPECT_DOUBLE_EQ(results[1].entry.t, 1.8);
+    EXPECT_DOUBLE_EQ(results[1].entry.t, Real(1.8));
     EXPECT_DOUBLE_EQ(results[1].exit.t, 2.0);
 }
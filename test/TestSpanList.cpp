@@ -8,11 +8,21 @@
  */
 
 #include "engine/Span.hpp"
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <list>
+#include <random>
 
 using SpanList = Span::SpanList;
 
+static SpanList RandomSpanList(std::mt19937 &generator);
+static bool IsInside(const SpanList &spans, Real t);
+static void ExpectEqualSpanLists(const SpanList &expected, const SpanList &result);
+static SpanList ReferenceUnion(const SpanList &origList, const SpanList &otherList);
+static SpanList ReferenceIntersection(const SpanList &origList, const SpanList &otherList);
+static SpanList ReferenceDifference(const SpanList &origList, const SpanList &otherList);
+
 /* Result: two intervals */
 TEST(SpanList, TestSimpleSubsetSubtraction)
 {
@@ -172,4 +182,212 @@ TEST(SpanList, TestIntersectionMultiOverlap)
 
     EXPECT_DOUBLE_EQ(result[2].entry.t, 7);
     EXPECT_DOUBLE_EQ(result[2].exit.t, 8);
-}
\ No newline at end of file
+}
+
+
+/* Subtracting several spans from one span removes all of them. */
+TEST(SpanList, TestMultipleSubtraction)
+{
+    SpanList original = {Span(0, 10)};
+    SpanList subtracted = {Span(1, 2), Span(4, 5), Span(9, 11)};
+
+    SpanList result;
+    ASSERT_EQ(Span::differenceSpanLists(original, subtracted, result), 3);
+
+    EXPECT_DOUBLE_EQ(result[0].entry.t, 0);
+    EXPECT_DOUBLE_EQ(result[0].exit.t, 1);
+    EXPECT_DOUBLE_EQ(result[1].entry.t, 2);
+    EXPECT_DOUBLE_EQ(result[1].exit.t, 4);
+    EXPECT_DOUBLE_EQ(result[2].entry.t, 5);
+    EXPECT_DOUBLE_EQ(result[2].exit.t, 9);
+}
+
+
+/**
+ * Property tests on random sorted span lists. The results must match the previous (quadratic) implementations and
+ * contain exactly the points given by the set operation.
+ */
+TEST(SpanList, TestRandomSetOperations)
+{
+    std::mt19937 generator(2026);
+
+    for (int iTrial = 0; iTrial < 2000; ++iTrial)
+    {
+        SpanList first = RandomSpanList(generator);
+        SpanList second = RandomSpanList(generator);
+
+        SpanList unionResult, intersectionResult, differenceResult;
+        Span::unionSpanLists(first, second, unionResult);
+        Span::intersectionSpanLists(first, second, intersectionResult);
+        Span::differenceSpanLists(first, second, differenceResult);
+
+        ExpectEqualSpanLists(ReferenceUnion(first, second), unionResult);
+        ExpectEqualSpanLists(ReferenceIntersection(first, second), intersectionResult);
+        ExpectEqualSpanLists(ReferenceDifference(first, second), differenceResult);
+
+        // Test the midpoints between the endpoints (a quarter apart) which are not near any boundary.
+        for (Real t = -4.875; t < 20.0; t += 0.25)
+        {
+            const bool inFirst = IsInside(first, t), inSecond = IsInside(second, t);
+
+            EXPECT_EQ(IsInside(unionResult, t), inFirst || inSecond);
+            EXPECT_EQ(IsInside(differenceResult, t), inFirst && !inSecond);
+
+            if (t > 0.0)
+            {
+                EXPECT_EQ(IsInside(intersectionResult, t), inFirst && inSecond);
+            }
+        }
+
+        // Results are sorted and do not overlap.
+        for (const SpanList *result : {&unionResult, &intersectionResult, &differenceResult})
+        {
+            for (size_t i = 1; i < result->size(); ++i)
+            {
+                EXPECT_LE((*result)[i - 1].exit.t, (*result)[i].entry.t);
+            }
+        }
+
+        if (HasFailure()) break;
+    }
+}
+
+
+/// Returns up to 8 sorted spans in [-5, 20) which do not overlap. Endpoints are multiples of 0.25.
+static SpanList RandomSpanList(std::mt19937 &generator)
+{
+    std::uniform_int_distribution<int> countDistribution(0, 8);
+    std::uniform_int_distribution<int> stepDistribution(0, 99);
+
+    std::vector<int> steps;
+
+    for (int i = 2 * countDistribution(generator); i > 0; --i)
+    {
+        steps.push_back(stepDistribution(generator));
+    }
+
+    std::sort(steps.begin(), steps.end());
+    steps.erase(std::unique(steps.begin(), steps.end()), steps.end());
+
+    SpanList spans;
+
+    for (size_t i = 0; i + 1 < steps.size(); i += 2)
+    {
+        spans.push_back(Span(-5.0 + 0.25 * steps[i], -5.0 + 0.25 * steps[i + 1]));
+    }
+
+    return spans;
+}
+
+
+static bool IsInside(const SpanList &spans, Real t)
+{
+    return std::any_of(spans.begin(), spans.end(),
+                       [t](const Span &span) { return (span.entry.t < t && t < span.exit.t); });
+}
+
+
+static void ExpectEqualSpanLists(const SpanList &expected, const SpanList &result)
+{
+    ASSERT_EQ(expected.size(), result.size());
+
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_DOUBLE_EQ(expected[i].entry.t, result[i].entry.t);
+        EXPECT_DOUBLE_EQ(expected[i].exit.t, result[i].exit.t);
+    }
+}
+
+
+static void SortSpanList(SpanList &spans)
+{
+    std::sort(spans.begin(), spans.end(),
+              [](const Span &left, const Span &right) { return left.entry.t < right.entry.t; });
+}
+
+
+/// Previous implementation: merges overlapping pairs until none overlap.
+static SpanList ReferenceUnion(const SpanList &origList, const SpanList &otherList)
+{
+    std::list<Span> spans(origList.begin(), origList.end());
+    spans.insert(spans.end(), otherList.begin(), otherList.end());
+
+    for (auto iter = spans.begin(); iter != spans.end();)
+    {
+        bool eraseIter = false;
+
+        for (auto iter2 = spans.begin(); iter2 != spans.end(); ++iter2)
+        {
+            if (iter2 != iter && iter->intervalsOverlap(*iter2))
+            {
+                const Hit &minEntry = iter->entry.t < iter2->entry.t ? iter->entry : iter2->entry;
+                const Hit &maxExit = iter->exit.t > iter2->exit.t ? iter->exit : iter2->exit;
+
+                spans.push_back(Span(minEntry, maxExit));
+                spans.erase(iter2);
+                eraseIter = true;
+                break;
+            }
+        }
+
+        if (eraseIter)
+            spans.erase(iter++);
+        else
+            ++iter;
+    }
+
+    SpanList result(spans.begin(), spans.end());
+    SortSpanList(result);
+    return result;
+}
+
+
+/// Previous implementation: tests every pair of spans.
+static SpanList ReferenceIntersection(const SpanList &origList, const SpanList &otherList)
+{
+    SpanList result;
+
+    for (auto &otherSpan : otherList)
+    {
+        for (auto &origSpan : origList)
+        {
+            if (!otherSpan.intervalsOverlap(origSpan)) continue;
+
+            const Hit &entry = otherSpan.entry.t > origSpan.entry.t ? otherSpan.entry : origSpan.entry;
+            const Hit &exit = otherSpan.exit.t < origSpan.exit.t ? otherSpan.exit : origSpan.exit;
+
+            if (exit.t > 0.0) result.push_back(Span(entry, exit));
+        }
+    }
+
+    SortSpanList(result);
+    return result;
+}
+
+
+/// Brute force: joins the cells between the endpoints of RandomSpanList (a quarter apart) in the first list only.
+static SpanList ReferenceDifference(const SpanList &origList, const SpanList &otherList)
+{
+    SpanList result;
+    bool isInside = false;
+
+    for (int step = 0; step <= 100; ++step)
+    {
+        const Real t = -5.0 + 0.25 * step;
+        const Real midpoint = t + 0.125;
+        const bool isInsideCell = (step < 100) && IsInside(origList, midpoint) && !IsInside(otherList, midpoint);
+
+        if (isInsideCell && !isInside)
+        {
+            result.push_back(Span(t, t));
+        }
+        else if (!isInsideCell && isInside)
+        {
+            result.back().exit.t = t;
+        }
+
+        isInside = isInsideCell;
+    }
+
+    return result;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file TestTelemetry.cpp
+ * @author Edward Palmer
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/PhotonEngine.hpp"
+#include "engine/SceneLoader.hpp"
+#include "engine/Telemetry.hpp"
+#include "test/TestHelpers.hpp"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+#include "threadpool/ThreadPool.h"
+}
+
+static double Field(const std::string &line, const char *name);
+static void AddPixelsTask(void *args);
+
+
+/* Each thread's pixels are counted and the final line has the totals */
+TEST(Telemetry, TestThreads)
+{
+    FILE *stream = tmpfile();
+    ASSERT_NE(stream, nullptr);
+
+    const int kNumThreads = 4, kPixelsPerThread = 5000;
+
+    Telemetry telemetry(stream, kNumThreads * kPixelsPerThread, 0.001);
+    telemetry.start();
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < kNumThreads; ++i)
+    {
+        threads.emplace_back([&telemetry]() {
+            for (int iPixel = 0; iPixel < kPixelsPerThread; ++iPixel)
+                telemetry.addPixel(2, 3);
+        });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    telemetry.stop();
+
+    const Telemetry::Totals totals = telemetry.totals();
+    EXPECT_EQ(totals.numPixels, kNumThreads * kPixelsPerThread);
+    EXPECT_EQ(totals.numSamples, 2 * kNumThreads * kPixelsPerThread);
+    EXPECT_EQ(totals.numRays, 3 * kNumThreads * kPixelsPerThread);
+
+    const std::vector<std::string> lines = ReadLines(stream);
+    ASSERT_GE(lines.size(), 1);
+
+    double previousPercent = 0.0;
+
+    for (const std::string &line : lines)
+    {
+        EXPECT_EQ(line.front(), '{');
+        EXPECT_EQ(line.back(), '}');
+
+        const double percent = Field(line, "percent");
+        EXPECT_GE(percent, previousPercent);
+        previousPercent = percent;
+    }
+
+    const std::string &last = lines.back();
+    EXPECT_NE(last.find("\"done\":true"), std::string::npos);
+    EXPECT_EQ(Field(last, "percent"), 100.0);
+    EXPECT_EQ(Field(last, "pixels"), kNumThreads * kPixelsPerThread);
+    EXPECT_EQ(Field(last, "rays"), 3 * kNumThreads * kPixelsPerThread);
+    EXPECT_EQ(Field(last, "eta_s"), 0.0);
+    EXPECT_GT(Field(last, "rss_mb"), 0.0);
+
+    fclose(stream);
+}
+
+
+/* Each pass starts new workers but their counters are reused so more than kMaxThreads threads are counted */
+TEST(Telemetry, TestWorkerPasses)
+{
+    const int kNumWorkers = 8, kNumPasses = 2 * Telemetry::kMaxThreads / kNumWorkers, kNumTasks = 32;
+
+    Telemetry telemetry(nullptr, 0);
+    Telemetry *telemetryPtr = &telemetry;
+
+    ThreadPool *threadPool = allocThreadPool(kNumWorkers);
+
+    for (int iPass = 0; iPass < kNumPasses; ++iPass)
+    {
+        for (int iTask = 0; iTask < kNumTasks; ++iTask)
+        {
+            addTask(threadPool, AddPixelsTask, &telemetryPtr, sizeof(telemetryPtr));
+        }
+
+        executeTasks(threadPool);
+    }
+
+    deallocThreadPool(threadPool);
+
+    // The pool's workers are not the calling thread.
+    EXPECT_EQ(currentWorkerID(), 0);
+
+    const Telemetry::Totals totals = telemetry.totals();
+    EXPECT_EQ(totals.numPixels, (uint64_t)kNumPasses * kNumTasks * 100);
+    EXPECT_EQ(totals.numSamples, (uint64_t)kNumPasses * kNumTasks * 200);
+    EXPECT_EQ(totals.numRays, (uint64_t)kNumPasses * kNumTasks * 300);
+}
+
+
+/* The render's pixels, samples and rays are streamed */
+TEST(Telemetry, TestRender)
+{
+    Scene scene;
+    SceneLoader loader(scene);
+
+    loader.loadString("camera 40 1 0  0 0 4  0 0 0\n"
+                      "material red matte 1 0 0\n"
+                      "sphere red 0 0 0 1\n");
+
+    Camera camera = loader.camera(1.0);
+
+    FILE *stream = tmpfile();
+    ASSERT_NE(stream, nullptr);
+
+    PhotonEngine engine(16, 8);
+    engine.setMaxSamples(4);
+    engine.setTelemetry(stream);
+
+    const std::string path = testing::TempDir() + "telemetry.ppm";
+    ASSERT_TRUE(engine.render(scene, camera, path.c_str()));
+
+    const std::vector<std::string> lines = ReadLines(stream);
+    ASSERT_GE(lines.size(), 1);
+
+    const std::string &last = lines.back();
+    EXPECT_EQ(Field(last, "pixels"), 16 * 8);
+    EXPECT_EQ(Field(last, "samples"), (double)engine.stats().numSamples);
+    EXPECT_EQ(Field(last, "rays"), (double)engine.stats().numRays);
+
+    fclose(stream);
+}
+
+
+static double Field(const std::string &line, const char *name)
+{
+    const std::string key = std::string("\"") + name + "\":";
+    const size_t position = line.find(key);
+
+    if (position == std::string::npos) return NAN;
+
+    return strtod(line.c_str() + position + key.size(), nullptr);
+}
+
+
+static void AddPixelsTask(void *args)
+{
+    Telemetry *telemetry = *(Telemetry **)args;
+
+    EXPECT_GE(currentWorkerID(), 1);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        telemetry->addPixel(2, 3);
+    }
+}
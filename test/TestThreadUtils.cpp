@@ -0,0 +1,124 @@
+/**
+ * @file TestThreadUtils.cpp
+ * @author Edward Palmer
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+extern "C"
+{
+#include "threadpool/ThreadPool.h"
+#include "threadpool/ThreadUtils.h"
+}
+
+static void CountTask(void *args);
+
+
+/* The worker count is set, then taken from the environment, then the cores */
+TEST(ThreadUtils, TestNumWorkers)
+{
+    const unsigned int numCores = numAvailableCores();
+    EXPECT_GE(numCores, 1u);
+    EXPECT_LE(numCores, std::max(1u, std::thread::hardware_concurrency()));
+
+    unsetenv("CPHOTON_THREADS");
+    EXPECT_EQ(computeNumWorkers(), numCores);
+
+    setenv("CPHOTON_THREADS", "5", 1);
+    EXPECT_EQ(computeNumWorkers(), 5u);
+
+    setNumWorkers(3);
+    EXPECT_EQ(computeNumWorkers(), 3u);
+
+    // Invalid values are ignored.
+    setNumWorkers(0);
+
+    for (const char *value : {"0", "-2", "abc", "4x", ""})
+    {
+        setenv("CPHOTON_THREADS", value, 1);
+        EXPECT_EQ(computeNumWorkers(), numCores) << value;
+    }
+
+    unsetenv("CPHOTON_THREADS");
+}
+
+
+/* Pinned workers run on a single core and still complete every task */
+TEST(ThreadUtils, TestPinWorkers)
+{
+#ifdef __linux__
+    std::thread pinned([]() {
+        ASSERT_TRUE(pinThreadToCore(0));
+
+        cpu_set_t cpuSet;
+        ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &cpuSet), 0);
+        EXPECT_EQ(CPU_COUNT(&cpuSet), 1);
+    });
+
+    pinned.join();
+#endif
+
+    setPinWorkers(true);
+    EXPECT_TRUE(shouldPinWorkers());
+
+    std::atomic<int> count{0};
+    std::atomic<int> *pCount = &count;
+
+    ThreadPool *threadPool = allocThreadPool(4);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        addTask(threadPool, CountTask, &pCount, sizeof(pCount));
+    }
+
+    executeTasks(threadPool);
+    deallocThreadPool(threadPool);
+
+    setPinWorkers(false);
+
+    EXPECT_EQ(count.load(), 100);
+}
+
+
+/* Each core which the process may run on is used by one worker before any are reused */
+TEST(ThreadUtils, TestCoreForWorker)
+{
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &cpuSet), 0);
+
+    const unsigned int numCores = numAvailableCores();
+    std::set<int> cores;
+
+    for (unsigned int i = 0; i < numCores; ++i)
+    {
+        const int core = coreForWorker(i);
+
+        ASSERT_GE(core, 0);
+        EXPECT_TRUE(CPU_ISSET(core, &cpuSet));
+        cores.insert(core);
+    }
+
+    EXPECT_EQ(cores.size(), numCores);
+    EXPECT_EQ(coreForWorker(numCores), coreForWorker(0));
+#endif
+}
+
+
+static void CountTask(void *args)
+{
+    std::atomic<int> *count = *(std::atomic<int> **)args;
+    ++(*count);
+}
@@ -30,7 +30,7 @@ TEST(Vector3, TestVectorLength)
 {
     Vector3 v = vector3(1.0, 2.0, 3.0);
 
-    EXPECT_DOUBLE_EQ(vectorLength(v), sqrt(14.0));
+    EXPECT_DOUBLE_EQ(vectorLength(v), Real(sqrt(14.0)));
 }
 
 
@@ -72,7 +72,8 @@ TEST(Vector3, TestUnitVector)
     Vector3 a = vector3(1.0, 2.0, 3.0); // length is 1 + 4 + 9 = 14.
     Vector3 unit = unitVector(a);
 
-    const double invRoot14 = 1.0 / sqrt(14.0);
+    // NB: computed in Real so that the expected values are rounded like the result in the float build.
+    const Real invRoot14 = 1.0 / Real(sqrt(14.0));
 
     EXPECT_DOUBLE_EQ(unit.x, invRoot14 * a.x);
     EXPECT_DOUBLE_EQ(unit.y, invRoot14 * a.y);
@@ -92,6 +93,17 @@ TEST(Vector3, TestCross)
 }
 
 
+#ifndef VECTOR3_SIMD
+TEST(Vector3, TestConstexpr)
+{
+    constexpr Vector3 result = cross(vector3(1.0, 0.0, 0.0), vector3(0.0, 1.0, 0.0));
+
+    static_assert(result.z == 1.0, "cross() should be evaluated at compile time");
+    ExpectVectorEqual(result, vector3(0, 0, 1));
+}
+#endif
+
+
 TEST(Vector3, TestSubtractVectors)
 {
     Vector3 a = vector3(1.0, 2.0, 3.0);
@@ -0,0 +1,55 @@
+/**
+ * @file Render.cpp
+ * @author Edward Palmer
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "engine/CLIOptions.hpp"
+#include "engine/RenderCommand.hpp"
+#include "engine/RenderSettings.hpp"
+#include "engine/Scene.hpp"
+#include "engine/SceneLoader.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+
+/* Renders a scene file (see SceneLoader.hpp for the format). */
+int main(int argc, const char *argv[])
+{
+    RenderSettings::instance().setDefaultWidthHeight(800, 600);
+    parseCLIOptions(argc, argv);
+
+    const char *scenePath = RenderSettings::instance().scenePath;
+
+    if (!scenePath)
+    {
+        fprintf(stderr, "error: missing argument: --scene\n");
+        return EXIT_FAILURE;
+    }
+
+    Scene scene;
+    SceneLoader loader(scene);
+
+    try
+    {
+        const char *cachePath = RenderSettings::instance().cachePath;
+
+        if (cachePath)
+            (void)loader.loadFile(scenePath, cachePath);
+        else
+            loader.loadFile(scenePath);
+
+        Camera camera = loader.camera(RenderSettings::instance().aspectRatio());
+
+        return renderWithSettings(scene, camera);
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "error: %s: %s\n", scenePath, e.what());
+        return EXIT_FAILURE;
+    }
+}